@@ -181,7 +181,8 @@ bool GameManager::setup_instance(Bookmark const& bookmark) {
 	instance_manager.emplace(
 		game_rules_manager,
 		definition_manager,
-		gamestate_updated_callback
+		gamestate_updated_callback,
+		worker_count
 	);
 
 	SPDLOG_INFO("Setting up new game instance.");
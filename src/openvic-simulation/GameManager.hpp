@@ -30,6 +30,8 @@ namespace OpenVic {
 		InstanceManager::gamestate_updated_func_t gamestate_updated_callback;
 		bool PROPERTY_CUSTOM_PREFIX(definitions_loaded, are);
 		bool PROPERTY_CUSTOM_PREFIX(mod_descriptors_loaded, are);
+		//worker threads for the next game instance, 0 uses hardware concurrency
+		uint32_t PROPERTY_RW(worker_count, 0);
 
 	public:
 		GameManager(
@@ -11,8 +11,10 @@ using namespace OpenVic;
 InstanceManager::InstanceManager(
 	GameRulesManager const& new_game_rules_manager,
 	DefinitionManager const& new_definition_manager,
-	gamestate_updated_func_t gamestate_updated_callback
-) : thread_pool { today },
+	gamestate_updated_func_t gamestate_updated_callback,
+	const uint32_t worker_count
+) : executor { worker_count > 0 ? worker_count : ecs::EcsThreadPool::default_worker_count() },
+	thread_pool { executor, today },
 	definition_manager { new_definition_manager },
 	game_action_manager { *this },
 	game_rules_manager { new_game_rules_manager },
@@ -48,6 +50,9 @@ InstanceManager::InstanceManager(
 		new_definition_manager.get_define_manager().get_military_defines(),
 		new_definition_manager.get_modifier_manager().get_modifier_effect_cache(),
 		PopsAggregateDeps{
+			culture_index_t(
+				new_definition_manager.get_pop_manager().get_culture_manager().get_culture_count()
+			),
 			ideology_index_t(
 				new_definition_manager.get_politics_manager().get_ideology_manager().get_ideology_count()
 			),
@@ -60,6 +65,9 @@ InstanceManager::InstanceManager(
 			reform_index_t(
 				new_definition_manager.get_politics_manager().get_issue_manager().get_reform_count()
 			),
+			religion_index_t(
+				new_definition_manager.get_pop_manager().get_religion_manager().get_religion_count()
+			),
 			strata_index_t(
 				new_definition_manager.get_pop_manager().get_strata_count()
 			)
@@ -73,6 +81,9 @@ InstanceManager::InstanceManager(
 		new_definition_manager.get_military_manager().get_unit_type_manager()
 	},
 	pops_aggregate_deps {
+			culture_index_t(
+				new_definition_manager.get_pop_manager().get_culture_manager().get_culture_count()
+			),
 			ideology_index_t(
 				new_definition_manager.get_politics_manager().get_ideology_manager().get_ideology_count()
 			),
@@ -85,6 +96,9 @@ InstanceManager::InstanceManager(
 			reform_index_t(
 				new_definition_manager.get_politics_manager().get_issue_manager().get_reform_count()
 			),
+			religion_index_t(
+				new_definition_manager.get_pop_manager().get_religion_manager().get_religion_count()
+			),
 			strata_index_t(
 				new_definition_manager.get_pop_manager().get_strata_count()
 			)
@@ -114,6 +128,7 @@ InstanceManager::InstanceManager(
 		good_instance_manager,
 		new_definition_manager.get_define_manager().get_pops_defines(),
 		new_definition_manager.get_pop_manager().get_pop_types(),
+		new_definition_manager.get_economy_manager().get_production_type_manager().get_production_types(),
 		new_definition_manager.get_military_manager().get_unit_type_manager().get_regiment_types(),
 		thread_pool
 	},
@@ -131,6 +146,11 @@ InstanceManager::InstanceManager(
 		province_instance_deps,
 		thread_pool
 	},
+	pop_movement {
+		new_definition_manager.get_pop_manager().get_pop_types(),
+		new_definition_manager.get_define_manager().get_pops_defines(),
+		pop_deps
+	},
 	simulation_clock {
 		[this]() -> void {
 			queue_game_action<tick_argument_t>();
@@ -141,7 +161,9 @@ InstanceManager::InstanceManager(
 		}
 	},
 	console_instance { *this },
-	gamestate_updated { gamestate_updated_callback ? std::move(gamestate_updated_callback) : []() {} } {}
+	gamestate_updated { gamestate_updated_callback ? std::move(gamestate_updated_callback) : []() {} } {
+	build_tick_pipeline();
+}
 
 void InstanceManager::set_gamestate_needs_update() {
 	if (!currently_updating_gamestate) {
@@ -178,6 +200,124 @@ void InstanceManager::update_gamestate() {
 	currently_updating_gamestate = false;
 }
 
+void InstanceManager::run_country_tick_before_map() {
+	country_instance_manager.country_manager_tick_before_map();
+}
+void InstanceManager::run_map_tick() {
+	map_instance.map_tick();
+}
+void InstanceManager::run_execute_orders() {
+	market_instance.execute_orders();
+}
+void InstanceManager::run_pop_movement() {
+	pop_movement.pop_movement_tick(
+		map_instance.get_province_instances(), country_instance_manager.get_country_instances(), executor
+	);
+}
+void InstanceManager::run_country_tick_after_map() {
+	country_instance_manager.country_manager_tick_after_map();
+}
+void InstanceManager::run_unit_tick() {
+	unit_instance_manager.tick();
+}
+void InstanceManager::run_record_price_history() {
+	if (today.is_month_start()) {
+		market_instance.record_price_history();
+	}
+}
+void InstanceManager::run_record_economy_history() {
+	market_instance.record_market_history(today);
+	country_instance_manager.record_country_history(today);
+}
+void InstanceManager::run_rebalance_province_bundles() {
+	if (today.is_month_start()) {
+		thread_pool.rebalance_province_bundles();
+	}
+}
+
+std::span<const InstanceManager::tick_task_t> InstanceManager::get_tick_tasks() {
+	using enum tick_resource_t;
+
+	//Declaration order is the sequential tick order, serial mode runs exactly this.
+	//Anything dispatching onto thread_pool reads WORK_BUNDLES.
+	static constexpr tick_task_t tick_tasks[] {
+		{
+			"country_tick_before_map",
+			GOOD_PRICES | PROVINCES | WORK_BUNDLES,
+			COUNTRIES | MARKET_ORDERS,
+			&InstanceManager::run_country_tick_before_map
+		},
+		{
+			"map_tick",
+			GOOD_PRICES | WORK_BUNDLES,
+			PROVINCES | COUNTRIES | MARKET_ORDERS,
+			&InstanceManager::run_map_tick
+		},
+		//goods clear largest order book first, then countries, RGOs and pops settle their trade results
+		{
+			"execute_orders",
+			NONE,
+			MARKET_ORDERS | GOOD_PRICES | PROVINCES | COUNTRIES | WORK_BUNDLES,
+			&InstanceManager::run_execute_orders
+		},
+		//pops leave and arrive in whole provinces, after trades are settled so needs are final
+		{
+			"pop_movement",
+			COUNTRIES,
+			PROVINCES,
+			&InstanceManager::run_pop_movement
+		},
+		{
+			"country_tick_after_map",
+			GOOD_PRICES | PROVINCES | WORK_BUNDLES,
+			COUNTRIES,
+			&InstanceManager::run_country_tick_after_map
+		},
+		{
+			"unit_tick",
+			PROVINCES,
+			UNITS,
+			&InstanceManager::run_unit_tick
+		},
+		{
+			"record_price_history",
+			GOOD_PRICES,
+			PRICE_HISTORY,
+			&InstanceManager::run_record_price_history
+		},
+		{
+			"record_economy_history",
+			GOOD_PRICES | COUNTRIES,
+			ECONOMY_HISTORY,
+			&InstanceManager::run_record_economy_history
+		},
+		{
+			"rebalance_province_bundles",
+			PROVINCES,
+			WORK_BUNDLES,
+			&InstanceManager::run_rebalance_province_bundles
+		}
+	};
+	return tick_tasks;
+}
+
+void InstanceManager::build_tick_pipeline() {
+	for (tick_task_t const& tick_task : get_tick_tasks()) {
+		tick_pipeline.add_task(
+			tick_task.name,
+			tick_task.reads,
+			tick_task.writes,
+			[this, run = tick_task.run]() -> void {
+				(this->*run)();
+			}
+		);
+	}
+}
+
+void InstanceManager::set_tick_serial_mode(const bool enabled) {
+	tick_pipeline.set_serial_mode(enabled);
+}
+
 /* REQUIREMENTS:
  * SS-98, SS-101
  */
@@ -188,15 +328,7 @@ void InstanceManager::tick() {
 	SPDLOG_INFO("Tick: {}", today);
 
 	// Tick...
-	country_instance_manager.country_manager_tick_before_map();
-	map_instance.map_tick();
-	market_instance.execute_orders();
-	country_instance_manager.country_manager_tick_after_map();
-	unit_instance_manager.tick();
-
-	if (today.is_month_start()) {
-		market_instance.record_price_history();
-	}
+	tick_pipeline.run(executor);
 }
 
 void InstanceManager::execute_game_actions() {
@@ -305,9 +437,11 @@ bool InstanceManager::load_bookmark(Bookmark const& new_bookmark) {
 	OV_ERR_FAIL_COND_V_MSG(!all_has_state, false, "At least one land province has no state");
 
 	update_modifier_sums();
+	thread_pool.rebalance_province_bundles();
 	map_instance.initialise_for_new_game(*this);
 	country_instance_manager.update_gamestate(today, map_instance);
 	market_instance.execute_orders();
+	country_instance_manager.apply_economy_reports();
 
 	return ret;
 }
@@ -355,15 +489,25 @@ bool InstanceManager::set_today_and_update(Date new_today) {
 
 void InstanceManager::update_modifier_sums() {
 	// Calculate national country modifier sums first, then local province modifier sums, adding province contributions
-	// to controller countries' modifier sums if each province has a controller. This results in every country having a
-	// full copy of all the modifiers affecting them in their modifier sum, but provinces only having their directly/locally
-	// applied modifiers in their modifier sum, hence requiring owner country modifier effect values to be looked up when
-	// determining the value of a global effect on the province.
+	// to controller countries' modifier sums if each province has a controller. This results in every country's modifier sum
+	// including the values of all the modifiers affecting them (province entries are only referenced, not copied), but
+	// provinces only having their directly/locally applied modifiers in their modifier sum, hence requiring owner country
+	// modifier effect values to be looked up when determining the value of a global effect on the province.
+	//
+	// Only holders of event modifiers that expired since the last update are touched here.
+	event_modifier_expiry_queue.expire_event_modifiers(today);
+
+	// Sums are maintained incrementally, every month (every update in debug builds) they're checked against a full rebuild.
+#ifdef DEBUG_ENABLED
+	const bool verify_modifier_sums = true;
+#else
+	const bool verify_modifier_sums = today.is_month_start();
+#endif
 	country_instance_manager.update_modifier_sums(
-		today, definition_manager.get_modifier_manager().get_static_modifier_cache()
+		definition_manager.get_modifier_manager().get_static_modifier_cache(), verify_modifier_sums
 	);
 	map_instance.update_modifier_sums(
-		today, definition_manager.get_modifier_manager().get_static_modifier_cache()
+		definition_manager.get_modifier_manager().get_static_modifier_cache(), verify_modifier_sums
 	);
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+#include <string_view>
 #include <utility>
 
 #include <function2/function2.hpp>
@@ -9,6 +11,7 @@
 #include "openvic-simulation/country/CountryInstanceDeps.hpp"
 #include "openvic-simulation/country/CountryInstanceManager.hpp"
 #include "openvic-simulation/diplomacy/CountryRelation.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
 #include "openvic-simulation/economy/GoodInstance.hpp"
 #include "openvic-simulation/economy/production/ArtisanalProducerDeps.hpp"
 #include "openvic-simulation/economy/production/ResourceGatheringOperationDeps.hpp"
@@ -19,12 +22,15 @@
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
 #include "openvic-simulation/misc/GameAction.hpp"
 #include "openvic-simulation/misc/SimulationClock.hpp"
+#include "openvic-simulation/modifier/EventModifierExpiryQueue.hpp"
 #include "openvic-simulation/politics/PoliticsInstanceManager.hpp"
 #include "openvic-simulation/population/PopDeps.hpp"
+#include "openvic-simulation/population/PopMovement.hpp"
 #include "openvic-simulation/population/PopsAggregateDeps.hpp"
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/FlagStrings.hpp"
 #include "openvic-simulation/utility/ThreadPool.hpp"
+#include "openvic-simulation/utility/TickPipeline.hpp"
 
 namespace OpenVic {
 
@@ -37,6 +43,8 @@ namespace OpenVic {
 		using gamestate_updated_func_t = fu2::function_base<true, true, fu2::capacity_can_hold<void*>, false, false, void()>;
 
 	private:
+		//runs the legacy ThreadPool work and every other parallel pass of the tick, an ecs::World can share it via World::set_shared_thread_pool
+		ecs::EcsThreadPool PROPERTY_REF(executor);
 		ThreadPool thread_pool;
 
 		CountryRelationManager PROPERTY_REF(country_relation_manager);
@@ -48,7 +56,7 @@ namespace OpenVic {
 		ArtisanalProducerDeps artisanal_producer_deps;
 		CountryInstanceDeps country_instance_deps;
 		PopsAggregateDeps pops_aggregate_deps;
-		PopDeps pop_deps;
+		PopDeps PROPERTY(pop_deps);
 		ResourceGatheringOperationDeps rgo_deps;
 		ProvinceInstanceDeps province_instance_deps;
 
@@ -60,6 +68,9 @@ namespace OpenVic {
 		/* Near the end so it is freed after other managers that may depend on it,
 		 * e.g. if we want to remove military units from the province they're in when they're destructed. */
 		MapInstance PROPERTY_REF(map_instance);
+		//event modifiers must be added to countries and provinces through this so they expire
+		EventModifierExpiryQueue PROPERTY_REF(event_modifier_expiry_queue);
+		PopMovement pop_movement;
 		SimulationClock PROPERTY_REF(simulation_clock);
 		ConsoleInstance PROPERTY_REF(console_instance);
 
@@ -72,7 +83,18 @@ namespace OpenVic {
 		gamestate_updated_func_t gamestate_updated;
 		memory::vector<game_action_t> game_action_queue;
 		bool gamestate_needs_update = false, currently_updating_gamestate = false, currently_executing_game_actions = false;
-
+		TickPipeline tick_pipeline;
+
+		void run_country_tick_before_map();
+		void run_map_tick();
+		void run_execute_orders();
+		void run_pop_movement();
+		void run_country_tick_after_map();
+		void run_unit_tick();
+		void run_record_price_history();
+		void run_record_economy_history();
+		void run_rebalance_province_bundles();
+		void build_tick_pipeline();
 		void update_modifier_sums();
 		void set_gamestate_needs_update();
 		void update_gamestate();
@@ -81,12 +103,21 @@ namespace OpenVic {
 		void execute_game_actions();
 
 	public:
+		struct tick_task_t {
+			std::string_view name;
+			tick_resource_t reads;
+			tick_resource_t writes;
+			void (InstanceManager::*run)();
+		};
+
 		DefinitionManager const& definition_manager;
 
 		InstanceManager(
 			GameRulesManager const& new_game_rules_manager,
 			DefinitionManager const& new_definition_manager,
-			gamestate_updated_func_t gamestate_updated_callback
+			gamestate_updated_func_t gamestate_updated_callback,
+			//0 uses hardware concurrency
+			const uint32_t worker_count = 0
 		);
 
 		inline constexpr bool is_bookmark_loaded() const {
@@ -101,6 +132,11 @@ namespace OpenVic {
 
 		bool set_today_and_update(Date new_today);
 
+		//The tasks of a tick in sequential order with the gamestate they declare, the tick pipeline is built from exactly these.
+		static std::span<const tick_task_t> get_tick_tasks();
+		//Run tick tasks one after another in declaration order instead of overlapping independent ones.
+		void set_tick_serial_mode(const bool enabled);
+
 		template<typename T, typename... Args>
 		bool queue_game_action(Args&&... args) {
 			return queue_game_action(
@@ -156,7 +156,6 @@ namespace OpenVic {
 		// - insert
 		// - insert_range
 		// - emplace
-		// - erase
 		// - append_range (C++23)
 		// - pop_back
 		// - swap
@@ -177,6 +176,10 @@ namespace OpenVic {
 			return container.emplace_back(std::forward<Args>(args)...);
 		}
 
+		constexpr iterator erase(const const_iterator pos) {
+			return container.erase(pos);
+		}
+
 		template <typename OtherContainerT>
 		constexpr void append_range(OtherContainerT const& other) {
 			append_range(other.begin(), other.end());
@@ -0,0 +1,190 @@
+#include "CountryEconomyReports.hpp"
+
+#include <cassert>
+
+#include <type_safe/strong_typedef.hpp>
+
+#include "openvic-simulation/core/error/ErrorMacros.hpp"
+#include "openvic-simulation/economy/GoodDefinition.hpp"
+#include "openvic-simulation/economy/production/ProductionType.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+
+using namespace OpenVic;
+
+CountryEconomyReports::CountryEconomyReports(
+	ecs::EcsThreadPool const& new_executor,
+	const country_index_t new_country_count,
+	const pop_type_index_t new_pop_type_count,
+	const good_index_t new_good_count,
+	forwardable_span<const ProductionType> new_production_types
+) : executor { new_executor },
+	worker_count { executor.worker_count() },
+	country_count { type_safe::get(new_country_count) },
+	pop_type_count { type_safe::get(new_pop_type_count) },
+	good_count { type_safe::get(new_good_count) },
+	production_types { new_production_types },
+	input_offsets(production_types.size() + 1, 0),
+	input_slots(production_types.size() * good_count, INVALID_INDEX),
+	worker_reports(worker_count),
+	collected_slots(country_count) {
+	for (ProductionType const& production_type : production_types) {
+		const std::size_t production_type_index = type_safe::get(production_type.index);
+		input_offsets[production_type_index + 1] = production_type.input_goods.size();
+	}
+	for (std::size_t i = 1; i < input_offsets.size(); ++i) {
+		input_offsets[i] += input_offsets[i - 1];
+	}
+	for (ProductionType const& production_type : production_types) {
+		const std::size_t production_type_index = type_safe::get(production_type.index);
+		std::size_t slot = input_offsets[production_type_index];
+		for (auto const& [input_good, quantity] : production_type.input_goods) {
+			input_slots[production_type_index * good_count + type_safe::get(input_good->index)] = slot++;
+		}
+	}
+
+	pop_demand_offset = pop_type_count * good_count;
+	factory_demand_offset = pop_demand_offset + good_count;
+	input_consumption_offset = factory_demand_offset + good_count;
+	output_offset = input_consumption_offset + input_offsets.back();
+	taxable_income_offset = output_offset + production_types.size();
+	block_size = taxable_income_offset + pop_type_count;
+
+	for (worker_reports_t& reports : worker_reports) {
+		reports.block_indices.resize(country_count, INVALID_INDEX);
+	}
+	collected_values.resize(country_count * block_size);
+}
+
+void CountryEconomyReports::add(const country_index_t country_index, const std::size_t slot, const fixed_point_t quantity) {
+	if (quantity == 0) {
+		return;
+	}
+
+	OV_ERR_FAIL_COND_MSG(
+		!executor.is_calling_thread_worker(),
+		"Economy reported from a thread that is not one of the executor's workers, the report is dropped."
+	);
+	const std::size_t worker_id = ecs::EcsThreadPool::this_worker_id();
+	worker_reports_t& reports = worker_reports[worker_id];
+	std::size_t& block_index = reports.block_indices[type_safe::get(country_index)];
+	if (block_index == INVALID_INDEX) {
+		block_index = reports.touched_slots.size();
+		reports.touched_slots.emplace_back();
+		reports.values.resize(reports.values.size() + block_size);
+	}
+
+	fixed_point_t& value = reports.values[block_index * block_size + slot];
+	if (value == 0) {
+		reports.touched_slots[block_index].push_back(slot);
+	}
+	value += quantity;
+}
+
+std::span<const fixed_point_t> CountryEconomyReports::get_collected_block(const country_index_t country_index) const {
+	return { collected_values.data() + type_safe::get(country_index) * block_size, block_size };
+}
+
+std::size_t CountryEconomyReports::get_input_slot(ProductionType const& production_type, const good_index_t good_index) const {
+	const std::size_t slot = input_slots[type_safe::get(production_type.index) * good_count + type_safe::get(good_index)];
+	assert(slot != INVALID_INDEX);
+	return slot;
+}
+
+void CountryEconomyReports::add_taxable_income(
+	const country_index_t country_index, const pop_type_index_t pop_type_index, const fixed_point_t quantity
+) {
+	add(country_index, taxable_income_offset + type_safe::get(pop_type_index), quantity);
+}
+void CountryEconomyReports::add_need_consumption(
+	const country_index_t country_index,
+	const pop_type_index_t pop_type_index,
+	const good_index_t good_index,
+	const fixed_point_t quantity
+) {
+	add(country_index, type_safe::get(pop_type_index) * good_count + type_safe::get(good_index), quantity);
+}
+void CountryEconomyReports::add_pop_demand(
+	const country_index_t country_index, const good_index_t good_index, const fixed_point_t quantity
+) {
+	add(country_index, pop_demand_offset + type_safe::get(good_index), quantity);
+}
+void CountryEconomyReports::add_factory_demand(
+	const country_index_t country_index, const good_index_t good_index, const fixed_point_t quantity
+) {
+	add(country_index, factory_demand_offset + type_safe::get(good_index), quantity);
+}
+void CountryEconomyReports::add_input_consumption(
+	const country_index_t country_index,
+	ProductionType const& production_type,
+	const good_index_t good_index,
+	const fixed_point_t quantity
+) {
+	add(country_index, input_consumption_offset + get_input_slot(production_type, good_index), quantity);
+}
+void CountryEconomyReports::add_output(
+	const country_index_t country_index, const production_type_index_t production_type_index, const fixed_point_t quantity
+) {
+	add(country_index, output_offset + type_safe::get(production_type_index), quantity);
+}
+
+bool CountryEconomyReports::collect(const country_index_t country_index) {
+	fixed_point_t* const collected = collected_values.data() + type_safe::get(country_index) * block_size;
+	memory::vector<std::size_t>& country_collected_slots = collected_slots[type_safe::get(country_index)];
+	for (const std::size_t slot : country_collected_slots) {
+		collected[slot] = 0;
+	}
+	country_collected_slots.clear();
+
+	for (worker_reports_t& reports : worker_reports) {
+		const std::size_t block_index = reports.block_indices[type_safe::get(country_index)];
+		if (block_index == INVALID_INDEX) {
+			continue;
+		}
+
+		fixed_point_t* const block = reports.values.data() + block_index * block_size;
+		memory::vector<std::size_t>& touched_slots = reports.touched_slots[block_index];
+		for (const std::size_t slot : touched_slots) {
+			if (block[slot] == 0) {
+				continue;
+			}
+			if (collected[slot] == 0) {
+				country_collected_slots.push_back(slot);
+			}
+			collected[slot] += block[slot];
+			block[slot] = 0;
+		}
+		touched_slots.clear();
+	}
+	return !country_collected_slots.empty();
+}
+
+fixed_point_t CountryEconomyReports::get_taxable_income(
+	const country_index_t country_index, const pop_type_index_t pop_type_index
+) const {
+	return get_collected_block(country_index)[taxable_income_offset + type_safe::get(pop_type_index)];
+}
+fixed_point_t CountryEconomyReports::get_need_consumption(
+	const country_index_t country_index, const pop_type_index_t pop_type_index, const good_index_t good_index
+) const {
+	return get_collected_block(country_index)[type_safe::get(pop_type_index) * good_count + type_safe::get(good_index)];
+}
+fixed_point_t CountryEconomyReports::get_pop_demand(const country_index_t country_index, const good_index_t good_index) const {
+	return get_collected_block(country_index)[pop_demand_offset + type_safe::get(good_index)];
+}
+fixed_point_t CountryEconomyReports::get_factory_demand(const country_index_t country_index, const good_index_t good_index) const {
+	return get_collected_block(country_index)[factory_demand_offset + type_safe::get(good_index)];
+}
+std::span<const fixed_point_t> CountryEconomyReports::get_input_consumption(
+	const country_index_t country_index, ProductionType const& production_type
+) const {
+	const std::size_t production_type_index = type_safe::get(production_type.index);
+	return get_collected_block(country_index).subspan(
+		input_consumption_offset + input_offsets[production_type_index],
+		input_offsets[production_type_index + 1] - input_offsets[production_type_index]
+	);
+}
+fixed_point_t CountryEconomyReports::get_output(
+	const country_index_t country_index, const production_type_index_t production_type_index
+) const {
+	return get_collected_block(country_index)[output_offset + type_safe::get(production_type_index)];
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/portable/ForwardableSpan.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+namespace OpenVic::ecs {
+	class EcsThreadPool;
+}
+
+namespace OpenVic {
+	struct ProductionType;
+
+	/* Economy figures reported by the pops, artisans and RGOs of every country during the map tick and while trades settle.
+	 * Each worker adds into its own block per country, indexed by pop type, good and production type, so reporting
+	 * takes no lock and inserts into no map. A worker's block for a country is only allocated once it reports to it,
+	 * and it lists the slots it added to so collecting visits only those. A country collects its blocks in worker order
+	 * before reading the figures, the sums are exact so they don't depend on which worker reported what.
+	 * The blocks are sized for and indexed by the workers of the executor the reports are built with. */
+	struct CountryEconomyReports {
+	private:
+		ecs::EcsThreadPool const& executor;
+		const std::size_t worker_count;
+		const std::size_t country_count;
+		const std::size_t pop_type_count;
+		const std::size_t good_count;
+		const forwardable_span<const ProductionType> production_types;
+
+		static constexpr std::size_t INVALID_INDEX = static_cast<std::size_t>(-1);
+
+		// Production type i consumes its inputs into slots [input_offsets[i], input_offsets[i + 1]), in input_goods order.
+		memory::vector<std::size_t> input_offsets;
+		// By production type then good, the input slot the good is consumed into, or INVALID_INDEX if it isn't one of its inputs.
+		memory::vector<std::size_t> input_slots;
+
+		// A block holds need consumption by pop type then good, followed by the ranges below.
+		std::size_t pop_demand_offset;
+		std::size_t factory_demand_offset;
+		std::size_t input_consumption_offset;
+		std::size_t output_offset;
+		std::size_t taxable_income_offset;
+		std::size_t block_size;
+
+		struct worker_reports_t {
+			// By country, the index of the worker's block for it, or INVALID_INDEX until the worker first reports to it.
+			memory::vector<std::size_t> block_indices;
+			memory::vector<fixed_point_t> values;
+			// By block, the slots added to since the last collection. A slot is listed when it stops being 0,
+			// so it may be listed twice but collecting clears it the first time.
+			memory::vector<memory::vector<std::size_t>> touched_slots;
+		};
+		memory::vector<worker_reports_t> worker_reports;
+
+		// By country, the collected block and the slots collected into it, which are cleared by the next collection.
+		memory::vector<fixed_point_t> collected_values;
+		memory::vector<memory::vector<std::size_t>> collected_slots;
+
+		void add(const country_index_t country_index, const std::size_t slot, const fixed_point_t quantity);
+		std::span<const fixed_point_t> get_collected_block(const country_index_t country_index) const;
+		std::size_t get_input_slot(ProductionType const& production_type, const good_index_t good_index) const;
+
+	public:
+		CountryEconomyReports(
+			ecs::EcsThreadPool const& new_executor,
+			const country_index_t new_country_count,
+			const pop_type_index_t new_pop_type_count,
+			const good_index_t new_good_count,
+			forwardable_span<const ProductionType> new_production_types
+		);
+		CountryEconomyReports(CountryEconomyReports&&) = delete;
+		CountryEconomyReports(CountryEconomyReports const&) = delete;
+		CountryEconomyReports& operator=(CountryEconomyReports&&) = delete;
+		CountryEconomyReports& operator=(CountryEconomyReports const&) = delete;
+
+		/* Each worker may only report into its own blocks, the worker is the one running on the calling thread.
+		 * Reporting from a thread that isn't one of the executor's workers is an error and the report is dropped. */
+		void add_taxable_income(const country_index_t country_index, const pop_type_index_t pop_type_index, const fixed_point_t quantity);
+		void add_need_consumption(
+			const country_index_t country_index,
+			const pop_type_index_t pop_type_index,
+			const good_index_t good_index,
+			const fixed_point_t quantity
+		);
+		void add_pop_demand(const country_index_t country_index, const good_index_t good_index, const fixed_point_t quantity);
+		void add_factory_demand(const country_index_t country_index, const good_index_t good_index, const fixed_point_t quantity);
+		void add_input_consumption(
+			const country_index_t country_index,
+			ProductionType const& production_type,
+			const good_index_t good_index,
+			const fixed_point_t quantity
+		);
+		void add_output(const country_index_t country_index, const production_type_index_t production_type_index, const fixed_point_t quantity);
+
+		/* Sums the country's worker blocks in worker order into its collected block and clears them,
+		 * returns false if nothing but 0 was reported since the last collection. Must not run while the country is reported to,
+		 * other countries may collect at the same time.
+		 * The getters below read the collected block. */
+		bool collect(const country_index_t country_index);
+
+		constexpr forwardable_span<const ProductionType> get_production_types() const {
+			return production_types;
+		}
+		fixed_point_t get_taxable_income(const country_index_t country_index, const pop_type_index_t pop_type_index) const;
+		fixed_point_t get_need_consumption(
+			const country_index_t country_index, const pop_type_index_t pop_type_index, const good_index_t good_index
+		) const;
+		fixed_point_t get_pop_demand(const country_index_t country_index, const good_index_t good_index) const;
+		fixed_point_t get_factory_demand(const country_index_t country_index, const good_index_t good_index) const;
+		// Consumption of the production type's inputs, in input_goods order.
+		std::span<const fixed_point_t> get_input_consumption(
+			const country_index_t country_index, ProductionType const& production_type
+		) const;
+		fixed_point_t get_output(const country_index_t country_index, const production_type_index_t production_type_index) const;
+	};
+}
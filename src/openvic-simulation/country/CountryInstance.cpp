@@ -5,13 +5,14 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
-#include <mutex>
+#include <span>
 
 #include <type_safe/strong_typedef.hpp>
 
 #include "openvic-simulation/core/error/ErrorMacros.hpp"
 #include "openvic-simulation/core/Typedefs.hpp"
 #include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/country/CountryEconomyReports.hpp"
 #include "openvic-simulation/country/SharedCountryValues.hpp"
 #include "openvic-simulation/defines/CountryDefines.hpp"
 #include "openvic-simulation/defines/DiplomacyDefines.hpp"
@@ -67,6 +68,7 @@ static constexpr colour_t ERROR_COLOUR = colour_t::from_integer(0xFF0000);
 CountryInstance::CountryInstance(
 	CountryDefinition const& new_country_definition,
 	SharedCountryValues& new_shared_country_values,
+	CountryEconomyReports& new_economy_reports,
 	CountryInstanceDeps const& country_instance_deps
 ) : FlagStrings { "country" },
 	HasIndex { new_country_definition.index },
@@ -74,6 +76,7 @@ CountryInstance::CountryInstance(
 	/* Main attributes */
 	country_definition { new_country_definition },
 	shared_country_values { new_shared_country_values },
+	economy_reports { new_economy_reports },
 
 	country_relations_manager { country_instance_deps.country_relations_manager },
 	game_rules_manager { country_instance_deps.game_rules_manager },
@@ -244,6 +247,8 @@ CountryInstance::CountryInstance(
 	modifier_sum.set_this_source(this);
 	// Exclude PROVINCE (local) modifier effects from the country's modifier sum
 	modifier_sum.set_this_excluded_targets(ModifierEffect::target_t::PROVINCE);
+	source_modifier_sum.set_this_source(this);
+	source_modifier_sum.set_this_excluded_targets(ModifierEffect::target_t::PROVINCE);
 
 	// Some sliders need to have their max range limits temporarily set to 1 so they can start with a value of 0.5 or 1.0.
 	// The range limits will be corrected on the first gamestate update, and the values will go to the closest valid point.
@@ -607,6 +612,7 @@ bool CountryInstance::add_state(State& new_item) {
 		!states.emplace(&new_item).second, false,
 		memory::fmt::format("state \"{}\" already present in country {}", new_item, *this)
 	);
+	pops_aggregate_needs_rebuild = true;
 	return true;
 }
 
@@ -615,6 +621,7 @@ bool CountryInstance::remove_state(State const& item_to_remove) {
 		states.erase(&item_to_remove) == 0, false,
 		memory::fmt::format("state \"{}\" not present in country {}", item_to_remove, *this)
 	);
+	pops_aggregate_needs_rebuild = true;
 	return true;
 }
 
@@ -657,6 +664,7 @@ bool CountryInstance::add_reform(Reform const& new_reform) {
 		}
 
 		reform = &new_reform;
+		is_source_modifier_sum_dirty = true;
 
 		// TODO - if new_reform.get_reform_group().is_uncivilised() ?
 		// TODO - new_reform.get_on_execute_trigger() / new_reform.get_on_execute_effect() ?
@@ -1080,7 +1088,15 @@ bool CountryInstance::modify_technology_unlock(
 		return false;
 	}
 
+	const bool technology_was_unlocked = is_unlocked(unlock_level);
 	unlock_level += unlock_level_change;
+	if (technology_was_unlocked != is_unlocked(unlock_level)) {
+		if (technology_was_unlocked) {
+			_unregister_modifier_source(technology);
+		} else {
+			_register_modifier_source(technology);
+		}
+	}
 
 	bool ret = true;
 
@@ -1134,8 +1150,10 @@ bool CountryInstance::modify_invention_unlock(
 	if (invention_was_unlocked != is_unlocked(unlock_level)) {
 		if (invention_was_unlocked) {
 			inventions_count-=1;
+			_unregister_modifier_source(invention);
 		} else {
 			inventions_count+=1;
+			_register_modifier_source(invention);
 		}
 	}
 
@@ -1557,13 +1575,12 @@ void CountryInstance::_update_politics() {
 }
 
 void CountryInstance::_update_population() {
-	clear_pops_aggregate();
-
-	for (State* const state : states) {
-		add_pops_aggregate(*state);
-	}
-
-	normalise_pops_aggregate();
+	update_pops_aggregate_from_parts(
+		states,
+		[](State* const state) -> State& {
+			return *state;
+		}
+	);
 
 	daily_research_points.set(0);
 	monthly_leadership_points = 0;
@@ -1782,23 +1799,10 @@ static constexpr Modifier const& get_country_status_static_effect(
 	}
 }
 
-void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache) {
-	// Update sum of national modifiers
-	modifier_sum.clear();
-
-	// Add static modifiers
-	modifier_sum.add_modifier(static_modifier_cache.get_base_modifier());
-	modifier_sum.add_modifier(get_country_status_static_effect(country_status, static_modifier_cache));
-	if (is_disarmed()) {
-		modifier_sum.add_modifier(static_modifier_cache.get_disarming());
-	}
-	modifier_sum.add_modifier(static_modifier_cache.get_war_exhaustion(), war_exhaustion);
-	modifier_sum.add_modifier(static_modifier_cache.get_infamy(), infamy.get_untracked());
-	modifier_sum.add_modifier(static_modifier_cache.get_literacy(), get_average_literacy());
-	modifier_sum.add_modifier(static_modifier_cache.get_plurality(), plurality.get_untracked());
-	modifier_sum.add_modifier(is_at_war() ? static_modifier_cache.get_war() : static_modifier_cache.get_peace());
-	// TODO - difficulty modifiers, debt_default_to, bad_debtor, generalised_debt_default,
-	//        total_occupation, total_blockaded, in_bankruptcy
+void CountryInstance::_add_source_modifiers(
+	ModifierSum& target_sum, StaticModifierCache const& static_modifier_cache
+) const {
+	target_sum.add_modifier(static_modifier_cache.get_base_modifier());
 
 	// TODO - handle triggered modifiers
 
@@ -1808,7 +1812,7 @@ void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const&
 			// The ruling party's issues here could be null as they're stored in an FixedVector which has
 			// values for every PartyPolicyGroup regardless of whether or not they have a policy set.
 			if (party_policy != nullptr) {
-				modifier_sum.add_modifier(*party_policy);
+				target_sum.add_modifier(*party_policy);
 			}
 		}
 	}
@@ -1817,47 +1821,126 @@ void CountryInstance::update_modifier_sum(Date today, StaticModifierCache const&
 		// The country's reforms here could be null as they're stored in an FixedVector which has
 		// values for every ReformGroup regardless of whether or not they have a reform set.
 		if (reform != nullptr) {
-			modifier_sum.add_modifier(*reform);
+			target_sum.add_modifier(*reform);
 		}
 	}
 
 	TechnologySchool const* tech_school_copy = tech_school.get_untracked();
 	if (tech_school_copy != nullptr) {
-		modifier_sum.add_modifier(*tech_school_copy);
+		target_sum.add_modifier(*tech_school_copy);
 	}
 
 	for (Technology const& technology : technology_unlock_levels.get_keys()) {
 		if (is_technology_unlocked(technology)) {
-			modifier_sum.add_modifier(technology);
+			target_sum.add_modifier(technology);
 		}
 	}
 
 	for (Invention const& invention : invention_unlock_levels.get_keys()) {
 		if (is_invention_unlocked(invention)) {
-			modifier_sum.add_modifier(invention);
+			target_sum.add_modifier(invention);
 		}
 	}
 
-	// Erase expired event modifiers and add non-expired ones to the sum
-	std::erase_if(event_modifiers, [this, today](ModifierInstance const& modifier) -> bool {
-		if (today <= modifier.get_expiry_date()) {
-			modifier_sum.add_modifier(*modifier.get_modifier());
-			return false;
-		} else {
-			return true;
-		}
-	});
+	for (ModifierInstance const& modifier : event_modifiers) {
+		target_sum.add_modifier(*modifier.get_modifier());
+	}
 
 	NationalValue const* national_value_copy = national_value.get_untracked();
 	if (national_value_copy != nullptr) {
-		modifier_sum.add_modifier(*national_value_copy);
+		target_sum.add_modifier(*national_value_copy);
 	}
+}
 
-	// TODO - calculate stats for each unit type (locked and unlocked)
+void CountryInstance::_register_modifier_source(Modifier const& modifier) {
+	// A dirty sum is rebuilt from scratch anyway
+	if (!is_source_modifier_sum_dirty) {
+		source_modifier_sum.add_modifier(modifier);
+	}
+}
+
+void CountryInstance::_unregister_modifier_source(Modifier const& modifier) {
+	if (!is_source_modifier_sum_dirty && !source_modifier_sum.remove_modifier(modifier)) {
+		is_source_modifier_sum_dirty = true;
+	}
+}
+
+void CountryInstance::add_event_modifier(Modifier const& modifier, const Date expiry_date) {
+	event_modifiers.emplace_back(modifier, expiry_date);
+	_register_modifier_source(modifier);
+}
+
+bool CountryInstance::expire_event_modifier(Modifier const& modifier, const Date expiry_date) {
+	const auto it = std::find_if(
+		event_modifiers.begin(), event_modifiers.end(),
+		[&modifier, expiry_date](ModifierInstance const& instance) -> bool {
+			return instance.get_modifier() == &modifier && instance.get_expiry_date() == expiry_date;
+		}
+	);
+	if (it == event_modifiers.end()) {
+		return false;
+	}
+
+	event_modifiers.erase(it);
+	_unregister_modifier_source(modifier);
+	return true;
 }
 
-void CountryInstance::make_room_for_province_modifier_sum(ModifierSum const& province_modifier_sum) {
-	modifier_sum.make_room_for(province_modifier_sum);
+void CountryInstance::update_modifier_sum(
+	StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sum
+) {
+	// Expired event modifiers have already been removed by the EventModifierExpiryQueue
+	if (
+		ruling_party.get_untracked() != source_modifier_sum_ruling_party
+		|| tech_school.get_untracked() != source_modifier_sum_tech_school
+		|| national_value.get_untracked() != source_modifier_sum_national_value
+	) {
+		is_source_modifier_sum_dirty = true;
+	}
+
+	if (verify_modifier_sum && !is_source_modifier_sum_dirty) {
+		ModifierSum rebuilt_modifier_sum;
+		rebuilt_modifier_sum.set_this_source(this);
+		rebuilt_modifier_sum.set_this_excluded_targets(ModifierEffect::target_t::PROVINCE);
+		_add_source_modifiers(rebuilt_modifier_sum, static_modifier_cache);
+
+		if (
+			rebuilt_modifier_sum.size() != source_modifier_sum.size()
+			|| !(rebuilt_modifier_sum.get_value_sum() == source_modifier_sum.get_value_sum())
+		) {
+			spdlog::error_s("Incremental modifier sum of country {} does not match a full rebuild!", *this);
+			is_source_modifier_sum_dirty = true;
+		}
+	}
+
+	if (is_source_modifier_sum_dirty) {
+		source_modifier_sum.clear();
+		_add_source_modifiers(source_modifier_sum, static_modifier_cache);
+
+		source_modifier_sum_ruling_party = ruling_party.get_untracked();
+		source_modifier_sum_tech_school = tech_school.get_untracked();
+		source_modifier_sum_national_value = national_value.get_untracked();
+		is_source_modifier_sum_dirty = false;
+	}
+
+	// Update sum of national modifiers
+	modifier_sum.clear();
+	modifier_sum.add_modifier_sum(source_modifier_sum);
+
+	// Add static modifiers that depend on values changing from day to day
+	modifier_sum.add_modifier(get_country_status_static_effect(country_status, static_modifier_cache));
+	if (is_disarmed()) {
+		modifier_sum.add_modifier(static_modifier_cache.get_disarming());
+	}
+	modifier_sum.add_modifier(static_modifier_cache.get_war_exhaustion(), war_exhaustion);
+	modifier_sum.add_modifier(static_modifier_cache.get_infamy(), infamy.get_untracked());
+	modifier_sum.add_modifier(static_modifier_cache.get_literacy(), get_average_literacy());
+	modifier_sum.add_modifier(static_modifier_cache.get_plurality(), plurality.get_untracked());
+	modifier_sum.add_modifier(is_at_war() ? static_modifier_cache.get_war() : static_modifier_cache.get_peace());
+	// TODO - difficulty modifiers, debt_default_to, bad_debtor, generalised_debt_default,
+	//        total_occupation, total_blockaded, in_bankruptcy
+
+	// TODO - calculate stats for each unit type (locked and unlocked)
 }
 
 void CountryInstance::contribute_province_modifier_sum(ModifierSum const& province_modifier_sum) {
@@ -1991,36 +2074,53 @@ void CountryInstance::update_gamestate(const Date today, MapInstance& map_instan
 	}
 }
 
-void CountryInstance::after_buy(void* actor, BuyResult const& buy_result) {
+void CountryInstance::settle_trades() {
+	for (std::optional<BuyResult> const& pending_buy : pending_buys) {
+		if (OV_unlikely(!pending_buy.has_value())) {
+			spdlog::error_s("National stockpile buy order of {} was not executed.", *this);
+			continue;
+		}
+		settle_buy(*pending_buy);
+	}
+	for (std::optional<SellResult> const& pending_sell : pending_sells) {
+		if (OV_unlikely(!pending_sell.has_value())) {
+			spdlog::error_s("National stockpile sell order of {} was not executed.", *this);
+			continue;
+		}
+		settle_sell(*pending_sell);
+	}
+	pending_buys.clear();
+	pending_sells.clear();
+}
+
+void CountryInstance::settle_buy(BuyResult const& buy_result) {
 	const fixed_point_t quantity_bought = buy_result.quantity_bought;
 
 	if (quantity_bought <= 0) {
 		return;
 	}
 
-	CountryInstance& country = *static_cast<CountryInstance*>(actor);
-	good_data_t& good_data = country.goods_data.at_index(buy_result.good_index);
+	good_data_t& good_data = goods_data.at_index(buy_result.good_index);
 	const fixed_point_t money_spent = buy_result.money_spent_total;
-	country.cash_stockpile -= money_spent;
-	country.actual_national_stockpile_spending += money_spent;
+	cash_stockpile -= money_spent;
+	actual_national_stockpile_spending += money_spent;
 	good_data.stockpile_amount += quantity_bought;
 	good_data.stockpile_change_yesterday += quantity_bought;
 	good_data.quantity_traded_yesterday = quantity_bought;
 	good_data.money_traded_yesterday = -money_spent;
 }
 
-void CountryInstance::after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) {
+void CountryInstance::settle_sell(SellResult const& sell_result) {
 	const fixed_point_t quantity_sold = sell_result.quantity_sold;
 
 	if (quantity_sold <= 0) {
 		return;
 	}
 
-	CountryInstance& country = *static_cast<CountryInstance*>(actor);
-	good_data_t& good_data = country.goods_data.at_index(sell_result.good_index);
+	good_data_t& good_data = goods_data.at_index(sell_result.good_index);
 	const fixed_point_t money_gained = sell_result.money_gained;
-	country.cash_stockpile += money_gained;
-	country.actual_national_stockpile_income += money_gained;
+	cash_stockpile += money_gained;
+	actual_national_stockpile_income += money_gained;
 	good_data.stockpile_amount -= quantity_sold;
 	good_data.stockpile_change_yesterday -= quantity_sold;
 	good_data.quantity_traded_yesterday = -quantity_sold;
@@ -2028,6 +2128,7 @@ void CountryInstance::after_sell(void* actor, SellResult const& sell_result, mem
 }
 
 void CountryInstance::country_tick_before_map(
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -2118,6 +2219,7 @@ void CountryInstance::country_tick_before_map(
 	calculate_government_good_needs();
 
 	manage_national_stockpile(
+		order_buffer_index,
 		reusable_goods_mask,
 		reusable_vectors,
 		reusable_good_index_vector,
@@ -2152,6 +2254,7 @@ void CountryInstance::calculate_government_good_needs() {
 }
 
 void CountryInstance::manage_national_stockpile(
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -2175,6 +2278,12 @@ void CountryInstance::manage_national_stockpile(
 	memory::vector<good_index_t>& good_indices_to_buy = reusable_good_index_vector;
 	fixed_point_t weights_sum = 0;
 
+	//orders point into the pending slots, so they must not reallocate while orders are placed
+	pending_buys.clear();
+	pending_buys.reserve(mask_size);
+	pending_sells.clear();
+	pending_sells.reserve(mask_size);
+
 	for (auto [good_instance, good_data] : goods_data) {
 		const good_index_t good_index = good_instance.index;
 		if (good_data.is_automated || !good_data.is_selling) {
@@ -2203,16 +2312,12 @@ void CountryInstance::manage_national_stockpile(
 			if (quantity_to_sell <= 0) {
 				continue;
 			}
-			market_instance.place_market_sell_order(
-				{
-					good_index,
-					index,
-					quantity_to_sell,
-					this,
-					after_sell,
-				},
-				reusable_vectors[3] //temporarily used here and later used as money_to_spend_per_good
-			);
+			market_instance.place_market_sell_order(order_buffer_index, {
+				good_index,
+				index,
+				quantity_to_sell,
+				&pending_sells.emplace_back()
+			});
 		}
 	}
 
@@ -2265,16 +2370,13 @@ void CountryInstance::manage_national_stockpile(
 			}
 
 			available_funds -= money_to_spend;
-			market_instance.place_buy_up_to_order(
-				{
-					good_index,
-					index,
-					max_quantity_to_buy,
-					money_to_spend,
-					this,
-					after_buy
-				}
-			);
+			market_instance.place_buy_up_to_order(order_buffer_index, {
+				good_index,
+				index,
+				max_quantity_to_buy,
+				money_to_spend,
+				&pending_buys.emplace_back()
+			});
 		}
 	}
 
@@ -2286,6 +2388,8 @@ void CountryInstance::manage_national_stockpile(
 }
 
 void CountryInstance::country_tick_after_map(const Date today) {
+	apply_economy_reports();
+
 	// Gain daily research points
 	research_point_stockpile += daily_research_points.get_untracked();
 
@@ -2411,12 +2515,7 @@ void CountryInstance::country_tick_after_map(const Date today) {
 	balance_history.push_back(yesterdays_balance);
 }
 
-CountryInstance::good_data_t::good_data_t()
-	: mutex { memory::make_unique<spin_mutex>() }
-	{ }
-
 void CountryInstance::good_data_t::clear_daily_recorded_data() {
-	const std::lock_guard<spin_mutex> lock_guard { *mutex };
 	stockpile_change_yesterday
 		= quantity_traded_yesterday
 		= money_traded_yesterday
@@ -2435,49 +2534,74 @@ void CountryInstance::good_data_t::clear_daily_recorded_data() {
 	production_per_production_type.clear();
 }
 
+void CountryInstance::apply_economy_reports() {
+	if (!economy_reports.collect(index)) {
+		return;
+	}
+
+	for (auto [pop_type, taxable_income] : taxable_income_by_pop_type) {
+		taxable_income += economy_reports.get_taxable_income(index, pop_type.index);
+	}
+
+	for (auto [good_instance, good_data] : goods_data) {
+		good_data.pop_demand += economy_reports.get_pop_demand(index, good_instance.index);
+		good_data.factory_demand += economy_reports.get_factory_demand(index, good_instance.index);
+
+		for (PopType const& pop_type : taxable_income_by_pop_type.get_keys()) {
+			const fixed_point_t consumed_quantity = economy_reports.get_need_consumption(index, pop_type.index, good_instance.index);
+			if (consumed_quantity != 0) {
+				good_data.need_consumption_per_pop_type[&pop_type] += consumed_quantity;
+			}
+		}
+	}
+
+	for (ProductionType const& production_type : economy_reports.get_production_types()) {
+		const fixed_point_t produced_quantity = economy_reports.get_output(index, production_type.index);
+		if (produced_quantity != 0) {
+			get_good_data(production_type.output_good).production_per_production_type[&production_type] += produced_quantity;
+		}
+
+		std::span<const fixed_point_t> consumed_quantities = economy_reports.get_input_consumption(index, production_type);
+		fixed_point_map_t<GoodDefinition const*> const& input_goods = production_type.input_goods;
+		for (auto it = input_goods.begin(); it < input_goods.end(); it++) {
+			const fixed_point_t consumed_quantity = consumed_quantities[it - input_goods.begin()];
+			if (consumed_quantity != 0) {
+				get_good_data(*it.key()).input_consumption_per_production_type[&production_type] += consumed_quantity;
+			}
+		}
+	}
+}
+
 void CountryInstance::report_pop_income_tax(PopType const& pop_type, const fixed_point_t gross_income, const fixed_point_t paid_as_tax) {
-	const std::lock_guard<spin_mutex> lock_guard { taxable_income_mutex };
-	taxable_income_by_pop_type.at(pop_type) += gross_income;
+	economy_reports.add_taxable_income(index, pop_type.index, gross_income);
 	cash_stockpile += paid_as_tax;
 }
 
 void CountryInstance::report_pop_need_consumption(PopType const& pop_type, const good_index_t good_index, const fixed_point_t quantity) {
-	good_data_t& good_data = goods_data.at_index(good_index);
-	const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-	good_data.need_consumption_per_pop_type[&pop_type] += quantity;
+	economy_reports.add_need_consumption(index, pop_type.index, good_index, quantity);
 }
 void CountryInstance::report_pop_need_demand(PopType const& pop_type, const good_index_t good_index, const fixed_point_t quantity) {
-	good_data_t& good_data = goods_data.at_index(good_index);
-	const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-	good_data.pop_demand += quantity;
+	economy_reports.add_pop_demand(index, good_index, quantity);
 }
 void CountryInstance::report_input_consumption(ProductionType const& production_type, const good_index_t good_index, const fixed_point_t quantity) {
-	good_data_t& good_data = goods_data.at_index(good_index);
-	const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-	good_data.input_consumption_per_production_type[&production_type] += quantity;
+	economy_reports.add_input_consumption(index, production_type, good_index, quantity);
 }
 void CountryInstance::report_input_demand(ProductionType const& production_type, const good_index_t good_index, const fixed_point_t quantity) {
-	good_data_t& good_data = goods_data.at_index(good_index);
-
 	if (production_type.template_type == ProductionType::template_type_t::ARTISAN) {
 		switch (game_rules_manager.get_artisanal_input_demand_category()) {
 			case demand_category::FactoryNeeds: break;
 			case demand_category::PopNeeds: {
-				const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-				good_data.pop_demand += quantity;
+				economy_reports.add_pop_demand(index, good_index, quantity);
 				return;
 			}
 			default: return; //demand_category::None
 		}
 	}
 
-	const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-	good_data.factory_demand += quantity;
+	economy_reports.add_factory_demand(index, good_index, quantity);
 }
 void CountryInstance::report_output(ProductionType const& production_type, const fixed_point_t quantity) {
-	good_data_t& good_data = get_good_data(production_type.output_good);
-	const std::lock_guard<spin_mutex> lock_guard { *good_data.mutex };
-	good_data.production_per_production_type[&production_type] += quantity;
+	economy_reports.add_output(index, production_type.index, quantity);
 }
 
 void CountryInstance::request_salaries_and_welfare_and_import_subsidies(Pop& pop) {
@@ -2546,7 +2670,7 @@ void CountryInstance::request_salaries_and_welfare_and_import_subsidies(Pop& pop
 	if (actual_import_subsidies_budget > 0) {
 		const fixed_point_t import_subsidies = fp::mul_div(
 			effective_tariff_rate.get_untracked() // < 0
-				* pop.get_yesterdays_import_value().get_copy_of_value(),
+				* pop.get_yesterdays_import_value(),
 			actual_import_subsidies_budget, // < 0
 			projected_import_subsidies.get_untracked() // > 0
 		); //effective_tariff_rate * actual_net_tariffs cancel out the negative
@@ -1,17 +1,19 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <optional>
 #include <utility>
 
 #include <fmt/base.h>
 
-#include "openvic-simulation/core/memory/SmartPtr.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
-#include "openvic-simulation/core/thread/SpinMutex.hpp"
 #include "openvic-simulation/diplomacy/CountryRelation.hpp"
 #include "openvic-simulation/economy/BuildingLevel.hpp"
 #include "openvic-simulation/economy/BuildingRestrictionCategory.hpp"
+#include "openvic-simulation/economy/trading/BuyResult.hpp"
+#include "openvic-simulation/economy/trading/SellResult.hpp"
 #include "openvic-simulation/military/CombatWidth.hpp"
 #include "openvic-simulation/military/UnitBranchedGetterMacro.hpp"
 #include "openvic-simulation/modifier/ModifierSum.hpp"
@@ -35,9 +37,11 @@
 
 namespace OpenVic {
 	struct BaseIssue;
+	template<typename... Holders>
+	struct BasicEventModifierExpiryQueue;
 	struct BuildingType;
-	struct BuyResult;
 	struct CountryDefinition;
+	struct CountryEconomyReports;
 	struct CountryDefines;
 	struct CountryHistoryEntry;
 	struct CountryInstanceManager;
@@ -70,7 +74,6 @@ namespace OpenVic {
 	struct Reform;
 	struct ReformGroup;
 	struct Religion;
-	struct SellResult;
 	struct SharedCountryValues;
 	struct SharedPopTypeValues;
 	struct State;
@@ -87,6 +90,8 @@ namespace OpenVic {
 	 * but can be swapped with other CountryInstance's CountryDefinition when switching tags. */
 	struct CountryInstance : FlagStrings, HasIndex<CountryInstance, country_index_t>, PopsAggregate {
 		friend struct CountryInstanceManager;
+		template<typename... Holders>
+		friend struct BasicEventModifierExpiryQueue;
 
 		/*
 			Westernisation Progress vs Status for Uncivilised Countries:
@@ -111,6 +116,7 @@ namespace OpenVic {
 
 	private:
 		SharedCountryValues& shared_country_values;
+		CountryEconomyReports& economy_reports;
 
 		const Date fallback_date_for_never_completing_research;
 		CountryDefines const& country_defines;
@@ -153,6 +159,14 @@ namespace OpenVic {
 		// The total/resultant modifier affecting this country, including owned province contributions.
 		ModifierSum PROPERTY(modifier_sum);
 		memory::vector<ModifierInstance> SPAN_PROPERTY(event_modifiers);
+		// The country's own modifier sources that rarely change (technologies, inventions, reforms, policies, event
+		// modifiers...), kept between updates. Technologies, inventions and event modifiers are added and removed as
+		// they change, anything else marks it dirty for a rebuild. modifier_sum starts from it every update.
+		ModifierSum source_modifier_sum;
+		bool is_source_modifier_sum_dirty = true;
+		CountryParty const* source_modifier_sum_ruling_party = nullptr;
+		TechnologySchool const* source_modifier_sum_tech_school = nullptr;
+		NationalValue const* source_modifier_sum_national_value = nullptr;
 
 		/* Production */
 		OV_STATE_PROPERTY(fixed_point_t, industrial_power);
@@ -168,7 +182,6 @@ namespace OpenVic {
 		ValueHistory<fixed_point_t> PROPERTY(balance_history);
 		OV_STATE_PROPERTY(fixed_point_t, gold_income);
 		atomic_fixed_point_t PROPERTY(cash_stockpile);
-		spin_mutex taxable_income_mutex;
 		OV_IFLATMAP_PROPERTY(PopType, fixed_point_t, taxable_income_by_pop_type);
 		OV_STATE_PROPERTY(fixed_point_t, tax_efficiency);
 		IndexedFlatMap<Strata, DerivedState<fixed_point_t>> PROPERTY(effective_tax_rate_by_strata);
@@ -304,7 +317,6 @@ namespace OpenVic {
 
 		/* Trade */
 		struct good_data_t {
-			memory::unique_ptr<spin_mutex> mutex;
 			fixed_point_t stockpile_amount;
 			fixed_point_t stockpile_change_yesterday; // positive if we gained, negative if we lost
 			fixed_point_t quantity_traded_yesterday; // positive if we bought, negative if we sold
@@ -329,16 +341,14 @@ namespace OpenVic {
 			ordered_map<ProductionType const*, fixed_point_t> input_consumption_per_production_type;
 			ordered_map<ProductionType const*, fixed_point_t> production_per_production_type;
 
-			good_data_t();
-			good_data_t(good_data_t&&) = default;
-			good_data_t& operator=(good_data_t&&) = default;
-
-			//thread safe
 			void clear_daily_recorded_data();
 		};
 
 	private:
 		OV_IFLATMAP_PROPERTY(GoodInstance, good_data_t, goods_data);
+		//national stockpile trade results, written by the market and applied by settle_trades in the order placed
+		memory::vector<std::optional<BuyResult>> pending_buys;
+		memory::vector<std::optional<SellResult>> pending_sells;
 
 		/* Diplomacy */
 		OV_STATE_PROPERTY(fixed_point_t, prestige);
@@ -402,6 +412,7 @@ namespace OpenVic {
 		CountryInstance(
 			CountryDefinition const& new_country_definition,
 			SharedCountryValues& new_shared_country_values,
+			CountryEconomyReports& new_economy_reports,
 			CountryInstanceDeps const& country_instance_deps
 		);
 		CountryInstance(CountryInstance const&) = delete;
@@ -651,13 +662,13 @@ namespace OpenVic {
 			return true;
 		}
 
-		static void after_buy(void* actor, BuyResult const& buy_result);
-		//matching GoodMarketSellOrder::callback_t
-		static void after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector);
+		void settle_buy(BuyResult const& buy_result);
+		void settle_sell(SellResult const& sell_result);
 
 		void calculate_government_good_needs();
 
 		void manage_national_stockpile(
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
@@ -684,9 +695,19 @@ namespace OpenVic {
 
 		bool update_rule_set();
 
+		void _add_source_modifiers(ModifierSum& target_sum, StaticModifierCache const& static_modifier_cache) const;
+		void _register_modifier_source(Modifier const& modifier);
+		void _unregister_modifier_source(Modifier const& modifier);
+
+		// Only called by EventModifierExpiryQueue, which tracks when each event modifier expires
+		void add_event_modifier(Modifier const& modifier, const Date expiry_date);
+		bool expire_event_modifier(Modifier const& modifier, const Date expiry_date);
+
 	public:
-		void update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache);
-		void make_room_for_province_modifier_sum(ModifierSum const& province_modifier_sum);
+		// verify_modifier_sum compares the incrementally maintained source sum with a full rebuild
+		void update_modifier_sum(
+			StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sum = false
+		);
 		void contribute_province_modifier_sum(ModifierSum const& province_modifier_sum);
 		fixed_point_t get_modifier_effect_value(ModifierEffect const& effect) const;
 		constexpr void for_each_contributing_modifier(
@@ -697,6 +718,7 @@ namespace OpenVic {
 
 		void update_gamestate(const Date today, MapInstance& map_instance);
 		void country_tick_before_map(
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
@@ -704,14 +726,18 @@ namespace OpenVic {
 			> reusable_vectors,
 			memory::vector<good_index_t>& reusable_good_index_vector
 		);
+		//Applies the national stockpile's trade results, once the market has executed the orders.
+		void settle_trades();
 		void country_tick_after_map(const Date today);
+		//Adds what the country's pops, artisans and RGOs reported since the last call into the taxable income and good data.
+		void apply_economy_reports();
 
 		good_data_t& get_good_data(GoodInstance const& good_instance);
 		good_data_t const& get_good_data(GoodInstance const& good_instance) const;
 		good_data_t& get_good_data(GoodDefinition const& good_definition);
 		good_data_t const& get_good_data(GoodDefinition const& good_definition) const;
 
-		//thread safe
+		//safe to call from any worker, each worker reports into its own economy_reports blocks
 		void report_pop_income_tax(PopType const& pop_type, const fixed_point_t gross_income, const fixed_point_t paid_as_tax);
 		void report_pop_need_consumption(PopType const& pop_type, const good_index_t good_index, const fixed_point_t quantity);
 		void report_pop_need_demand(PopType const& pop_type, const good_index_t good_index, const fixed_point_t quantity);
@@ -6,6 +6,7 @@
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/defines/CountryDefines.hpp"
 #include "openvic-simulation/DefinitionManager.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
 #include "openvic-simulation/InstanceManager.hpp"
 #include "openvic-simulation/history/CountryHistory.hpp"
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
@@ -14,6 +15,8 @@
 
 using namespace OpenVic;
 
+static constexpr size_t DAYS_OF_COUNTRY_HISTORY = 3 * 365;
+
 CountryInstanceManager::CountryInstanceManager(
 	CountryDefines const& new_country_defines,
 	CountryDefinitionManager const& new_country_definition_manager,
@@ -21,6 +24,7 @@ CountryInstanceManager::CountryInstanceManager(
 	GoodInstanceManager const& new_good_instance_manager,
 	PopsDefines const& new_pop_defines,
 	forwardable_span<const PopType> pop_type_keys,
+	forwardable_span<const ProductionType> production_types,
 	memory::vector<RegimentType> const& regiment_types,
 	ThreadPool& new_thread_pool
 ) : thread_pool { new_thread_pool },
@@ -32,6 +36,13 @@ CountryInstanceManager::CountryInstanceManager(
 		pop_type_keys,
 		regiment_types
 	},
+	economy_reports {
+		new_thread_pool.get_executor(),
+		country_index_t(new_country_definition_manager.get_country_definition_count()),
+		index_from_count<pop_type_index_t>(pop_type_keys.size()),
+		index_from_count<good_index_t>(new_good_instance_manager.get_good_instances().size()),
+		production_types
+	},
 	country_instances {
 		country_index_t(new_country_definition_manager.get_country_definition_count()),
 		[
@@ -42,10 +53,16 @@ CountryInstanceManager::CountryInstanceManager(
 			return std::make_tuple(
 				std::ref(*new_country_definition_manager.get_country_definition_by_index(country_index)),
 				std::ref(shared_country_values),
+				std::ref(economy_reports),
 				std::ref(country_instance_deps)
 			);
 		}
-	}
+	},
+	country_history {
+		new_country_definition_manager.get_country_definition_count() * COUNTRY_SERIES_PER_COUNTRY,
+		DAYS_OF_COUNTRY_HISTORY
+	},
+	country_history_sample(country_history.get_series_count())
 {
 	assert(new_country_definition_manager.country_definitions_are_locked());
 	great_powers.reserve(new_country_defines.get_great_power_rank());
@@ -292,16 +309,29 @@ bool CountryInstanceManager::apply_history_to_countries(InstanceManager& instanc
 	return ret;
 }
 
-void CountryInstanceManager::update_modifier_sums(const Date today, StaticModifierCache const& static_modifier_cache) {
-	for (CountryInstance& country : country_instances) {
-		country.update_modifier_sum(today, static_modifier_cache);
-	}
+void CountryInstanceManager::update_modifier_sums(
+	StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sums
+) {
+	thread_pool.get_executor().parallel_for(
+		country_instances.size(),
+		[this, &static_modifier_cache, verify_modifier_sums](
+			const std::size_t country_index, const uint32_t /*worker_id*/
+		) -> void {
+			country_instances[country_index_t(country_index)].update_modifier_sum(
+				static_modifier_cache, verify_modifier_sums
+			);
+		}
+	);
 }
 
 void CountryInstanceManager::update_gamestate(const Date today, MapInstance& map_instance) {
-	for (CountryInstance& country : country_instances) {
-		country.update_gamestate(today, map_instance);
-	}
+	//countries only write to themselves and their owned provinces
+	thread_pool.get_executor().parallel_for(
+		country_instances.size(),
+		[this, today, &map_instance](const std::size_t country_index, const uint32_t /*worker_id*/) -> void {
+			country_instances[country_index_t(country_index)].update_gamestate(today, map_instance);
+		}
+	);
 
 	// TODO - work out how to have ranking effects applied (e.g. static modifiers) applied at game start
 	// we can't just move update_rankings to the top of this function as it will choose initial GPs based on
@@ -310,6 +340,15 @@ void CountryInstanceManager::update_gamestate(const Date today, MapInstance& map
 	update_rankings(today);
 }
 
+void CountryInstanceManager::apply_economy_reports() {
+	thread_pool.get_executor().parallel_for(
+		country_instances.size(),
+		[this](const std::size_t country_index, const uint32_t /*worker_id*/) -> void {
+			country_instances[country_index_t(country_index)].apply_economy_reports();
+		}
+	);
+}
+
 void CountryInstanceManager::country_manager_tick_before_map() {
 	thread_pool.process_country_ticks_before_map();
 }
@@ -318,3 +357,19 @@ void CountryInstanceManager::country_manager_tick_after_map() {
 	thread_pool.process_country_ticks_after_map();
 	shared_country_values.update_costs();
 }
+
+void CountryInstanceManager::record_country_history(const Date today) {
+	using enum country_series_t;
+
+	for (CountryInstance const& country : country_instances) {
+		const country_index_t country_index = country.index;
+		ValueHistory<fixed_point_t> const& balance_history = country.get_balance_history();
+		country_history_sample[get_country_series_index(country_index, CASH_STOCKPILE)] = country.get_cash_stockpile().load();
+		country_history_sample[get_country_series_index(country_index, BALANCE)] = balance_history.empty()
+			? fixed_point_t::_0
+			: balance_history.back();
+		country_history_sample[get_country_series_index(country_index, GOLD_INCOME)] = country.get_gold_income_untracked();
+		country_history_sample[get_country_series_index(country_index, INDUSTRIAL_POWER)] = country.get_industrial_power_untracked();
+	}
+	country_history.push_sample(today, country_history_sample);
+}
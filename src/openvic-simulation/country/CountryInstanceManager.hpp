@@ -1,13 +1,19 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <string_view>
 
+#include <type_safe/strong_typedef.hpp>
+
 #include "openvic-simulation/core/memory/FixedVector.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/country/CountryEconomyReports.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/country/SharedCountryValues.hpp"
 #include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/TimeSeriesStore.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
@@ -21,14 +27,22 @@ namespace OpenVic {
 	struct MapInstance;
 	struct PopsDefines;
 	struct PopType;
+	struct ProductionType;
 	struct StaticModifierCache;
 	struct ThreadPool;
 
 	struct CountryInstanceManager {
+		//Series recorded daily for every country in country_history.
+		enum struct country_series_t : uint8_t {
+			CASH_STOCKPILE, BALANCE, GOLD_INCOME, INDUSTRIAL_POWER
+		};
+		static constexpr std::size_t COUNTRY_SERIES_PER_COUNTRY = 4;
+
 	private:
 		CountryDefinitionManager const& country_definition_manager;
 		CountryDefines const& country_defines;
 		SharedCountryValues shared_country_values;
+		CountryEconomyReports economy_reports;
 		ThreadPool& thread_pool;
 
 		memory::FixedVector<CountryInstance, country_index_t> SPAN_PROPERTY(country_instances);
@@ -41,6 +55,10 @@ namespace OpenVic {
 		memory::vector<std::reference_wrapper<CountryInstance>> SPAN_PROPERTY(industrial_power_ranking);
 		memory::vector<std::reference_wrapper<CountryInstance>> SPAN_PROPERTY(military_power_ranking);
 
+		TimeSeriesStore PROPERTY(country_history);
+		//Reused by record_country_history
+		memory::vector<fixed_point_t> country_history_sample;
+
 		void update_rankings(const Date today);
 
 	public:
@@ -51,10 +69,15 @@ namespace OpenVic {
 			GoodInstanceManager const& new_good_instance_manager,
 			PopsDefines const& new_pop_defines,
 			forwardable_span<const PopType> pop_type_keys,
+			forwardable_span<const ProductionType> production_types,
 			memory::vector<RegimentType> const& regiment_types,
 			ThreadPool& new_thread_pool
 		);
 
+		static constexpr std::size_t get_country_series_index(const country_index_t country_index, const country_series_t series) {
+			return type_safe::get(country_index) * COUNTRY_SERIES_PER_COUNTRY + static_cast<std::size_t>(series);
+		}
+
 		constexpr std::span<CountryInstance> get_country_instances() {
 			return country_instances;
 		}
@@ -71,9 +94,13 @@ namespace OpenVic {
 
 		bool apply_history_to_countries(InstanceManager& instance_manager);
 
-		void update_modifier_sums(const Date today, StaticModifierCache const& static_modifier_cache);
+		void update_modifier_sums(
+			StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sums
+		);
 		void update_gamestate(const Date today, MapInstance& map_instance);
+		void apply_economy_reports();
 		void country_manager_tick_before_map();
 		void country_manager_tick_after_map();
+		void record_country_history(const Date today);
 	};
 }
@@ -1030,7 +1030,8 @@ bool Dataloader::load_defines(
 	}
 	if (!definition_manager.get_mapmode_manager().setup_mapmodes(
 		definition_manager.get_map_definition(),
-		definition_manager.get_economy_manager().get_building_type_manager()
+		definition_manager.get_economy_manager().get_building_type_manager(),
+		definition_manager.get_pop_manager()
 	)) {
 		spdlog::critical_s("Failed to set up mapmodes!");
 		ret = false;
@@ -184,7 +184,7 @@ void ArtisanalProducer::artisan_tick_handler::allocate_money_for_inputs(
 	PopValuesFromProvince const& values_from_province
 ) {
 	//executed once per pop while nothing else uses it.
-	const fixed_point_t total_cash_to_spend = pop.get_cash().get_copy_of_value() / values_from_province.get_max_cost_multiplier();
+	const fixed_point_t total_cash_to_spend = pop.get_cash() / values_from_province.get_max_cost_multiplier();
 
 	if (total_cash_to_spend <= 0 || distinct_goods_to_buy <= 0) {
 		return;
@@ -15,6 +15,7 @@ using namespace OpenVic;
 using namespace OpenVic::NodeTools;
 
 ProductionType::ProductionType(
+	index_t new_index,
 	GameRulesManager const& new_game_rules_manager,
 	const std::string_view new_identifier,
 	std::optional<Job>&& new_owner,
@@ -30,6 +31,7 @@ ProductionType::ProductionType(
 	const bool new_is_farm,
 	const bool new_is_mine
 ) : HasIdentifier { new_identifier },
+	HasIndex { new_index },
 	game_rules_manager { new_game_rules_manager },
 	owner { std::move(new_owner) },
 	jobs { std::move(new_jobs) },
@@ -212,6 +214,7 @@ bool ProductionTypeManager::add_production_type(
 
 	const bool ret = production_types.emplace_item(
 		identifier,
+		index_from_count<ProductionType::index_t>(production_types.size()),
 		game_rules_manager, identifier, std::move(owner_before_move), std::move(jobs), template_type, base_workforce_size, std::move(input_goods), *output_good,
 		base_output_quantity, std::move(bonuses), std::move(maintenance_requirements), is_coastal, is_farm, is_mine
 	);
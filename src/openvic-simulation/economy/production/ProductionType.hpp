@@ -6,6 +6,7 @@
 #include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
 #include "openvic-simulation/population/PopSize.hpp"
 #include "openvic-simulation/scripts/ConditionScript.hpp"
+#include "openvic-simulation/types/HasIndex.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 #include "openvic-simulation/types/IndexedFlatMap.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
@@ -44,7 +45,7 @@ namespace OpenVic {
 	struct ProvinceInstance;
 	struct State;
 
-	struct ProductionType : HasIdentifier {
+	struct ProductionType : HasIdentifier, HasIndex<ProductionType, production_type_index_t> {
 		friend struct ProductionTypeManager;
 
 		enum struct template_type_t { FACTORY, RGO, ARTISAN };
@@ -70,6 +71,7 @@ namespace OpenVic {
 		const fixed_point_t base_output_quantity;
 
 		ProductionType(
+			index_t new_index,
 			GameRulesManager const& new_game_rules_manager,
 			const std::string_view new_identifier,
 			std::optional<Job>&& new_owner,
@@ -1,5 +1,7 @@
 #include "ResourceGatheringOperation.hpp"
 
+#include <algorithm>
+
 #include <type_safe/strong_typedef.hpp>
 
 #include "openvic-simulation/country/CountryInstance.hpp"
@@ -12,6 +14,7 @@
 #include "openvic-simulation/map/State.hpp"
 #include "openvic-simulation/modifier/ModifierEffectCache.hpp"
 #include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopsByType.hpp"
 #include "openvic-simulation/population/PopSize.hpp"
 #include "openvic-simulation/population/PopSum.hpp"
 #include "openvic-simulation/population/PopType.hpp"
@@ -126,7 +129,7 @@ fixed_point_t ResourceGatheringOperation::calculate_size_modifier() const {
 	return size_modifier > 0 ? size_modifier : fixed_point_t::_0;
 }
 
-void ResourceGatheringOperation::rgo_tick(memory::vector<fixed_point_t>& reusable_vector) {
+void ResourceGatheringOperation::rgo_tick(const std::size_t order_buffer_index) {
 	ProvinceInstance& location = *location_ptr;
 	if (production_type_nullable == nullptr || location.get_owner() == nullptr) {
 		output_quantity_yesterday = 0;
@@ -145,12 +148,12 @@ void ResourceGatheringOperation::rgo_tick(memory::vector<fixed_point_t>& reusabl
 	hire();
 
 	total_owner_count_in_state_cache = 0;
-	owner_pops_cache_nullable = nullptr;
+	owner_pops_cache = {};
 
 	if (production_type.owner.has_value()) {
 		const pop_type_index_t owner_pop_type_index = production_type.owner->pop_type_index;
 		total_owner_count_in_state_cache = location.get_state()->get_population_by_type()[owner_pop_type_index];
-		owner_pops_cache_nullable = &location.get_state()->get_pops_cache_by_type()[owner_pop_type_index];
+		owner_pops_cache = location.get_state()->get_pops_by_type()[owner_pop_type_index];
 	}
 
 	output_quantity_yesterday = produce();
@@ -160,25 +163,24 @@ void ResourceGatheringOperation::rgo_tick(memory::vector<fixed_point_t>& reusabl
 			country_to_report_economy_nullable->report_output(production_type, output_quantity_yesterday);
 		}
 
-		market_instance.place_market_sell_order(
-			{
-				production_type.output_good.index,
-				country_to_report_economy_nullable == nullptr
-					? std::nullopt
-					: std::optional<country_index_t>{country_to_report_economy_nullable->index},
-				output_quantity_yesterday,
-				this,
-				after_sell,
-			},
-			reusable_vector
-		);
+		market_instance.place_market_sell_order(order_buffer_index, {
+			production_type.output_good.index,
+			country_to_report_economy_nullable == nullptr
+				? std::nullopt
+				: std::optional<country_index_t>{country_to_report_economy_nullable->index},
+			output_quantity_yesterday,
+			&pending_sell
+		});
 	}
 }
 
-void ResourceGatheringOperation::after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) {
-	ResourceGatheringOperation& rgo = *static_cast<ResourceGatheringOperation*>(actor);
-	rgo.revenue_yesterday = sell_result.money_gained;
-	rgo.pay_employees(reusable_vector);
+void ResourceGatheringOperation::settle_trades(memory::vector<fixed_point_t>& reusable_vector) {
+	if (!pending_sell.has_value()) {
+		return;
+	}
+	revenue_yesterday = pending_sell->money_gained;
+	pending_sell.reset();
+	pay_employees(reusable_vector);
 }
 
 void ResourceGatheringOperation::hire() {
@@ -206,25 +208,26 @@ void ResourceGatheringOperation::hire() {
 	}
 
 	std::span<const Job> jobs = production_type.get_jobs();
-	for (Pop& pop : location.get_mutable_pops()){
-		PopType const& pop_type = pop.get_type();
-		for (Job const& job : jobs) {
-			const pop_type_index_t job_pop_type_index = job.pop_type_index;
-			if (job_pop_type_index == pop_type.index) {
-				const pop_size_t pop_size_to_hire = (proportion_to_hire * pop.get_size()).floor<type_safe::underlying_type<pop_size_t>>();
-				if (pop_size_to_hire <= 0) {
-					continue;
-				}
+	//employees are kept in province pop order, pay_employees hands out its rounding in that order
+	for (Pop& pop : location.get_mutable_pops()) {
+		const pop_type_index_t pop_type_index = pop.get_type().index;
+		if (std::none_of(jobs.begin(), jobs.end(), [pop_type_index](Job const& job) -> bool {
+			return job.pop_type_index == pop_type_index;
+		})) {
+			continue;
+		}
 
-				employee_count_per_type_cache[pop_type.index] += pop_size_to_hire;
-				employees.emplace_back(pop, pop_size_to_hire);
-				pop.hire(pop_size_to_hire);
-				total_employees_count_cache += pop_size_to_hire;
-				if (!pop_type.is_slave) {
-					total_paid_employees_count_cache += pop_size_to_hire;
-				}
-				break;
-			}
+		const pop_size_t pop_size_to_hire = (proportion_to_hire * pop.get_size()).floor<type_safe::underlying_type<pop_size_t>>();
+		if (pop_size_to_hire <= 0) {
+			continue;
+		}
+
+		employee_count_per_type_cache[pop_type_index] += pop_size_to_hire;
+		employees.emplace_back(pop, pop_size_to_hire);
+		pop.hire(pop_size_to_hire);
+		total_employees_count_cache += pop_size_to_hire;
+		if (!pop.get_type().is_slave) {
+			total_paid_employees_count_cache += pop_size_to_hire;
 		}
 	}
 }
@@ -410,7 +413,8 @@ void ResourceGatheringOperation::pay_employees(memory::vector<fixed_point_t>& re
 				upper_limit
 			);
 
-			for (Pop& owner_pop : *owner_pops_cache_nullable) {
+			for (Pop* const owner_pop_ptr : owner_pops_cache) {
+				Pop& owner_pop = *owner_pop_ptr;
 				const fixed_point_t income_for_this_pop = std::max(
 					revenue_left * fp::mul_div<pop_sum_t>(
 						owner_share,
@@ -419,7 +423,7 @@ void ResourceGatheringOperation::pay_employees(memory::vector<fixed_point_t>& re
 					),
 					fixed_point_t::epsilon //revenue > 0 is already checked, so rounding up
 				);
-				owner_pop.add_rgo_owner_income(income_for_this_pop);
+				owner_pop.defer_rgo_owner_income(income_for_this_pop);
 				total_owner_income_cache += income_for_this_pop;
 			}
 			revenue_left -= total_owner_income_cache;
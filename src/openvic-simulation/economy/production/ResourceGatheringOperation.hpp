@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <optional>
+#include <span>
 
 #include "openvic-simulation/core/memory/FixedVector.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/economy/production/Employee.hpp"
+#include "openvic-simulation/economy/trading/SellResult.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/population/PopSize.hpp"
 #include "openvic-simulation/population/PopSum.hpp"
@@ -19,7 +23,6 @@ namespace OpenVic {
 	struct ProductionType;
 	struct ProvinceInstance;
 	struct ResourceGatheringOperationDeps;
-	struct SellResult;
 
 	struct ResourceGatheringOperation {
 	private:
@@ -28,7 +31,8 @@ namespace OpenVic {
 		ProvinceInstance* location_ptr = nullptr;
 		pop_sum_t total_owner_count_in_state_cache = 0;
 		pop_sum_t total_worker_count_in_province_cache = 0;
-		memory::vector<std::reference_wrapper<Pop>> const* owner_pops_cache_nullable = nullptr;
+		// Empty when the production type has no owner
+		std::span<Pop* const> owner_pops_cache;
 
 		ProductionType const* PROPERTY_RW(production_type_nullable);
 		fixed_point_t PROPERTY(revenue_yesterday);
@@ -36,6 +40,8 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(unsold_quantity_yesterday);
 		fixed_point_t PROPERTY_RW(size_multiplier);
 		memory::vector<Employee> SPAN_PROPERTY(employees);
+		//written by the market while goods execute, only set when an order was placed today
+		std::optional<SellResult> pending_sell;
 		pop_size_t PROPERTY(max_employee_count_cache, 0);
 		pop_size_t PROPERTY(total_employees_count_cache, 0);
 		pop_size_t PROPERTY(total_paid_employees_count_cache, 0);
@@ -50,7 +56,6 @@ namespace OpenVic {
 		void hire();
 		fixed_point_t produce();
 		void pay_employees(memory::vector<fixed_point_t>& reusable_vector);
-		static void after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector);
 
 	public:
 		ResourceGatheringOperation(
@@ -70,7 +75,8 @@ namespace OpenVic {
 		}
 		void setup_location_ptr(ProvinceInstance& location);
 		void initialise_rgo_size_multiplier();
-		static constexpr size_t VECTORS_FOR_RGO_TICK = 1;
-		void rgo_tick(memory::vector<fixed_point_t>& reusable_vector);
+		void rgo_tick(const std::size_t order_buffer_index);
+		//Applies the result of today's sell order, once the market has executed the orders.
+		void settle_trades(memory::vector<fixed_point_t>& reusable_vector);
 	};
 }
\ No newline at end of file
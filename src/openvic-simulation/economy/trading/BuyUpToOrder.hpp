@@ -7,12 +7,11 @@
 
 namespace OpenVic {
 	struct GoodBuyUpToOrder {
-		using actor_t = void*;
-		using callback_t = void(*)(const actor_t, BuyResult const&);
+		//owned by the actor placing the order, it applies the result itself once all goods are executed
+		using result_slot_t = std::optional<BuyResult>*;
 
 	private:
-		const actor_t actor;
-		const callback_t after_trade;
+		const result_slot_t result_slot;
 
 	public:
 		const std::optional<country_index_t> country_index_optional;
@@ -23,17 +22,19 @@ namespace OpenVic {
 			const std::optional<country_index_t> new_country_index_optional,
 			const fixed_point_t new_max_quantity,
 			const fixed_point_t new_money_to_spend,
-			const actor_t new_actor,
-			const callback_t new_after_trade
+			const result_slot_t new_result_slot
 		) : country_index_optional { new_country_index_optional },
 			max_quantity { new_max_quantity },
 			money_to_spend { new_money_to_spend },
-			actor { new_actor },
-			after_trade { new_after_trade }
+			result_slot { new_result_slot }
 			{}
 
-		constexpr void call_after_trade(BuyResult const& buy_result) const {
-			after_trade(actor, buy_result);
+		constexpr result_slot_t get_result_slot() const {
+			return result_slot;
+		}
+
+		constexpr void set_result(BuyResult const& buy_result) const {
+			result_slot->emplace(buy_result);
 		}
 
 		//highest price per unit at which the buyer can afford max_quantity
@@ -51,20 +52,14 @@ namespace OpenVic {
 			const std::optional<country_index_t> new_country_index_optional,
 			const fixed_point_t new_max_quantity,
 			const fixed_point_t new_money_to_spend,
-			const actor_t new_actor,
-			const callback_t new_after_trade
+			const result_slot_t new_result_slot
 		) : GoodBuyUpToOrder {
 				new_country_index_optional,
 				new_max_quantity,
 				new_money_to_spend,
-				new_actor,
-				new_after_trade
+				new_result_slot
 			},
 			good_index { new_good_index }
 			{}
-
-			constexpr void call_after_trade(BuyResult const& buy_result) const {
-				GoodBuyUpToOrder::call_after_trade(buy_result);
-			}
 	};
 }
\ No newline at end of file
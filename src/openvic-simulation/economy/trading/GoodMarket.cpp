@@ -1,7 +1,6 @@
 #include "GoodMarket.hpp"
 
 #include <algorithm>
-#include <mutex>
 
 #include "openvic-simulation/economy/GoodDefinition.hpp"
 #include "openvic-simulation/economy/trading/BuyUpToOrder.hpp"
@@ -57,14 +56,92 @@ void GoodMarket::update_next_price_limits() {
 	price_inverse = fixed_point_t::_1 / price;
 }
 
-void GoodMarket::add_buy_up_to_order(GoodBuyUpToOrder&& buy_up_to_order) {
-	const std::lock_guard<spin_mutex> lock_guard { buy_lock };
-	buy_up_to_orders.push_back(std::move(buy_up_to_order));
+void GoodMarket::add_buy_up_to_order(const std::size_t order_buffer_index, GoodBuyUpToOrder&& buy_up_to_order) {
+	order_buffers[order_buffer_index].buy_up_to_orders.push_back(std::move(buy_up_to_order));
 }
 
-void GoodMarket::add_market_sell_order(GoodMarketSellOrder&& market_sell_order) {
-	const std::lock_guard<spin_mutex> lock_guard { sell_lock };
-	market_sell_orders.push_back(std::move(market_sell_order));
+void GoodMarket::add_market_sell_order(const std::size_t order_buffer_index, GoodMarketSellOrder&& market_sell_order) {
+	order_buffers[order_buffer_index].market_sell_orders.push_back(std::move(market_sell_order));
+}
+
+void GoodMarket::gather_orders(const country_index_t country_count) {
+	no_country_index = country_count;
+	size_t buy_order_count = buy_max_quantities.size();
+	size_t sell_order_count = sell_quantities.size();
+	for (order_buffer_t const& order_buffer : order_buffers) {
+		buy_order_count += order_buffer.buy_up_to_orders.size();
+		sell_order_count += order_buffer.market_sell_orders.size();
+	}
+	buy_max_quantities.reserve(buy_order_count);
+	buy_money_to_spend.reserve(buy_order_count);
+	buy_country_indices.reserve(buy_order_count);
+	buy_result_slots.reserve(buy_order_count);
+	sell_quantities.reserve(sell_order_count);
+	sell_country_indices.reserve(sell_order_count);
+	sell_result_slots.reserve(sell_order_count);
+
+	for (order_buffer_t& order_buffer : order_buffers) {
+		for (GoodBuyUpToOrder const& buy_up_to_order : order_buffer.buy_up_to_orders) {
+			buy_max_quantities.push_back(buy_up_to_order.max_quantity);
+			buy_money_to_spend.push_back(buy_up_to_order.money_to_spend);
+			buy_country_indices.push_back(buy_up_to_order.country_index_optional.value_or(no_country_index));
+			buy_result_slots.push_back(buy_up_to_order.get_result_slot());
+		}
+		order_buffer.buy_up_to_orders.clear();
+		for (GoodMarketSellOrder const& market_sell_order : order_buffer.market_sell_orders) {
+			sell_quantities.push_back(market_sell_order.quantity);
+			sell_country_indices.push_back(market_sell_order.country_index_optional.value_or(no_country_index));
+			sell_result_slots.push_back(market_sell_order.get_result_slot());
+		}
+		order_buffer.market_sell_orders.clear();
+	}
+
+	buy_purchasing_powers.resize(buy_max_quantities.size());
+	const size_t order_count = std::max(buy_max_quantities.size(), sell_quantities.size());
+	sums_per_block.resize((order_count + ORDER_BLOCK_SIZE - 1) / ORDER_BLOCK_SIZE);
+}
+
+void GoodMarket::sum_order_block(const size_t block_index) {
+	order_sums_t& block_sums = sums_per_block[block_index] = {};
+	if (!is_available) {
+		return;
+	}
+
+	const size_t begin = block_index * ORDER_BLOCK_SIZE;
+	const size_t buy_end = std::min(begin + ORDER_BLOCK_SIZE, buy_max_quantities.size());
+	const size_t sell_end = std::min(begin + ORDER_BLOCK_SIZE, sell_quantities.size());
+
+	for (size_t i = begin; i < buy_end; i++) {
+		block_sums.demand_sum += buy_max_quantities[i];
+	}
+	for (size_t i = begin; i < sell_end; i++) {
+		block_sums.supply_sum += sell_quantities[i];
+	}
+
+	if (game_rules_manager.get_use_optimal_pricing()) {
+		for (size_t i = begin; i < buy_end; i++) {
+			block_sums.max_affordable_price = std::max(
+				block_sums.max_affordable_price,
+				buy_money_to_spend[i] / buy_max_quantities[i]
+			);
+		}
+	}
+
+	if (sell_quantities.empty()) {
+		return;
+	}
+
+	for (size_t i = begin; i < buy_end; i++) {
+		const fixed_point_t max_quantity = buy_max_quantities[i];
+		//buyers without money have no purchasing power
+		const fixed_point_t money_to_spend = std::max(buy_money_to_spend[i], fixed_point_t::_0);
+		const fixed_point_t purchasing_power = buy_purchasing_powers[i] = money_to_spend / max_next_price;
+		block_sums.max_quantity_to_buy_sum += std::min(purchasing_power, max_quantity);
+		block_sums.purchasing_power_sum += purchasing_power;
+		block_sums.money_left_to_spend_sum += purchasing_power >= max_quantity
+			? max_quantity * max_next_price
+			: money_to_spend;
+	}
 }
 
 void GoodMarket::execute_orders(
@@ -75,6 +152,9 @@ void GoodMarket::execute_orders(
 		VECTORS_FOR_EXECUTE_ORDERS
 	> reusable_vectors
 ) {
+	const size_t buy_order_count = buy_max_quantities.size();
+	const size_t sell_order_count = sell_quantities.size();
+
 	if (!is_available) {
 		//price remains the same
 		price_change_yesterday
@@ -83,39 +163,42 @@ void GoodMarket::execute_orders(
 			= total_supply_yesterday
 			= 0;
 
-		for (GoodBuyUpToOrder const& buy_up_to_order : buy_up_to_orders) {
-			buy_up_to_order.call_after_trade(BuyResult::no_purchase_result(good_definition.index));
+		for (size_t i = 0; i < buy_order_count; i++) {
+			buy_results.push_back(BuyResult::no_purchase_result(good_definition.index));
+		}
+		for (size_t i = 0; i < sell_order_count; i++) {
+			sell_results.push_back(SellResult::no_sales_result(good_definition.index));
 		}
-		buy_up_to_orders.clear();
-
-		for (GoodMarketSellOrder const& market_sell_order : market_sell_orders) {
-			market_sell_order.call_after_trade(SellResult::no_sales_result(good_definition.index), reusable_vectors[0]);
-		}		
-		market_sell_orders.clear();
-		
 		return;
 	}
 
+	//reduced in block order, so the sums don't depend on which worker summed which block
+	order_sums_t sums {};
+	for (order_sums_t const& block_sums : sums_per_block) {
+		sums.demand_sum += block_sums.demand_sum;
+		sums.supply_sum += block_sums.supply_sum;
+		sums.max_affordable_price = std::max(sums.max_affordable_price, block_sums.max_affordable_price);
+		sums.max_quantity_to_buy_sum += block_sums.max_quantity_to_buy_sum;
+		sums.purchasing_power_sum += block_sums.purchasing_power_sum;
+		sums.money_left_to_spend_sum += block_sums.money_left_to_spend_sum;
+	}
+
+	const bool use_optimal_pricing = game_rules_manager.get_use_optimal_pricing();
 	fixed_point_t new_price;
 	//MarketInstance ensured only orders with quantity > 0 are added.
 	//So running total > 0 unless orders are empty.
-	fixed_point_t demand_sum = 0,
-		supply_sum = 0;
-	if (market_sell_orders.empty()) {
-		quantity_traded_yesterday = 0;
-		fixed_point_t max_affordable_price = price;
-		for (GoodBuyUpToOrder const& buy_up_to_order : buy_up_to_orders) {
-			const fixed_point_t affordable_price = buy_up_to_order.get_affordable_price();
-			if (affordable_price > max_affordable_price) {
-				max_affordable_price = affordable_price;
-			}
+	const fixed_point_t demand_sum = sums.demand_sum;
+	const fixed_point_t supply_sum = sums.supply_sum;
+	const fixed_point_t max_affordable_price = sums.max_affordable_price;
 
-			demand_sum += buy_up_to_order.max_quantity;
-			buy_up_to_order.call_after_trade(BuyResult::no_purchase_result(good_definition.index));
+	if (sell_order_count == 0) {
+		quantity_traded_yesterday = 0;
+		for (size_t i = 0; i < buy_order_count; i++) {
+			buy_results.push_back(BuyResult::no_purchase_result(good_definition.index));
 		}
 
-		if (game_rules_manager.get_use_optimal_pricing()) {
-			new_price = std::min(max_next_price, max_affordable_price);
+		if (use_optimal_pricing) {
+			new_price = std::min(max_next_price, std::max(price, max_affordable_price));
 		} else {
 			//TODO use Victoria 2's square root mechanic, see https://github.com/OpenVicProject/OpenVic/issues/288
 			if (demand_sum > 0) {
@@ -127,114 +210,37 @@ void GoodMarket::execute_orders(
 	} else {
 		TypedSpan<country_index_t, fixed_point_t> supply_per_country = reusable_country_map_0;
 		TypedSpan<country_index_t, fixed_point_t> actual_bought_per_country = reusable_country_map_1;
-		for (GoodMarketSellOrder const& market_sell_order : market_sell_orders) {
-			const std::optional<country_index_t> country_index_optional = market_sell_order.country_index_optional;
-			if (country_index_optional.has_value()) {
-				supply_per_country[country_index_optional.value()] += market_sell_order.quantity;
-			}
-			supply_sum += market_sell_order.quantity;
+		for (size_t i = 0; i < sell_order_count; i++) {
+			supply_per_country[sell_country_indices[i]] += sell_quantities[i];
 		}
-		memory::vector<fixed_point_t>& quantity_bought_per_order = reusable_vectors[0];
-		memory::vector<fixed_point_t>& purchasing_power_per_order = reusable_vectors[1];
-		quantity_bought_per_order.resize(buy_up_to_orders.size());
-		purchasing_power_per_order.resize(buy_up_to_orders.size());
-
-		fixed_point_t money_left_to_spend_sum = 0; //sum of money_to_spend for all buyers that can't afford their max_quantity
-		fixed_point_t max_quantity_to_buy_sum = 0;
-		fixed_point_t purchasing_power_sum = 0;
-		for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-			GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-			const fixed_point_t max_quantity = buy_up_to_order.max_quantity;
-			const fixed_point_t money_to_spend = buy_up_to_order.money_to_spend;
-
-			if (game_rules_manager.get_use_optimal_pricing()) {
-				const fixed_point_t affordable_price = buy_up_to_order.get_affordable_price();
-				if (affordable_price > min_next_price) {
-					//no point selling lower as it would not attract more buyers
-					min_next_price = affordable_price;
-				}
-			}
 
-			demand_sum += max_quantity;
+		if (use_optimal_pricing) {
+			//no point selling lower as it would not attract more buyers
+			min_next_price = std::max(min_next_price, max_affordable_price);
+		}
 
-			if (money_to_spend <= 0) {
-				purchasing_power_per_order[i] = 0;
-				continue;
-			}
+		memory::vector<fixed_point_t>& quantity_bought_per_order = reusable_vectors[0];
+		quantity_bought_per_order.resize(buy_order_count);
 
-			fixed_point_t purchasing_power = purchasing_power_per_order[i] = money_to_spend / max_next_price;
-			if (purchasing_power >= max_quantity) {
-				max_quantity_to_buy_sum += max_quantity;
-				money_left_to_spend_sum += max_quantity * max_next_price;
-				purchasing_power_sum += max_quantity;
-			} else {
-				max_quantity_to_buy_sum += purchasing_power;
-				money_left_to_spend_sum += money_to_spend;
-				purchasing_power_sum += purchasing_power;
-			}
-		}
+		fixed_point_t money_left_to_spend_sum = sums.money_left_to_spend_sum;
+		const fixed_point_t max_quantity_to_buy_sum = sums.max_quantity_to_buy_sum;
 
-		fixed_point_t remaining_supply = supply_sum;
 		const bool is_selling_for_max_price = max_quantity_to_buy_sum >= supply_sum;
 		if (is_selling_for_max_price) {
 			//sell for max_next_price
-			if (game_rules_manager.get_use_optimal_pricing()) {
+			if (use_optimal_pricing) {
 				new_price = max_next_price;
 			} else {
 				//TODO use Victoria 2's square root mechanic, see https://github.com/OpenVicProject/OpenVic/issues/288
 				new_price = max_next_price;
 			}
 
-			bool someone_bought_max_quantity;
-			do {
-				someone_bought_max_quantity = false;
-				for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-					GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-					const fixed_point_t max_quantity = buy_up_to_order.max_quantity;
-					fixed_point_t& distributed_supply = quantity_bought_per_order[i];
-					if (distributed_supply == max_quantity) {
-						continue;
-					}
-
-					const std::optional<country_index_t> country_index_optional = buy_up_to_order.country_index_optional;
-					if (country_index_optional.has_value()) {
-						//subtract as it might be updated below
-						actual_bought_per_country[country_index_optional.value()] -= distributed_supply;
-					}
-
-					distributed_supply = fp::mul_div(
-						remaining_supply,
-						purchasing_power_per_order[i],
-						purchasing_power_sum
-					);
-
-					if (distributed_supply >= max_quantity) {
-						someone_bought_max_quantity = true;
-						distributed_supply = max_quantity;
-						remaining_supply -= max_quantity;
-						purchasing_power_sum -= purchasing_power_per_order[i];
-					}
-
-					if (country_index_optional.has_value()) {
-						actual_bought_per_country[country_index_optional.value()] += distributed_supply;
-					}
-
-					if (someone_bought_max_quantity) {
-						break;
-					}
-				}
-			} while (someone_bought_max_quantity);
-
-			execute_buy_orders(
-				new_price,
-				actual_bought_per_country,
-				supply_per_country,
-				quantity_bought_per_order
-			);
+			ration_supply(supply_sum, sums.purchasing_power_sum, buy_purchasing_powers, quantity_bought_per_order);
 		} else {
 			//sell below max_next_price
-			if (game_rules_manager.get_use_optimal_pricing()) {
+			if (use_optimal_pricing) {
 				new_price = price;
+				fixed_point_t remaining_supply = supply_sum;
 
 				//drop price while remaining_supply > 0 && new_price > min_next_price
 				while (remaining_supply > 0) {
@@ -252,16 +258,16 @@ void GoodMarket::execute_orders(
 
 					new_price = possible_price;
 
-					for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-						GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-						if (quantity_bought_per_order[i] == buy_up_to_order.max_quantity) {
+					for (size_t i = 0; i < buy_order_count; i++) {
+						const fixed_point_t max_quantity = buy_max_quantities[i];
+						if (quantity_bought_per_order[i] == max_quantity) {
 							continue;
 						}
 
-						if (buy_up_to_order.money_to_spend >= new_price * buy_up_to_order.max_quantity) {
-							quantity_bought_per_order[i] = buy_up_to_order.max_quantity;
-							remaining_supply -= buy_up_to_order.max_quantity;
-							money_left_to_spend_sum -= buy_up_to_order.money_to_spend;
+						if (buy_money_to_spend[i] >= new_price * max_quantity) {
+							quantity_bought_per_order[i] = max_quantity;
+							remaining_supply -= max_quantity;
+							money_left_to_spend_sum -= buy_money_to_spend[i];
 						}
 					}
 				}
@@ -275,122 +281,33 @@ void GoodMarket::execute_orders(
 			}
 
 			//figure out how much every buyer bought
-			for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-				GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
-
-				const fixed_point_t quantity_bought
-					= quantity_bought_per_order[i]
-					= std::min(
-					buy_up_to_order.max_quantity,
-					buy_up_to_order.money_to_spend / new_price
-				);
-
-				const std::optional<country_index_t> country_index_optional = buy_up_to_order.country_index_optional;
-				if (country_index_optional.has_value()) {
-					actual_bought_per_country[country_index_optional.value()] += quantity_bought_per_order[i];
-				}
+			for (size_t i = 0; i < buy_order_count; i++) {
+				quantity_bought_per_order[i] = std::min(buy_max_quantities[i], buy_money_to_spend[i] / new_price);
 			}
+		}
 
-			execute_buy_orders(
-				new_price,
-				actual_bought_per_country,
-				supply_per_country,
-				quantity_bought_per_order
-			);
+		for (size_t i = 0; i < buy_order_count; i++) {
+			actual_bought_per_country[buy_country_indices[i]] += quantity_bought_per_order[i];
 		}
 
+		execute_buy_orders(
+			new_price,
+			actual_bought_per_country,
+			supply_per_country,
+			quantity_bought_per_order
+		);
+
 		for (auto& reusable_vector : reusable_vectors) {
 			reusable_vector.clear();
 		}
 
-		//figure out how much of each order was sold
-		if (quantity_traded_yesterday == supply_sum) {
-			//everything was sold
-			for (GoodMarketSellOrder const& market_sell_order : market_sell_orders) {
-				const fixed_point_t quantity_sold = market_sell_order.quantity;
-				fixed_point_t money_gained;
-				if (quantity_sold == 0) {
-					money_gained = 0;
-				} else {
-					money_gained = std::max(
-						quantity_sold * new_price,
-						fixed_point_t::epsilon //round up
-					);
-				}
-				market_sell_order.call_after_trade(
-					{
-						good_definition.index,
-						quantity_sold,
-						money_gained
-					},
-					reusable_vectors[0]
-				);
-			}
-		} else {
-			//quantity is evenly divided after taking domestic buyers into account
-			fixed_point_t total_quantity_traded_domestically = 0;
-			for (country_index_t country_index(0); country_index < actual_bought_per_country.size(); ++country_index) {
-				const fixed_point_t actual_bought = actual_bought_per_country[country_index];
-				const fixed_point_t supply = supply_per_country[country_index];
-				const fixed_point_t traded_domestically = std::min(supply, actual_bought);
-				total_quantity_traded_domestically += traded_domestically;
-			}
-
-			const fixed_point_t total_quantity_traded_as_export = quantity_traded_yesterday - total_quantity_traded_domestically;
-			const fixed_point_t total_quantity_offered_as_export = supply_sum - total_quantity_traded_domestically;
-			for (GoodMarketSellOrder const& market_sell_order : market_sell_orders) {
-				const fixed_point_t quantity_offered = market_sell_order.quantity;
-
-				fixed_point_t quantity_sold_domestically;
-				fixed_point_t quantity_offered_as_export;
-				const std::optional<country_index_t> country_index_optional = market_sell_order.country_index_optional;
-				if (!country_index_optional.has_value()) {
-					quantity_sold_domestically = 0;
-					quantity_offered_as_export = quantity_offered;
-				} else {
-					const country_index_t country_index = country_index_optional.value();
-					const fixed_point_t total_bought_domestically = actual_bought_per_country[country_index];
-					const fixed_point_t total_domestic_supply = supply_per_country[country_index];
-					quantity_sold_domestically = total_bought_domestically >= total_domestic_supply
-						? quantity_offered
-						: fp::mul_div(
-							quantity_offered,
-							total_bought_domestically,
-							total_domestic_supply //> 0 as we're selling
-						);
-					quantity_offered_as_export = quantity_offered - quantity_sold_domestically;
-				}
-
-				const fixed_point_t fair_share_of_exports = fp::mul_div(
-					quantity_offered_as_export,
-					total_quantity_traded_as_export,
-					total_quantity_offered_as_export
-				);
-
-				const fixed_point_t quantity_sold = quantity_sold_domestically + fair_share_of_exports;
-				fixed_point_t money_gained;
-				if (quantity_sold == 0) {
-					money_gained = 0;
-				} else {
-					money_gained = std::max(
-						quantity_sold * new_price,
-						fixed_point_t::epsilon //round up
-					);
-				}
-				market_sell_order.call_after_trade(
-					{
-						good_definition.index,
-						quantity_sold,
-						money_gained
-					},
-					reusable_vectors[0]
-				);
-			}
-		}
+		execute_sell_orders(
+			new_price,
+			supply_sum,
+			actual_bought_per_country,
+			supply_per_country
+		);
 
-		std::fill(reusable_country_map_0.begin(), reusable_country_map_0.end(), 0);
-		std::fill(reusable_country_map_1.begin(), reusable_country_map_1.end(), 0);
-		market_sell_orders.clear();
 		std::fill(supply_per_country.begin(), supply_per_country.end(), 0);
 		std::fill(actual_bought_per_country.begin(), actual_bought_per_country.end(), 0);
 	}
@@ -398,13 +315,56 @@ void GoodMarket::execute_orders(
 	price_change_yesterday = new_price - price;
 	total_demand_yesterday = demand_sum;
 	total_supply_yesterday = supply_sum;
-	buy_up_to_orders.clear();
 	if (new_price != price) {
 		price = new_price;
 		update_next_price_limits();
 	}
 }
 
+void GoodMarket::ration_supply(
+	const fixed_point_t supply_sum,
+	const fixed_point_t purchasing_power_sum,
+	std::span<const fixed_point_t> purchasing_power_per_order,
+	std::span<fixed_point_t> quantity_bought_per_order
+) const {
+	const size_t buy_order_count = buy_max_quantities.size();
+	fixed_point_t remaining_supply = supply_sum;
+	fixed_point_t remaining_purchasing_power = purchasing_power_sum;
+
+	//quantity_bought == max_quantity marks capped buyers, the others are only assigned their share once all caps are known.
+	//Capping a buyer never lowers anyone else's share, so each round caps every buyer reaching its max_quantity
+	//in one pass and the caps are the same as capping the first such buyer and rescanning.
+	bool is_any_buyer_capped;
+	do {
+		is_any_buyer_capped = false;
+		fixed_point_t capped_quantity_sum = 0;
+		fixed_point_t capped_purchasing_power_sum = 0;
+		for (size_t i = 0; i < buy_order_count; i++) {
+			const fixed_point_t max_quantity = buy_max_quantities[i];
+			if (
+				quantity_bought_per_order[i] != max_quantity
+				&& fp::mul_div(remaining_supply, purchasing_power_per_order[i], remaining_purchasing_power) >= max_quantity
+			) {
+				quantity_bought_per_order[i] = max_quantity;
+				capped_quantity_sum += max_quantity;
+				capped_purchasing_power_sum += purchasing_power_per_order[i];
+				is_any_buyer_capped = true;
+			}
+		}
+		remaining_supply -= capped_quantity_sum;
+		remaining_purchasing_power -= capped_purchasing_power_sum;
+	} while (is_any_buyer_capped && remaining_purchasing_power > 0);
+
+	for (size_t i = 0; i < buy_order_count; i++) {
+		if (quantity_bought_per_order[i] != buy_max_quantities[i]) {
+			//only buyers without purchasing power are left once it's all used up
+			quantity_bought_per_order[i] = remaining_purchasing_power > 0
+				? fp::mul_div(remaining_supply, purchasing_power_per_order[i], remaining_purchasing_power)
+				: fixed_point_t::_0;
+		}
+	}
+}
+
 void GoodMarket::execute_buy_orders(
 	const fixed_point_t new_price,
 	TypedSpan<country_index_t, const fixed_point_t> actual_bought_per_country,
@@ -412,51 +372,142 @@ void GoodMarket::execute_buy_orders(
 	std::span<const fixed_point_t> quantity_bought_per_order
 ) {
 	quantity_traded_yesterday = 0;
-	for (size_t i = 0; i < buy_up_to_orders.size(); i++) {
-		GoodBuyUpToOrder const& buy_up_to_order = buy_up_to_orders[i];
+	for (size_t i = 0; i < buy_max_quantities.size(); i++) {
 		const fixed_point_t quantity_bought = quantity_bought_per_order[i];
 
 		if (quantity_bought == 0) {
-			buy_up_to_order.call_after_trade(BuyResult::no_purchase_result(good_definition.index));
+			buy_results.push_back(BuyResult::no_purchase_result(good_definition.index));
+			continue;
+		}
+
+		quantity_traded_yesterday += quantity_bought;
+		const fixed_point_t money_spent_total = std::max(
+			quantity_bought * new_price,
+			fixed_point_t::epsilon //we know from purchasing power that you can afford it.
+		);
+
+		const country_index_t country_index = buy_country_indices[i];
+		//must be > 0, since quantity_bought > 0
+		const fixed_point_t actual_bought_in_my_country = actual_bought_per_country[country_index];
+		const fixed_point_t supply_in_my_country = supply_per_country[country_index];
+
+		fixed_point_t money_spent_on_imports;
+		if (country_index == no_country_index) {
+			//could be trade between native Americans and tribal Africa, so it's all imported
+			money_spent_on_imports = money_spent_total;
+		} else if (supply_in_my_country >= actual_bought_in_my_country) {
+			//no imports
+			money_spent_on_imports = 0;
 		} else {
-			quantity_traded_yesterday += quantity_bought;
-			const fixed_point_t money_spent_total = std::max(
-				quantity_bought * new_price,
-				fixed_point_t::epsilon //we know from purchasing power that you can afford it.
+			const fixed_point_t money_spent_domestically = fp::mul_div(
+				money_spent_total,
+				supply_in_my_country,
+				actual_bought_in_my_country
 			);
 
-			fixed_point_t money_spent_on_imports;
-			const std::optional<country_index_t> country_index_optional = buy_up_to_order.country_index_optional;
-			if (!country_index_optional.has_value()) {
-				//could be trade between native Americans and tribal Africa, so it's all imported
-				money_spent_on_imports = money_spent_total;
-			} else {
-				const country_index_t country_index = country_index_optional.value();
-				//must be > 0, since quantity_bought > 0
-				const fixed_point_t actual_bought_in_my_country = actual_bought_per_country[country_index];
-				const fixed_point_t supply_in_my_country = supply_per_country[country_index];
-
-				if (supply_in_my_country >= actual_bought_in_my_country) {
-					//no imports
-					money_spent_on_imports = 0;
-				} else {
-					const fixed_point_t money_spent_domestically = fp::mul_div(
-						money_spent_total,
-						supply_in_my_country,
-						actual_bought_in_my_country
-					);
+			money_spent_on_imports = money_spent_total - money_spent_domestically;
+		}
 
-					money_spent_on_imports = money_spent_total - money_spent_domestically;
-				}
-			}
-			buy_up_to_order.call_after_trade({
+		buy_results.emplace_back(
+			good_definition.index,
+			quantity_bought,
+			money_spent_total,
+			money_spent_on_imports
+		);
+	}
+}
+
+void GoodMarket::execute_sell_orders(
+	const fixed_point_t new_price,
+	const fixed_point_t supply_sum,
+	TypedSpan<country_index_t, const fixed_point_t> actual_bought_per_country,
+	TypedSpan<country_index_t, const fixed_point_t> supply_per_country
+) {
+	const auto get_money_gained = [new_price](const fixed_point_t quantity_sold) -> fixed_point_t {
+		return quantity_sold == 0
+			? fixed_point_t::_0
+			: std::max(
+				quantity_sold * new_price,
+				fixed_point_t::epsilon //round up
+			);
+	};
+
+	//figure out how much of each order was sold
+	if (quantity_traded_yesterday == supply_sum) {
+		//everything was sold
+		for (const fixed_point_t quantity_sold : sell_quantities) {
+			sell_results.emplace_back(
 				good_definition.index,
-				quantity_bought,
-				money_spent_total,
-				money_spent_on_imports
-			});
+				quantity_sold,
+				get_money_gained(quantity_sold)
+			);
+		}
+		return;
+	}
+
+	//quantity is evenly divided after taking domestic buyers into account
+	fixed_point_t total_quantity_traded_domestically = 0;
+	for (country_index_t country_index(0); country_index < no_country_index; ++country_index) {
+		total_quantity_traded_domestically += std::min(
+			supply_per_country[country_index],
+			actual_bought_per_country[country_index]
+		);
+	}
+
+	const fixed_point_t total_quantity_traded_as_export = quantity_traded_yesterday - total_quantity_traded_domestically;
+	const fixed_point_t total_quantity_offered_as_export = supply_sum - total_quantity_traded_domestically;
+	for (size_t i = 0; i < sell_quantities.size(); i++) {
+		const fixed_point_t quantity_offered = sell_quantities[i];
+		const country_index_t country_index = sell_country_indices[i];
+		const fixed_point_t total_bought_domestically = actual_bought_per_country[country_index];
+		const fixed_point_t total_domestic_supply = supply_per_country[country_index];
+
+		fixed_point_t quantity_sold_domestically;
+		if (country_index == no_country_index) {
+			quantity_sold_domestically = 0;
+		} else if (total_bought_domestically >= total_domestic_supply) {
+			quantity_sold_domestically = quantity_offered;
+		} else {
+			quantity_sold_domestically = fp::mul_div(
+				quantity_offered,
+				total_bought_domestically,
+				total_domestic_supply //> 0 as we're selling
+			);
 		}
+
+		const fixed_point_t fair_share_of_exports = fp::mul_div(
+			quantity_offered - quantity_sold_domestically,
+			total_quantity_traded_as_export,
+			total_quantity_offered_as_export
+		);
+
+		const fixed_point_t quantity_sold = quantity_sold_domestically + fair_share_of_exports;
+		sell_results.emplace_back(
+			good_definition.index,
+			quantity_sold,
+			get_money_gained(quantity_sold)
+		);
+	}
+}
+
+void GoodMarket::publish_results() {
+	for (size_t i = 0; i < buy_result_slots.size(); i++) {
+		buy_result_slots[i]->emplace(buy_results[i]);
+	}
+	for (size_t i = 0; i < sell_result_slots.size(); i++) {
+		sell_result_slots[i]->emplace(sell_results[i]);
 	}
+	buy_max_quantities.clear();
+	buy_money_to_spend.clear();
+	buy_country_indices.clear();
+	buy_result_slots.clear();
+	sell_quantities.clear();
+	sell_country_indices.clear();
+	sell_result_slots.clear();
+	buy_purchasing_powers.clear();
+	sums_per_block.clear();
+	buy_results.clear();
+	sell_results.clear();
 }
 
 void GoodMarket::record_price_history() {
@@ -1,10 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <span>
 
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
-#include "openvic-simulation/core/thread/SpinMutex.hpp"
 #include "openvic-simulation/economy/trading/BuyUpToOrder.hpp"
 #include "openvic-simulation/economy/trading/MarketSellOrder.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
@@ -17,24 +18,75 @@ namespace OpenVic {
 	struct GoodDefinition;
 
 	struct GoodMarket {
+		//one per work bundle, see ThreadPool
+		static constexpr std::size_t ORDER_BUFFER_COUNT = 32;
+
 	private:
 		static constexpr int32_t exponential_price_change_shift = 7;
-		spin_mutex buy_lock;
-		spin_mutex sell_lock;
+
+		//append-only, only the work bundle owning the buffer writes to it
+		struct order_buffer_t {
+			memory::vector<GoodBuyUpToOrder> buy_up_to_orders;
+			memory::vector<GoodMarketSellOrder> market_sell_orders;
+		};
+
+		//sums over the orders of one block, every field is a sum except max_affordable_price
+		struct order_sums_t {
+			fixed_point_t demand_sum = 0;
+			fixed_point_t supply_sum = 0;
+			//highest price per unit at which any buyer can afford its max_quantity, only with optimal pricing
+			fixed_point_t max_affordable_price = 0;
+			//the rest are only summed when there are sellers
+			fixed_point_t max_quantity_to_buy_sum = 0;
+			//not capped at max_quantity, the whole supply is split by it when rationing
+			fixed_point_t purchasing_power_sum = 0;
+			fixed_point_t money_left_to_spend_sum = 0; //sum of money_to_spend for all buyers that can't afford their max_quantity
+		};
+
 		GameRulesManager const& game_rules_manager;
 		fixed_point_t absolute_maximum_price;
 		fixed_point_t absolute_minimum_price;
 
-		//only used during day tick (from actors placing order until execute_orders())
-		memory::vector<GoodBuyUpToOrder> buy_up_to_orders;
-		memory::vector<GoodMarketSellOrder> market_sell_orders;
+		//only used during day tick (from actors placing order until gather_orders())
+		std::array<order_buffer_t, ORDER_BUFFER_COUNT> order_buffers;
+		//Columnar order book, only used during day tick (from gather_orders() until publish_results()).
+		//Entry i of every buy column belongs to buy order i, likewise for the sell columns.
+		//Orders without a country use the extra last slot of the country maps passed to execute_orders.
+		memory::vector<fixed_point_t> buy_max_quantities;
+		memory::vector<fixed_point_t> buy_money_to_spend;
+		memory::vector<country_index_t> buy_country_indices;
+		memory::vector<GoodBuyUpToOrder::result_slot_t> buy_result_slots;
+		memory::vector<fixed_point_t> sell_quantities;
+		memory::vector<country_index_t> sell_country_indices;
+		memory::vector<GoodMarketSellOrder::result_slot_t> sell_result_slots;
+		//filled by sum_order_block
+		memory::vector<fixed_point_t> buy_purchasing_powers;
+		memory::vector<order_sums_t> sums_per_block;
+		country_index_t no_country_index;
+		//filled by execute_orders, result i belongs to order i
+		memory::vector<BuyResult> SPAN_PROPERTY(buy_results);
+		memory::vector<SellResult> SPAN_PROPERTY(sell_results);
 
+		//Caps buyers whose share of the supply reaches their max quantity, in rounds of one pass over the orders,
+		//and splits the rest of the supply by purchasing power.
+		void ration_supply(
+			const fixed_point_t supply_sum,
+			const fixed_point_t purchasing_power_sum,
+			std::span<const fixed_point_t> purchasing_power_per_order,
+			std::span<fixed_point_t> quantity_bought_per_order
+		) const;
 		void execute_buy_orders(
 			const fixed_point_t new_price,
 			TypedSpan<country_index_t, const fixed_point_t> actual_bought_per_country,
 			TypedSpan<country_index_t, const fixed_point_t> supply_per_country,
 			std::span<const fixed_point_t> quantity_bought_per_order
 		);
+		void execute_sell_orders(
+			const fixed_point_t new_price,
+			const fixed_point_t supply_sum,
+			TypedSpan<country_index_t, const fixed_point_t> actual_bought_per_country,
+			TypedSpan<country_index_t, const fixed_point_t> supply_per_country
+		);
 
 	protected:
 		bool PROPERTY_ACCESS(is_available, protected);
@@ -60,12 +112,34 @@ namespace OpenVic {
 		GoodMarket(GoodMarket&&) = delete;
 		GoodMarket& operator=(GoodMarket&&) = delete;
 
-		//thread safe
-		void add_buy_up_to_order(GoodBuyUpToOrder&& buy_up_to_order);
-		void add_market_sell_order(GoodMarketSellOrder&& market_sell_order);
+		//thread safe as long as each order_buffer_index is only used by one thread at a time
+		void add_buy_up_to_order(const std::size_t order_buffer_index, GoodBuyUpToOrder&& buy_up_to_order);
+		void add_market_sell_order(const std::size_t order_buffer_index, GoodMarketSellOrder&& market_sell_order);
 
 		//not thread safe
-		static constexpr size_t VECTORS_FOR_EXECUTE_ORDERS = 2;
+		constexpr size_t get_order_count() const {
+			size_t order_count = buy_max_quantities.size() + sell_quantities.size();
+			for (order_buffer_t const& order_buffer : order_buffers) {
+				order_count += order_buffer.buy_up_to_orders.size() + order_buffer.market_sell_orders.size();
+			}
+			return order_count;
+		}
+		//Clearing a good runs in 3 steps, each only writes to this good:
+		//1. gather_orders() concatenates the order buffers in buffer order into the order book columns,
+		//   so the order sequence doesn't depend on thread timing,
+		//2. sum_order_block() for every block, blocks may be summed in parallel,
+		//3. execute_orders() reduces the block sums in block order and clears the market.
+		//The results are kept until publish_results().
+		static constexpr size_t ORDER_BLOCK_SIZE = 4096;
+		//country_count is also the index orders without a country are stored under
+		void gather_orders(const country_index_t country_count);
+		constexpr size_t get_order_block_count() const {
+			return sums_per_block.size();
+		}
+		//thread safe for different blocks
+		void sum_order_block(const size_t block_index);
+		static constexpr size_t VECTORS_FOR_EXECUTE_ORDERS = 1;
+		//The country maps have one entry per country plus one for orders without a country, all 0.
 		void execute_orders(
 			TypedSpan<country_index_t, fixed_point_t> reusable_country_map_0,
 			TypedSpan<country_index_t, fixed_point_t> reusable_country_map_1,
@@ -74,6 +148,8 @@ namespace OpenVic {
 				VECTORS_FOR_EXECUTE_ORDERS
 			> reusable_vectors
 		);
+		//Copies the results into the actors' result slots and clears the orders.
+		void publish_results();
 		void on_use_exponential_price_changes_changed();
 		void record_price_history();
 	};
@@ -11,6 +11,21 @@
 
 using namespace OpenVic;
 
+static constexpr size_t DAYS_OF_MARKET_HISTORY = 3 * 365;
+
+MarketInstance::MarketInstance(
+	ThreadPool& new_thread_pool,
+	CountryDefines const& new_country_defines,
+	GoodInstanceManager& new_good_instance_manager
+) : thread_pool { new_thread_pool },
+	country_defines { new_country_defines },
+	good_instance_manager { new_good_instance_manager },
+	market_history {
+		new_good_instance_manager.get_good_instances().size() * MARKET_SERIES_PER_GOOD,
+		DAYS_OF_MARKET_HISTORY
+	},
+	market_history_sample(market_history.get_series_count()) {}
+
 bool MarketInstance::get_is_available(const good_index_t good_index) const {
 	return good_instance_manager.get_good_instance_by_index(good_index)->get_is_available();
 }
@@ -33,22 +48,22 @@ GoodInstance const& MarketInstance::get_good_instance(const good_index_t good_in
 	return *good_instance_manager.get_good_instance_by_index(good_index);
 }
 
-void MarketInstance::place_buy_up_to_order(BuyUpToOrder&& buy_up_to_order) {
+void MarketInstance::place_buy_up_to_order(const std::size_t order_buffer_index, BuyUpToOrder&& buy_up_to_order) {
 	const good_index_t good_index = buy_up_to_order.good_index;
 	if (OV_unlikely(buy_up_to_order.max_quantity <= 0)) {
 		spdlog::error_s(
 			"Received BuyUpToOrder for {} with max quantity {}",
 			good_index, buy_up_to_order.max_quantity
 		);
-		buy_up_to_order.call_after_trade(BuyResult::no_purchase_result(good_index));
+		buy_up_to_order.set_result(BuyResult::no_purchase_result(good_index));
 		return;
 	}
 
 	GoodMarket& good_instance = *good_instance_manager.get_good_instance_by_index(good_index);
-	good_instance.add_buy_up_to_order(std::move(buy_up_to_order));
+	good_instance.add_buy_up_to_order(order_buffer_index, std::move(buy_up_to_order));
 }
 
-void MarketInstance::place_market_sell_order(MarketSellOrder&& market_sell_order, memory::vector<fixed_point_t>& reusable_vector) {
+void MarketInstance::place_market_sell_order(const std::size_t order_buffer_index, MarketSellOrder&& market_sell_order) {
 	const good_index_t good_index = market_sell_order.good_index;
 	const fixed_point_t quantity = market_sell_order.quantity;
 
@@ -57,28 +72,29 @@ void MarketInstance::place_market_sell_order(MarketSellOrder&& market_sell_order
 			"Received MarketSellOrder for {} with quantity {}",
 			good_index, quantity
 		);
-		market_sell_order.call_after_trade(SellResult::no_sales_result(good_index), reusable_vector);
+		market_sell_order.set_result(SellResult::no_sales_result(good_index));
 		return;
 	}
 
 	GoodMarket& good_instance = *good_instance_manager.get_good_instance_by_index(good_index);
 	if (good_instance.good_definition.is_money) {
-		market_sell_order.call_after_trade(
-			{
-				market_sell_order.good_index,
-				quantity,
-				quantity * country_defines.get_gold_to_worker_pay_rate() * good_instance.good_definition.base_price
-			},
-			reusable_vector
-		);
+		market_sell_order.set_result({
+			market_sell_order.good_index,
+			quantity,
+			quantity * country_defines.get_gold_to_worker_pay_rate() * good_instance.good_definition.base_price
+		});
 		return;
 	}
 
-	good_instance.add_market_sell_order(std::move(market_sell_order));
+	good_instance.add_market_sell_order(order_buffer_index, std::move(market_sell_order));
 }
 
 void MarketInstance::execute_orders() {
 	thread_pool.process_good_execute_orders();
+	//actors only get their results while goods execute, each bundle then applies them for its own actors, one actor type
+	//at a time. RGOs pay their owners' deferred income, so they settle before the pops do.
+	thread_pool.process_country_and_rgo_settle_trades();
+	thread_pool.process_province_settle_pop_trades();
 }
 
 void MarketInstance::record_price_history() {
@@ -86,3 +102,16 @@ void MarketInstance::record_price_history() {
 		good_instance.record_price_history();
 	}
 }
+
+void MarketInstance::record_market_history(const Date today) {
+	using enum market_series_t;
+
+	for (GoodInstance const& good_instance : good_instance_manager.get_good_instances()) {
+		const good_index_t good_index = good_instance.index;
+		market_history_sample[get_market_series_index(good_index, PRICE)] = good_instance.get_price();
+		market_history_sample[get_market_series_index(good_index, SUPPLY)] = good_instance.get_total_supply_yesterday();
+		market_history_sample[get_market_series_index(good_index, DEMAND)] = good_instance.get_total_demand_yesterday();
+		market_history_sample[get_market_series_index(good_index, QUANTITY_TRADED)] = good_instance.get_quantity_traded_yesterday();
+	}
+	market_history.push_sample(today, market_history_sample);
+}
@@ -1,8 +1,16 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+#include <type_safe/strong_typedef.hpp>
+
 #include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TimeSeriesStore.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
 	struct BuyUpToOrder;
@@ -13,27 +21,40 @@ namespace OpenVic {
 	struct ThreadPool;
 
 	struct MarketInstance {
+		//Series recorded daily for every good in market_history.
+		enum struct market_series_t : uint8_t {
+			PRICE, SUPPLY, DEMAND, QUANTITY_TRADED
+		};
+		static constexpr std::size_t MARKET_SERIES_PER_GOOD = 4;
+
 	private:
 		ThreadPool& thread_pool;
 		CountryDefines const& country_defines;
 		GoodInstanceManager& good_instance_manager;
+		TimeSeriesStore PROPERTY(market_history);
+		//Reused by record_market_history
+		memory::vector<fixed_point_t> market_history_sample;
 	public:
-		constexpr MarketInstance(
+		MarketInstance(
 			ThreadPool& new_thread_pool,
 			CountryDefines const& new_country_defines,
 			GoodInstanceManager& new_good_instance_manager
-		) : thread_pool { new_thread_pool },
-			country_defines { new_country_defines },
-			good_instance_manager { new_good_instance_manager } {}
+		);
+
+		static constexpr std::size_t get_market_series_index(const good_index_t good_index, const market_series_t series) {
+			return type_safe::get(good_index) * MARKET_SERIES_PER_GOOD + static_cast<std::size_t>(series);
+		}
 
 		bool get_is_available(const good_index_t good_index) const;
 		fixed_point_t get_max_next_price(const good_index_t good_index) const;
 		fixed_point_t get_min_next_price(const good_index_t good_index) const;
 		fixed_point_t get_max_money_to_allocate_to_buy_quantity(const good_index_t good_index, const fixed_point_t quantity) const;
 		GoodInstance const& get_good_instance(const good_index_t good_index) const;
-		void place_buy_up_to_order(BuyUpToOrder&& buy_up_to_order);
-		void place_market_sell_order(MarketSellOrder&& market_sell_order, memory::vector<fixed_point_t>& reusable_vector);
+		//order_buffer_index is the index of the work bundle placing the order, see GoodMarket::ORDER_BUFFER_COUNT
+		void place_buy_up_to_order(const std::size_t order_buffer_index, BuyUpToOrder&& buy_up_to_order);
+		void place_market_sell_order(const std::size_t order_buffer_index, MarketSellOrder&& market_sell_order);
 		void execute_orders();
 		void record_price_history();
+		void record_market_history(const Date today);
 	};
 }
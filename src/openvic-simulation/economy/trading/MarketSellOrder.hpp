@@ -8,12 +8,11 @@
 
 namespace OpenVic {
 	struct GoodMarketSellOrder {
-		using actor_t = void*;
-		using callback_t = void (*)(actor_t, SellResult const&, memory::vector<fixed_point_t>&);
+		//owned by the actor placing the order, it applies the result itself once all goods are executed
+		using result_slot_t = std::optional<SellResult>*;
 
 	private:
-		const actor_t actor;
-		const callback_t after_trade;
+		const result_slot_t result_slot;
 
 	public:
 		const std::optional<country_index_t> country_index_optional;
@@ -22,16 +21,18 @@ namespace OpenVic {
 		constexpr GoodMarketSellOrder(
 			const std::optional<country_index_t> new_country_index_optional,
 			const fixed_point_t new_quantity,
-			const actor_t new_actor,
-			const callback_t new_after_trade
+			const result_slot_t new_result_slot
 		) : country_index_optional { new_country_index_optional },
 			quantity { new_quantity },
-			actor { new_actor },
-			after_trade { new_after_trade }
+			result_slot { new_result_slot }
 			{}
 
-		constexpr void call_after_trade(SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) const {
-			after_trade(actor, sell_result, reusable_vector);
+		constexpr result_slot_t get_result_slot() const {
+			return result_slot;
+		}
+
+		constexpr void set_result(SellResult const& sell_result) const {
+			result_slot->emplace(sell_result);
 		}
 	};
 
@@ -43,13 +44,11 @@ namespace OpenVic {
 			const good_index_t new_good_index,
 			const std::optional<country_index_t> new_country_index_optional,
 			const fixed_point_t new_quantity,
-			const actor_t new_actor,
-			const callback_t new_after_trade
+			const result_slot_t new_result_slot
 		) : GoodMarketSellOrder {
 				new_country_index_optional,
 				new_quantity,
-				new_actor,
-				new_after_trade
+				new_result_slot
 			},
 			good_index { new_good_index }
 			{}
@@ -5,20 +5,110 @@
 
 using namespace OpenVic::ecs;
 
-EcsThreadPool::EcsThreadPool(uint32_t worker_count) {
-	uint32_t const n = std::max<uint32_t>(1u, worker_count);
-	workers_.reserve(n);
-	for (uint32_t i = 0; i < n; ++i) {
+namespace {
+	// Identity of the pool worker running on this thread, if any. Lets a body that
+	// dispatches again keep using its own deque instead of queueing as an external caller.
+	thread_local EcsThreadPool const* current_pool = nullptr;
+	thread_local uint32_t current_worker_id = 0;
+
+	struct ScopedWorkerIdentity {
+		EcsThreadPool const* previous_pool;
+		uint32_t previous_worker_id;
+
+		ScopedWorkerIdentity(EcsThreadPool const* pool, uint32_t worker_id)
+			: previous_pool { current_pool }, previous_worker_id { current_worker_id } {
+			current_pool = pool;
+			current_worker_id = worker_id;
+		}
+
+		~ScopedWorkerIdentity() {
+			current_pool = previous_pool;
+			current_worker_id = previous_worker_id;
+		}
+	};
+}
+
+bool EcsThreadPool::WorkStealingDeque::push(Task* task) {
+	std::int64_t const bottom = bottom_.load(std::memory_order_relaxed);
+	std::int64_t const top = top_.load(std::memory_order_acquire);
+	if (bottom - top >= static_cast<std::int64_t>(CAPACITY)) {
+		return false;
+	}
+	slots_[static_cast<std::size_t>(bottom) & MASK].store(task, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom_.store(bottom + 1, std::memory_order_relaxed);
+	return true;
+}
+
+EcsThreadPool::Task* EcsThreadPool::WorkStealingDeque::pop() {
+	std::int64_t const bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	bottom_.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::int64_t top = top_.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		// Empty.
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Task* task = slots_[static_cast<std::size_t>(bottom) & MASK].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// Last element — race thieves for it.
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			task = nullptr;
+		}
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return task;
+}
+
+EcsThreadPool::Task* EcsThreadPool::WorkStealingDeque::steal() {
+	std::int64_t top = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::int64_t const bottom = bottom_.load(std::memory_order_acquire);
+	if (top >= bottom) {
+		return nullptr;
+	}
+
+	Task* const task = slots_[static_cast<std::size_t>(top) & MASK].load(std::memory_order_acquire);
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return nullptr;
+	}
+	return task;
+}
+
+EcsThreadPool::EcsThreadPool(uint32_t worker_count) : worker_count_ { std::max<uint32_t>(1u, worker_count) } {
+	deques_.reserve(worker_count_);
+	for (uint32_t i = 0; i < worker_count_; ++i) {
+		deques_.push_back(std::make_unique<WorkStealingDeque>());
+	}
+	// Worker 0 is whichever thread dispatches; only the helpers get their own thread.
+	workers_.reserve(worker_count_ - 1);
+	for (uint32_t i = 1; i < worker_count_; ++i) {
 		workers_.emplace_back([this, i]() { worker_loop(i); });
 	}
 }
 
+uint32_t EcsThreadPool::default_worker_count() noexcept {
+	return std::max<uint32_t>(1u, static_cast<uint32_t>(std::thread::hardware_concurrency()));
+}
+
+uint32_t EcsThreadPool::this_worker_id() noexcept {
+	return current_worker_id;
+}
+
+bool EcsThreadPool::is_calling_thread_worker() const noexcept {
+	return current_pool == this;
+}
+
 EcsThreadPool::~EcsThreadPool() {
 	{
-		std::lock_guard<std::mutex> lock(queue_mutex_);
-		stop_ = true;
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		stop_.store(true, std::memory_order_relaxed);
+		++work_epoch_;
 	}
-	cv_.notify_all();
+	sleep_cv_.notify_all();
 	for (std::thread& t : workers_) {
 		if (t.joinable()) {
 			t.join();
@@ -26,78 +116,141 @@ EcsThreadPool::~EcsThreadPool() {
 	}
 }
 
+void EcsThreadPool::wake_one_worker() {
+	// Pairs with the fence in worker_loop: either we see the sleeper's increment, or the
+	// sleeper's re-check after incrementing sees the task we just pushed.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleeping_workers_.load(std::memory_order_relaxed) == 0) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex_);
+		++work_epoch_;
+	}
+	sleep_cv_.notify_one();
+}
+
+EcsThreadPool::Task* EcsThreadPool::find_task(uint32_t worker_id) {
+	if (Task* const task = deques_[worker_id]->pop()) {
+		return task;
+	}
+	for (uint32_t offset = 1; offset < worker_count_; ++offset) {
+		if (Task* const task = deques_[(worker_id + offset) % worker_count_]->steal()) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+void EcsThreadPool::execute_task(Task& task, uint32_t worker_id) {
+	DispatchState& dispatch = *task.dispatch;
+	std::size_t const begin = task.begin;
+	std::size_t end = task.end;
+
+	// Lazy binary splitting: hand the upper half to thieves until the batch is small
+	// enough. Running out of slots or deque space just means a bigger batch here.
+	while (end - begin > dispatch.grain) {
+		std::size_t const slot = dispatch.next_task_slot.fetch_add(1, std::memory_order_relaxed);
+		if (slot >= dispatch.task_slot_count) {
+			break;
+		}
+		std::size_t const mid = begin + (end - begin) / 2;
+		Task& split = dispatch.task_slots[slot];
+		split = Task { &dispatch, mid, end };
+		if (!deques_[worker_id]->push(&split)) {
+			break;
+		}
+		wake_one_worker();
+		end = mid;
+	}
+
+	dispatch.range_fn(dispatch.body, begin, end, worker_id);
+
+	// Last access to `dispatch` — it may be destroyed as soon as this reaches 0.
+	dispatch.remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+}
+
 void EcsThreadPool::worker_loop(uint32_t worker_id) {
+	ScopedWorkerIdentity const identity { this, worker_id };
 	for (;;) {
-		Job job;
-		bool have_job = false;
-		{
-			std::unique_lock<std::mutex> lock(queue_mutex_);
-			cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
-			if (stop_ && queue_.empty()) {
-				return;
-			}
-			if (!queue_.empty()) {
-				job = std::move(queue_.back());
-				queue_.pop_back();
-				have_job = true;
-			}
-		}
-		if (!have_job) {
+		if (Task* const task = find_task(worker_id)) {
+			execute_task(*task, worker_id);
 			continue;
 		}
 
-		if (job.parallel_body != nullptr) {
-			(*job.parallel_body)(job.chunk_idx, worker_id);
-		} else if (job.concurrent_body) {
-			job.concurrent_body();
+		std::unique_lock<std::mutex> lock(sleep_mutex_);
+		if (stop_.load(std::memory_order_relaxed)) {
+			return;
 		}
+		std::uint64_t const epoch = work_epoch_;
+		sleeping_workers_.fetch_add(1, std::memory_order_relaxed);
+		lock.unlock();
 
-		// Decrement the dispatch's own DoneState under its mutex so the caller's
-		// predicate (evaluated under the same mutex inside cv.wait) cannot observe
-		// count == 0 until the decrement-and-notify sequence has completed — that
-		// is what allows the caller's DoneState to live on the caller's stack
-		// without lifetime races.
-		DoneState* const done = job.done;
-		std::lock_guard<std::mutex> lock(done->mutex);
-		--done->count;
-		if (done->count == 0) {
-			done->cv.notify_all();
+		// Re-check after announcing ourselves so a push that missed the increment is not lost.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (Task* const task = find_task(worker_id)) {
+			sleeping_workers_.fetch_sub(1, std::memory_order_relaxed);
+			execute_task(*task, worker_id);
+			continue;
 		}
+
+		lock.lock();
+		sleep_cv_.wait(lock, [this, epoch]() {
+			return stop_.load(std::memory_order_relaxed) || work_epoch_ != epoch;
+		});
+		sleeping_workers_.fetch_sub(1, std::memory_order_relaxed);
 	}
 }
 
-void EcsThreadPool::run_parallel_for_impl(std::size_t chunk_count, ParallelForBody body) {
-	// Per-call DoneState — separate counter+CV for each dispatch lets a System
-	// dispatched via run_concurrent itself call parallel_for without trampling the
-	// outer dispatch's accounting. Lives on this stack frame; workers hold its
-	// mutex while decrementing so we cannot return (and destroy it) until the
-	// last worker has fully released the mutex.
-	DoneState done;
-	done.count = chunk_count;
+void EcsThreadPool::dispatch_as_worker(DispatchState& dispatch, std::size_t chunk_count, uint32_t worker_id) {
+	Task root { &dispatch, 0, chunk_count };
+	if (deques_[worker_id]->push(&root)) {
+		wake_one_worker();
+	} else {
+		// Own deque is full (deeply nested dispatch) — start on the range directly.
+		execute_task(root, worker_id);
+	}
 
-	// Push every chunk index as a separate Job into the queue. The `body` lives on the
-	// caller's stack for the duration of this call; jobs hold a non-owning pointer to it.
-	{
-		std::lock_guard<std::mutex> lock(queue_mutex_);
-		queue_.reserve(queue_.size() + chunk_count);
-		for (std::size_t i = 0; i < chunk_count; ++i) {
-			Job j;
-			j.parallel_body = &body;
-			j.chunk_idx = i;
-			j.done = &done;
-			queue_.push_back(std::move(j));
+	// Help until every chunk of this dispatch has run. Tasks of other dispatches found
+	// on the way are run too; they finish independently of ours.
+	while (dispatch.remaining.load(std::memory_order_acquire) != 0) {
+		if (Task* const task = find_task(worker_id)) {
+			execute_task(*task, worker_id);
+		} else {
+			std::this_thread::yield();
 		}
 	}
-	cv_.notify_all();
+}
 
-	// Wait until every job has decremented its way down to zero. Predicate is
-	// evaluated under done.mutex (cv.wait acquires it), serialising with the
-	// worker_loop decrement-under-lock above.
-	{
-		std::unique_lock<std::mutex> lock(done.mutex);
-		done.cv.wait(lock, [&done]() {
-			return done.count == 0;
-		});
+void EcsThreadPool::run_parallel_for_impl(std::size_t chunk_count, std::size_t grain, void* body, RangeFn range_fn) {
+	// Each split creates one task and stops at `grain`, so ~2 * chunk_count / grain
+	// slots cover the whole tree; a shortfall only makes batches bigger.
+	std::vector<Task> task_slots(std::min(chunk_count, 2 * (chunk_count / grain + 1)));
+
+	DispatchState dispatch;
+	dispatch.range_fn = range_fn;
+	dispatch.body = body;
+	dispatch.grain = grain;
+	dispatch.remaining.store(chunk_count, std::memory_order_relaxed);
+	dispatch.task_slots = task_slots.data();
+	dispatch.task_slot_count = task_slots.size();
+
+	if (current_pool == this) {
+		dispatch_as_worker(dispatch, chunk_count, current_worker_id);
+	} else {
+		std::lock_guard<std::mutex> lock(external_caller_mutex_);
+		ScopedWorkerIdentity const identity { this, 0 };
+		dispatch_as_worker(dispatch, chunk_count, 0);
+	}
+}
+
+void EcsThreadPool::run_serial_impl(std::size_t chunk_count, void* body, RangeFn range_fn) {
+	if (current_pool == this) {
+		range_fn(body, 0, chunk_count, current_worker_id);
+	} else {
+		std::lock_guard<std::mutex> lock(external_caller_mutex_);
+		ScopedWorkerIdentity const identity { this, 0 };
+		range_fn(body, 0, chunk_count, 0);
 	}
 }
 
@@ -105,30 +258,17 @@ void EcsThreadPool::run_concurrent(std::span<std::function<void()> const> bodies
 	if (bodies.empty()) {
 		return;
 	}
-	if (workers_.size() <= 1 || bodies.size() == 1) {
-		for (auto const& fn : bodies) {
-			fn();
+	RangeFn const range_fn = [](void* erased_bodies, std::size_t begin, std::size_t end, uint32_t /*worker_id*/) {
+		std::span<std::function<void()> const> const& typed_bodies =
+			*static_cast<std::span<std::function<void()> const>*>(erased_bodies);
+		for (std::size_t i = begin; i < end; ++i) {
+			typed_bodies[i]();
 		}
+	};
+	if (worker_count_ <= 1 || bodies.size() == 1) {
+		run_serial_impl(bodies.size(), static_cast<void*>(&bodies), range_fn);
 		return;
 	}
-	DoneState done;
-	done.count = bodies.size();
-
-	{
-		std::lock_guard<std::mutex> lock(queue_mutex_);
-		queue_.reserve(queue_.size() + bodies.size());
-		for (auto const& fn : bodies) {
-			Job j;
-			j.concurrent_body = fn; // copy
-			j.done = &done;
-			queue_.push_back(std::move(j));
-		}
-	}
-	cv_.notify_all();
-	{
-		std::unique_lock<std::mutex> lock(done.mutex);
-		done.cv.wait(lock, [&done]() {
-			return done.count == 0;
-		});
-	}
+	// Grain 1: each function is its own batch so long systems can land on different workers.
+	run_parallel_for_impl(bodies.size(), 1, static_cast<void*>(&bodies), range_fn);
 }
@@ -1,25 +1,40 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace OpenVic::ecs {
-	// Dedicated thread pool for ECS scheduler dispatch. Intentionally separate from
-	// `OpenVic::ThreadPool` (which serves un-migrated production-tick / market-clearing
-	// code with a different work-bundle shape) so neither side disturbs the other.
+	// Thread pool for ECS scheduler dispatch. It is also the executor behind
+	// `OpenVic::ThreadPool` (un-migrated production-tick / market-clearing code): the
+	// InstanceManager owns one pool and lends it to its ThreadPool, and a World given it
+	// through `World::set_shared_thread_pool` runs its systems on the same workers instead
+	// of oversubscribing the cores with a pool of its own.
 	//
 	// Workers are numbered 0..worker_count-1 with stable identities; each worker passes
 	// its `worker_id` to the body it executes. ECS callers do not depend on worker_id
 	// for determinism — per-chunk CommandBuffers are keyed by chunk_idx, not worker_id —
 	// but it is exposed for diagnostic or thread-local-scratch uses.
 	//
+	// Scheduling: every worker owns a Chase-Lev deque. A dispatch pushes a single task
+	// covering the whole range; whoever runs a task keeps halving it, pushing the upper
+	// half onto its own deque, until it is at most `grain` chunks long, then runs that
+	// batch through one indirect call. Idle workers steal from the top of other deques.
+	// The calling thread is worker 0 and helps until its dispatch has finished, so the
+	// pool spawns worker_count - 1 threads. Only one external thread can act as worker 0
+	// at a time; others block until it is free. Nested dispatch from inside a body reuses
+	// the current worker's identity and deque.
+	//
 	// Hard invariants:
 	//   * `parallel_for` is blocking — does not return until every chunk's body has run.
 	//   * `run_concurrent` is blocking — does not return until every supplied function
@@ -39,9 +54,21 @@ namespace OpenVic::ecs {
 		EcsThreadPool& operator=(EcsThreadPool&&) = delete;
 
 		uint32_t worker_count() const noexcept {
-			return static_cast<uint32_t>(workers_.size());
+			return worker_count_;
 		}
 
+		// hardware_concurrency, or 1 if it is unknown.
+		static uint32_t default_worker_count() noexcept;
+
+		// Id of the worker running on the calling thread, 0 on any thread outside a dispatch
+		// (an external caller acts as worker 0 while it dispatches).
+		static uint32_t this_worker_id() noexcept;
+
+		// Whether the calling thread is one of this pool's workers, including an external
+		// caller while it acts as worker 0. this_worker_id() only indexes this pool's
+		// workers when this is true.
+		bool is_calling_thread_worker() const noexcept;
+
 		// Run body(chunk_idx, worker_id) for every chunk_idx in [0, chunk_count). Blocking.
 		// The internal scheduling strategy (work-queue, modulo, stealing) is opaque and
 		// deliberately not exposed — the only externally observable property is "every
@@ -51,17 +78,21 @@ namespace OpenVic::ecs {
 			if (chunk_count == 0) {
 				return;
 			}
-			if (workers_.size() <= 1 || chunk_count == 1) {
-				// Fast path: single-thread fall-through. Same observable behaviour as the
-				// parallel path; saves the queue/cv overhead in degenerate cases.
-				for (std::size_t i = 0; i < chunk_count; ++i) {
-					body(i, /*worker_id=*/0u);
+			using body_t = std::remove_reference_t<Body>;
+			void* const erased_body = const_cast<void*>(static_cast<void const*>(std::addressof(body)));
+			RangeFn const range_fn = [](void* range_body, std::size_t begin, std::size_t end, uint32_t worker_id) {
+				body_t& typed_body = *static_cast<body_t*>(range_body);
+				for (std::size_t i = begin; i < end; ++i) {
+					typed_body(i, worker_id);
 				}
+			};
+			if (worker_count_ <= 1 || chunk_count == 1) {
+				// Fast path: single-thread fall-through. Same observable behaviour as the
+				// parallel path; saves the deque/wake-up overhead in degenerate cases.
+				run_serial_impl(chunk_count, erased_body, range_fn);
 				return;
 			}
-			run_parallel_for_impl(chunk_count, [&body](std::size_t chunk_idx, uint32_t worker_id) {
-				body(chunk_idx, worker_id);
-			});
+			run_parallel_for_impl(chunk_count, default_grain(chunk_count), erased_body, range_fn);
 		}
 
 		// Run each supplied function exactly once across the pool — used for inter-system
@@ -69,45 +100,84 @@ namespace OpenVic::ecs {
 		void run_concurrent(std::span<std::function<void()> const> bodies);
 
 	private:
-		// Type-erased body for parallel_for. Templated wrapper above forwards to this.
-		using ParallelForBody = std::function<void(std::size_t /*chunk_idx*/, uint32_t /*worker_id*/)>;
-
-		// Per-call completion tracker. Stored on the caller's stack inside parallel_for /
-		// run_concurrent and pointed-to by every Job that dispatch submits. Workers
-		// decrement the *job's* DoneState — not a shared pool counter — so a System
-		// dispatched via run_concurrent can itself call parallel_for without the inner
-		// dispatch corrupting the outer dispatch's accounting (pre-fix, both used a
-		// single pool-wide `remaining_` atomic, which caused spurious wakeups and
-		// SIZE_MAX underflow when a `SystemThreaded` shared a stage with another System).
-		// Lifetime is enforced by the worker taking `done->mutex` while decrementing
-		// `done->count` — the caller's `done.cv.wait` predicate is also evaluated under
-		// the same mutex, so the caller can't return (and destroy the DoneState) until
-		// the decrement-and-notify sequence has completed.
-		struct DoneState {
-			std::mutex mutex;
-			std::condition_variable cv;
-			std::size_t count = 0; // Always touched while holding `mutex`.
+		// Runs chunks [begin, end) of a dispatch. One call per batch, not per chunk.
+		using RangeFn = void (*)(void* body, std::size_t begin, std::size_t end, uint32_t worker_id);
+
+		struct DispatchState;
+
+		// A contiguous range of one dispatch. Plain data; storage is preallocated per
+		// dispatch on the caller's stack frame, deques only hold pointers.
+		struct Task {
+			DispatchState* dispatch = nullptr;
+			std::size_t begin = 0;
+			std::size_t end = 0;
 		};
 
-		void run_parallel_for_impl(std::size_t chunk_count, ParallelForBody body);
+		// Per-call state, lives on the dispatching frame. `remaining` counts chunks that
+		// have not finished yet; the dispatcher does not return before it reaches 0 and a
+		// worker never touches the state again after its own decrement, so every dispatch
+		// (including one nested inside a run_concurrent body) has independent accounting.
+		struct DispatchState {
+			RangeFn range_fn = nullptr;
+			void* body = nullptr;
+			std::size_t grain = 1;
+			std::atomic<std::size_t> remaining { 0 };
+			Task* task_slots = nullptr;
+			std::size_t task_slot_count = 0;
+			std::atomic<std::size_t> next_task_slot { 0 };
+		};
 
-		void worker_loop(uint32_t worker_id);
+		// Fixed-capacity Chase-Lev deque (Lê et al., "Correct and Efficient Work-Stealing
+		// for Weak Memory Models"). push/pop from the owning worker only, steal from anyone.
+		// A full deque rejects the push and the owner simply keeps the range for itself.
+		class WorkStealingDeque {
+		public:
+			static constexpr std::size_t CAPACITY = 1024;
 
-		std::vector<std::thread> workers_;
+			bool push(Task* task);
+			Task* pop();
+			Task* steal();
 
-		// Work item: either a parallel_for slice or a run_concurrent function.
-		struct Job {
-			// For parallel_for: pointer-back to the shared body + the chunk_idx assigned
-			// to this job. For run_concurrent: a one-shot function to invoke; chunk_idx is 0.
-			ParallelForBody const* parallel_body = nullptr; // borrowed; lives on caller stack
-			std::function<void()> concurrent_body; // owned
-			std::size_t chunk_idx = 0;
-			DoneState* done = nullptr; // borrowed; lives on caller stack until count hits 0
+		private:
+			static constexpr std::size_t MASK = CAPACITY - 1;
+			static_assert((CAPACITY & MASK) == 0, "CAPACITY must be a power of two");
+
+			alignas(64) std::atomic<std::int64_t> top_ { 0 };
+			alignas(64) std::atomic<std::int64_t> bottom_ { 0 };
+			alignas(64) std::array<std::atomic<Task*>, CAPACITY> slots_ {};
 		};
 
-		std::mutex queue_mutex_;
-		std::condition_variable cv_;
-		std::vector<Job> queue_; // FIFO; back-popped under queue_mutex_
-		bool stop_ = false;
+		// Batch size for a parallel_for of chunk_count chunks — about eight batches per
+		// worker so stealing can even out uneven chunks without per-chunk overhead.
+		std::size_t default_grain(std::size_t chunk_count) const noexcept {
+			return std::max<std::size_t>(1, chunk_count / (static_cast<std::size_t>(worker_count_) * 8));
+		}
+
+		void run_parallel_for_impl(std::size_t chunk_count, std::size_t grain, void* body, RangeFn range_fn);
+		// Runs every chunk on the calling thread under its worker identity, like a dispatch
+		// that nobody helps with.
+		void run_serial_impl(std::size_t chunk_count, void* body, RangeFn range_fn);
+		void dispatch_as_worker(DispatchState& dispatch, std::size_t chunk_count, uint32_t worker_id);
+
+		void execute_task(Task& task, uint32_t worker_id);
+		Task* find_task(uint32_t worker_id);
+		void wake_one_worker();
+
+		void worker_loop(uint32_t worker_id);
+
+		uint32_t worker_count_ = 1;
+		std::vector<std::unique_ptr<WorkStealingDeque>> deques_; // one per worker, index == worker_id
+		std::vector<std::thread> workers_; // worker_id 1..worker_count-1; worker 0 is the caller
+
+		// Serialises external callers acting as worker 0.
+		std::mutex external_caller_mutex_;
+
+		// Sleep/wake for idle workers. `work_epoch_` is bumped under `sleep_mutex_` whenever
+		// a sleeper may have missed new work; `sleeping_workers_` lets pushers skip the lock.
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_cv_;
+		std::uint64_t work_epoch_ = 0; // Always touched while holding `sleep_mutex_`.
+		std::atomic<uint32_t> sleeping_workers_ { 0 };
+		std::atomic<bool> stop_ { false };
 	};
 }
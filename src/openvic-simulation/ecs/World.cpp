@@ -4,7 +4,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <string_view>
-#include <thread>
 #include <utility>
 
 #include "openvic-simulation/ecs/CommandBuffer.hpp"
@@ -811,15 +810,20 @@ void World::set_ecs_worker_count(uint32_t count) {
 	ecs_thread_pool_.reset();
 }
 
+void World::set_shared_thread_pool(EcsThreadPool* pool) {
+	shared_thread_pool_ = pool;
+	// Drop the private workers; they would only sit idle next to the shared ones.
+	ecs_thread_pool_.reset();
+}
+
 EcsThreadPool& World::ecs_thread_pool() {
+	if (shared_thread_pool_ != nullptr) {
+		return *shared_thread_pool_;
+	}
 	if (!ecs_thread_pool_) {
 		uint32_t n = ecs_worker_count_;
 		if (n == 0) {
-			uint32_t hw = static_cast<uint32_t>(std::thread::hardware_concurrency());
-			if (hw == 0) {
-				hw = 1;
-			}
-			n = std::min<uint32_t>(hw, 16u);
+			n = std::min<uint32_t>(EcsThreadPool::default_worker_count(), 16u);
 		}
 		ecs_thread_pool_ = std::make_unique<EcsThreadPool>(n);
 	}
@@ -364,10 +364,15 @@ namespace OpenVic::ecs {
 		// to validate "parallel result == serial result". Default false.
 		void set_serial_mode(bool enabled);
 
-		// Returns the EcsThreadPool used by the scheduler. Lazily constructed with the
-		// default worker count on first access.
+		// Returns the EcsThreadPool used by the scheduler: the shared pool if one was set,
+		// otherwise an owned pool lazily constructed with the default worker count.
 		EcsThreadPool& ecs_thread_pool();
 
+		// Dispatch onto a pool owned by someone else (the InstanceManager's executor) instead
+		// of spinning up a private one. The pool must outlive this World. nullptr goes back
+		// to the owned pool. Call before the first `tick_systems` invocation.
+		void set_shared_thread_pool(EcsThreadPool* pool);
+
 		// Pointer to the SystemRegistration currently being driven by the scheduler.
 		// Used by SystemThreaded::tick_all to access its pending_cmd. Returns nullptr
 		// outside `tick_systems` execution.
@@ -523,7 +528,7 @@ namespace OpenVic::ecs {
 		World& operator=(World&&) = delete;
 
 		// Override the ECS worker count. Call before the first `tick_systems` invocation.
-		// 0 → defaults to hw_concurrency, capped at 16.
+		// 0 → defaults to hw_concurrency, capped at 16. Ignored while a shared pool is set.
 		void set_ecs_worker_count(uint32_t count);
 
 		// Direct access to the per-World chunk pool. Tests use this to inspect pool state
@@ -590,6 +595,8 @@ namespace OpenVic::ecs {
 
 		// EcsThreadPool — owned. Lazily constructed on first `ecs_thread_pool()` access.
 		std::unique_ptr<EcsThreadPool> ecs_thread_pool_;
+		// Borrowed pool; takes precedence over `ecs_thread_pool_` when set.
+		EcsThreadPool* shared_thread_pool_ = nullptr;
 		uint32_t ecs_worker_count_ = 0; // 0 = use default at construction time
 
 		// Scheduler — owned. Lazily constructed on first `tick_systems`. Holds the DAG
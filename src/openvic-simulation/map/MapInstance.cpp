@@ -1,9 +1,14 @@
 #include "MapInstance.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <tuple>
 
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/ecs/Reductions.hpp"
 #include "openvic-simulation/history/ProvinceHistory.hpp"
 #include "openvic-simulation/map/MapDefinition.hpp"
 #include "openvic-simulation/politics/Reform.hpp"
@@ -145,32 +150,114 @@ bool MapInstance::apply_history_to_provinces(
 	return ret;
 }
 
-void MapInstance::update_modifier_sums(const Date today, StaticModifierCache const& static_modifier_cache) {
-	for (ProvinceInstance& province : get_province_instances()) {
-		province.update_modifier_sum(today, static_modifier_cache);
+void MapInstance::update_modifier_sums(
+	StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sums
+) {
+	ecs::EcsThreadPool& executor = thread_pool.get_executor();
+	forwardable_span<ProvinceInstance> provinces = get_province_instances();
+
+	//provinces only write to their own sum, most days nothing changed and there is nothing to do
+	executor.parallel_for(
+		provinces.size(),
+		[&provinces, &static_modifier_cache, verify_modifier_sums](
+			const std::size_t province_index, const uint32_t /*worker_id*/
+		) -> void {
+			provinces[province_index].update_modifier_sum(static_modifier_cache, verify_modifier_sums);
+		}
+	);
+
+	//Group provinces by controller with a stable counting sort, then merge each controller's group in parallel.
+	//Every controller receives its provinces in province index order, exactly like a serial loop would.
+	std::size_t controller_bucket_count = 0;
+	for (ProvinceInstance const& province : provinces) {
+		CountryInstance const* const controller = province.get_controller();
+		if (controller != nullptr) {
+			controller_bucket_count = std::max(controller_bucket_count, type_safe::get(controller->index) + 1);
+		}
 	}
 
-	for (ProvinceInstance& province : get_province_instances()) {
-		province.update_country_modifier_sum();
+	controller_bucket_offsets.assign(controller_bucket_count + 1, 0);
+	for (ProvinceInstance const& province : provinces) {
+		CountryInstance const* const controller = province.get_controller();
+		if (controller != nullptr) {
+			++controller_bucket_offsets[type_safe::get(controller->index) + 1];
+		}
+	}
+	for (std::size_t bucket_index = 0; bucket_index < controller_bucket_count; ++bucket_index) {
+		controller_bucket_offsets[bucket_index + 1] += controller_bucket_offsets[bucket_index];
+	}
+
+	provinces_by_controller.resize(controller_bucket_offsets.back());
+	controller_bucket_cursors.assign(controller_bucket_offsets.begin(), controller_bucket_offsets.end() - 1);
+	for (ProvinceInstance& province : provinces) {
+		CountryInstance const* const controller = province.get_controller();
+		if (controller != nullptr) {
+			provinces_by_controller[controller_bucket_cursors[type_safe::get(controller->index)]++] = &province;
+		}
 	}
+
+	executor.parallel_for(
+		controller_bucket_count,
+		[this](const std::size_t bucket_index, const uint32_t /*worker_id*/) -> void {
+			for (
+				std::size_t i = controller_bucket_offsets[bucket_index];
+				i < controller_bucket_offsets[bucket_index + 1];
+				++i
+			) {
+				provinces_by_controller[i]->update_country_modifier_sum();
+			}
+		}
+	);
+}
+
+namespace {
+	struct population_totals_t {
+		pop_sum_t highest_province_population = 0;
+		pop_sum_t total_map_population = 0;
+
+		constexpr population_totals_t operator+(population_totals_t const& rhs) const {
+			return {
+				std::max(highest_province_population, rhs.highest_province_population),
+				total_map_population + rhs.total_map_population
+			};
+		}
+	};
 }
 
 void MapInstance::update_gamestate(InstanceManager const& instance_manager) {
-	highest_province_population = 0;
-	total_map_population = 0;
+	//provinces only write to themselves, neighbours are only checked for being empty which doesn't change here
+	static constexpr std::size_t PROVINCES_PER_CHUNK = 64;
+	forwardable_span<ProvinceInstance> provinces = get_province_instances();
+	const std::size_t chunk_count = (provinces.size() + PROVINCES_PER_CHUNK - 1) / PROVINCES_PER_CHUNK;
 
-	for (ProvinceInstance& province : get_province_instances()) {
-		province.update_gamestate(instance_manager);
+	//chunk totals are folded in chunk order so the result doesn't depend on the worker count
+	const population_totals_t population_totals = ecs::reductions::parallel_sum(
+		thread_pool.get_executor(),
+		chunk_count,
+		population_totals_t {},
+		[&provinces, &instance_manager](const std::size_t chunk_index) -> population_totals_t {
+			population_totals_t chunk_totals {};
+			const std::size_t end = std::min(provinces.size(), (chunk_index + 1) * PROVINCES_PER_CHUNK);
+			for (std::size_t i = chunk_index * PROVINCES_PER_CHUNK; i < end; ++i) {
+				ProvinceInstance& province = provinces[i];
+				province.update_gamestate(instance_manager);
+
+				// Update population stats
+				const pop_sum_t province_population = province.get_total_population();
+				if (chunk_totals.highest_province_population < province_population) {
+					chunk_totals.highest_province_population = province_population;
+				}
 
-		// Update population stats
-		const pop_sum_t province_population = province.get_total_population();
-		if (highest_province_population < province_population) {
-			highest_province_population = province_population;
+				chunk_totals.total_map_population += province_population;
+			}
+			return chunk_totals;
 		}
+	);
 
-		total_map_population += province_population;
-	}
-	state_manager.update_gamestate();
+	highest_province_population = population_totals.highest_province_population;
+	total_map_population = population_totals.total_map_population;
+
+	state_manager.update_gamestate(thread_pool.get_executor());
 }
 
 void MapInstance::map_tick() {
@@ -42,6 +42,12 @@ namespace OpenVic {
 		ArmyAStarPathing PROPERTY_REF(land_pathing);
 		NavyAStarPathing PROPERTY_REF(sea_pathing);
 
+		//reused by update_modifier_sums, provinces grouped by controller index in province order
+		//controller i's provinces are provinces_by_controller[controller_bucket_offsets[i], controller_bucket_offsets[i+1])
+		memory::vector<std::size_t> controller_bucket_offsets;
+		memory::vector<std::size_t> controller_bucket_cursors;
+		memory::vector<ProvinceInstance*> provinces_by_controller;
+
 	public:
 		MapInstance(
 			MapDefinition const& new_map_definition,
@@ -85,7 +91,9 @@ namespace OpenVic {
 			TypedSpan<reform_index_t, const Reform> reforms
 		);
 
-		void update_modifier_sums(const Date today, StaticModifierCache const& static_modifier_cache);
+		void update_modifier_sums(
+			StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sums
+		);
 		void update_gamestate(InstanceManager const& instance_manager);
 		void map_tick();
 		void initialise_for_new_game(InstanceManager const& instance_manager);
@@ -4,6 +4,7 @@
 
 #include <type_safe/strong_typedef.hpp>
 
+#include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/economy/BuildingType.hpp"
 #include "openvic-simulation/economy/GoodDefinition.hpp" // IWYU pragma: keep
@@ -12,9 +13,9 @@
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
 #include "openvic-simulation/population/Culture.hpp"
+#include "openvic-simulation/population/PopManager.hpp"
 #include "openvic-simulation/population/PopSum.hpp"
 #include "openvic-simulation/population/Religion.hpp"
-#include "openvic-simulation/types/OrderedContainersMath.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::colour_literals;
@@ -169,36 +170,60 @@ static constexpr auto get_colour_mapmode(
 	};
 }
 
-template<has_get_colour KeyType, typename ValueType>
-static constexpr Mapmode::base_stripe_t shaded_mapmode(
-	ordered_map<KeyType const*, ValueType> const& map
-) {
-	const auto largest = get_largest_two_items(map);
-	if (largest.first != map.end()) {
-		const colour_argb_t base_colour = colour_argb_t { largest.first->first->get_colour(), ALPHA_VALUE };
-		if (largest.second != map.end()) {
-			/* If second largest is at least a third... */
-			if (largest.second->second * 3 >= get_total(map)) {
-				const colour_argb_t stripe_colour = colour_argb_t { largest.second->first->get_colour(), ALPHA_VALUE };
-				return { base_colour, stripe_colour };
-			}
+// values[i] belongs to the item get_key(i) returns, zero values are ignored.
+template<typename IndexType, typename ValueType, typename GetKey>
+static constexpr Mapmode::base_stripe_t shaded_mapmode(TypedSpan<IndexType, const ValueType> values, GetKey const& get_key) {
+	const IndexType end = values.size();
+	IndexType largest = end, second_largest = end;
+	ValueType total {};
+
+	for (IndexType index {}; index < end; ++index) {
+		const ValueType value = values[index];
+		if (value == ValueType {}) {
+			continue;
+		}
+		total += value;
+		if (largest == end || value > values[largest]) {
+			second_largest = largest;
+			largest = index;
+		} else if (second_largest == end || value > values[second_largest]) {
+			second_largest = index;
 		}
-		return base_colour;
 	}
-	return colour_argb_t::null();
+
+	if (largest == end) {
+		return colour_argb_t::null();
+	}
+	has_get_colour auto const* const base_item = get_key(largest);
+	if (base_item == nullptr) {
+		return colour_argb_t::null();
+	}
+	const colour_argb_t base_colour = colour_argb_t { base_item->get_colour(), ALPHA_VALUE };
+	/* If second largest is at least a third... */
+	if (second_largest != end && values[second_largest] * 3 >= total) {
+		has_get_colour auto const* const stripe_item = get_key(second_largest);
+		if (stripe_item != nullptr) {
+			return { base_colour, colour_argb_t { stripe_item->get_colour(), ALPHA_VALUE } };
+		}
+	}
+	return base_colour;
 }
 
-template<has_get_colour KeyType, typename ValueType>
-static constexpr auto shaded_mapmode(ordered_map<KeyType const*, ValueType> const&(ProvinceInstance::*get_map)() const) {
-	return [get_map](
+template<typename IndexType, typename ValueType, typename GetKey>
+static constexpr auto shaded_mapmode(
+	TypedSpan<IndexType, const ValueType>(ProvinceInstance::*get_values)() const, GetKey get_key
+) {
+	return [get_values, get_key](
 		MapInstance const& map_instance, ProvinceInstance const& province,
 		CountryInstance const* player_country, ProvinceInstance const* selected_province
 	) -> Mapmode::base_stripe_t {
-		return shaded_mapmode((province.*get_map)());
+		return shaded_mapmode((province.*get_values)(), get_key);
 	};
 }
 
-bool MapmodeManager::setup_mapmodes(MapDefinition const& map_definition, BuildingTypeManager const& building_type_manager) {
+bool MapmodeManager::setup_mapmodes(
+	MapDefinition const& map_definition, BuildingTypeManager const& building_type_manager, PopManager const& pop_manager
+) {
 	if (mapmodes_are_locked()) {
 		spdlog::error_s("Cannot setup mapmodes - already locked!");
 		return false;
@@ -287,7 +312,14 @@ bool MapmodeManager::setup_mapmodes(MapDefinition const& map_definition, Buildin
 		},
 		"MAPMODE_12"
 	);
-	ret &= add_mapmode("mapmode_culture", shaded_mapmode<Culture,pop_sum_t>(&ProvinceInstance::get_population_by_culture), "MAPMODE_13");
+	// Cultures are loaded after mapmodes are set up, so they're looked up when the mapmode is drawn.
+	CultureManager const& culture_manager = pop_manager.get_culture_manager();
+	ret &= add_mapmode("mapmode_culture", shaded_mapmode<culture_index_t, pop_sum_t>(
+		&ProvinceInstance::get_population_by_culture,
+		[&culture_manager](const culture_index_t index) -> Culture const* {
+			return culture_manager.get_culture_by_index(index);
+		}
+	), "MAPMODE_13");
 	ret &= add_mapmode("mapmode_sphere", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_14");
 	ret &= add_mapmode("mapmode_supply", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_15");
 	ret &= add_mapmode("mapmode_party_loyalty", Mapmode::ERROR_MAPMODE.get_colour_func(), "MAPMODE_16");
@@ -342,7 +374,13 @@ bool MapmodeManager::setup_mapmodes(MapDefinition const& map_definition, Buildin
 				return colour_argb_t::fill_as(f).with_alpha(ALPHA_VALUE);
 			}
 		);
-		ret &= add_mapmode("mapmode_religion", shaded_mapmode<Religion, pop_sum_t>(&ProvinceInstance::get_population_by_religion));
+		ReligionManager const& religion_manager = pop_manager.get_religion_manager();
+		ret &= add_mapmode("mapmode_religion", shaded_mapmode<religion_index_t, pop_sum_t>(
+			&ProvinceInstance::get_population_by_religion,
+			[&religion_manager](const religion_index_t index) -> Religion const* {
+				return religion_manager.get_religion_by_index(index);
+			}
+		));
 		ret &= add_mapmode("mapmode_terrain_type", get_colour_mapmode(&ProvinceInstance::get_terrain_type));
 		ret &= add_mapmode(
 			"mapmode_adjacencies",
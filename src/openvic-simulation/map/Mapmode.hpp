@@ -17,6 +17,7 @@ namespace OpenVic {
 	struct MapmodeManager;
 	struct MapDefinition;
 	struct MapInstance;
+	struct PopManager;
 	struct ProvinceInstance;
 	struct CountryInstance;
 
@@ -86,6 +87,9 @@ namespace OpenVic {
 			uint8_t* target
 		) const;
 
-		bool setup_mapmodes(MapDefinition const& map_definition, BuildingTypeManager const& building_type_manager);
+		bool setup_mapmodes(
+			MapDefinition const& map_definition, BuildingTypeManager const& building_type_manager,
+			PopManager const& pop_manager
+		);
 	};
 }
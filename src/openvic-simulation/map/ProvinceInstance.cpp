@@ -2,7 +2,9 @@
 #include "ProvinceInstanceDeps.hpp"
 #include "population/PopsAggregateDeps.hpp"
 
+#include <algorithm>
 #include <type_traits>
+#include <utility>
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
@@ -32,7 +34,7 @@ ProvinceInstance::ProvinceInstance(
 	game_rules_manager { province_instance_deps.game_rules_manager },
 	terrain_type { new_province_definition.get_default_terrain_type() },
 	rgo { province_instance_deps.rgo_deps },
-	pops_cache_by_type { generate_values, province_instance_deps.pops_aggregate_deps.pop_type_count },
+	pops_by_type { province_instance_deps.pops_aggregate_deps.pop_type_count },
 	buildings {
 		new_province_definition.is_water()
 			? province_building_index_t(0)
@@ -198,6 +200,14 @@ bool ProvinceInstance::add_pop_vec(
 	}
 }
 
+Pop* ProvinceInstance::add_pop(PopBase const& pop_base, PopDeps const& pop_deps) {
+	if (province_definition.is_water()) {
+		spdlog::error_s("Trying to add pop to water province {}", *this);
+		return nullptr;
+	}
+	return &*pops.emplace(*this, pop_base, pop_deps, ++last_pop_id);
+}
+
 size_t ProvinceInstance::get_pop_count() const {
 	return pops.size();
 }
@@ -206,13 +216,8 @@ size_t ProvinceInstance::get_pop_count() const {
  * MAP-65, MAP-68, MAP-70, MAP-234
  */
 void ProvinceInstance::_update_pops(MilitaryDefines const& military_defines) {
-	clear_pops_aggregate();
-
 	has_unaccepted_pops = false;
-
-	for (memory::vector<std::reference_wrapper<Pop>>& pops_cache : pops_cache_by_type) {
-		pops_cache.clear();
-	}
+	pops_by_type.rebuild(pops);
 
 	using enum colony_status_t;
 
@@ -221,70 +226,126 @@ void ProvinceInstance::_update_pops(MilitaryDefines const& military_defines) {
 		: colony_status == COLONY ? military_defines.get_pop_size_per_regiment_colony_multiplier()
 		: is_owner_core() ? fixed_point_t::_1 : military_defines.get_pop_size_per_regiment_non_core_multiplier();
 
+	//keep last update's rows so only the pops that changed are re-aggregated
+	std::swap(pop_store, previous_pop_store);
+	pop_store.clear();
+	pop_store.reserve(pops.size());
+
 	for (Pop& pop : pops) {
-		pops_cache_by_type[pop.get_type().index].push_back(pop);
 		pop.update_gamestate(military_defines, owner, pop_size_per_regiment_multiplier);
-		add_pops_aggregate(pop);
+		pop_store.push_back(pop);
 		if (pop.get_culture_status() == Pop::culture_status_t::UNACCEPTED) {
 			has_unaccepted_pops = true;
 		}
 	}
 
-	normalise_pops_aggregate();
+	update_pops_aggregate(pop_store, previous_pop_store);
 }
 
-void ProvinceInstance::update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache) {
-	// Update sum of direct province modifiers
-	modifier_sum.clear();
-
+void ProvinceInstance::_add_modifier_sum_sources(
+	ModifierSum& target_sum, StaticModifierCache const& static_modifier_cache
+) const {
 	if (terrain_type != nullptr) {
-		modifier_sum.add_modifier(*terrain_type);
+		target_sum.add_modifier(*terrain_type);
 	}
 
 	if (province_definition.get_climate() != nullptr) {
-		modifier_sum.add_modifier(*province_definition.get_climate());
+		target_sum.add_modifier(*province_definition.get_climate());
 	}
 
 	if (province_definition.get_continent() != nullptr) {
-		modifier_sum.add_modifier(*province_definition.get_continent());
+		target_sum.add_modifier(*province_definition.get_continent());
 	}
 
 	// Add static modifiers
 	if (is_owner_core()) {
-		modifier_sum.add_modifier(static_modifier_cache.get_core());
+		target_sum.add_modifier(static_modifier_cache.get_core());
 	}
 	if (province_definition.is_water()) {
-		modifier_sum.add_modifier(static_modifier_cache.get_sea_zone());
+		target_sum.add_modifier(static_modifier_cache.get_sea_zone());
 	} else {
-		modifier_sum.add_modifier(static_modifier_cache.get_land_province());
+		target_sum.add_modifier(static_modifier_cache.get_land_province());
 
-		modifier_sum.add_modifier(
+		target_sum.add_modifier(
 			province_definition.is_coastal() ? static_modifier_cache.get_coastal() : static_modifier_cache.get_non_coastal()
 		);
 
 		// TODO - overseas, blockaded, no_adjacent_controlled, has_siege, occupied, nationalism, infrastructure
 	}
 
-	// Erase expired event modifiers and add non-expired ones to the sum
-	std::erase_if(event_modifiers, [this, today](ModifierInstance const& modifier) -> bool {
-		if (today <= modifier.get_expiry_date()) {
-			modifier_sum.add_modifier(*modifier.get_modifier());
-			return false;
-		} else {
-			return true;
-		}
-	});
+	for (ModifierInstance const& modifier : event_modifiers) {
+		target_sum.add_modifier(*modifier.get_modifier());
+	}
 
 	for (BuildingInstance const& building : buildings) {
-		modifier_sum.add_modifier(building.building_type);
+		target_sum.add_modifier(building.building_type);
 	}
 
 	if (crime != nullptr) {
-		modifier_sum.add_modifier(*crime);
+		target_sum.add_modifier(*crime);
 	}
+}
 
-	if (controller != nullptr) {
-		controller->make_room_for_province_modifier_sum(modifier_sum);
+void ProvinceInstance::add_event_modifier(Modifier const& modifier, const Date expiry_date) {
+	event_modifiers.emplace_back(modifier, expiry_date);
+	if (!is_modifier_sum_dirty) {
+		modifier_sum.add_modifier(modifier);
+	}
+}
+
+bool ProvinceInstance::expire_event_modifier(Modifier const& modifier, const Date expiry_date) {
+	const auto it = std::find_if(
+		event_modifiers.begin(), event_modifiers.end(),
+		[&modifier, expiry_date](ModifierInstance const& instance) -> bool {
+			return instance.get_modifier() == &modifier && instance.get_expiry_date() == expiry_date;
+		}
+	);
+	if (it == event_modifiers.end()) {
+		return false;
+	}
+
+	event_modifiers.erase(it);
+	if (!is_modifier_sum_dirty && !modifier_sum.remove_modifier(modifier)) {
+		is_modifier_sum_dirty = true;
+	}
+	return true;
+}
+
+void ProvinceInstance::update_modifier_sum(
+	StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sum
+) {
+	// Expired event modifiers have already been removed by the EventModifierExpiryQueue
+	const bool has_owner_core = is_owner_core();
+	if (
+		has_owner_core != modifier_sum_has_owner_core
+		|| terrain_type != modifier_sum_terrain_type
+		|| crime != modifier_sum_crime
+	) {
+		is_modifier_sum_dirty = true;
+	}
+
+	if (verify_modifier_sum && !is_modifier_sum_dirty) {
+		ModifierSum rebuilt_modifier_sum;
+		rebuilt_modifier_sum.set_this_source(this);
+		_add_modifier_sum_sources(rebuilt_modifier_sum, static_modifier_cache);
+
+		if (
+			rebuilt_modifier_sum.size() != modifier_sum.size()
+			|| !(rebuilt_modifier_sum.get_value_sum() == modifier_sum.get_value_sum())
+		) {
+			spdlog::error_s("Incremental modifier sum of province {} does not match a full rebuild!", *this);
+			is_modifier_sum_dirty = true;
+		}
+	}
+
+	if (is_modifier_sum_dirty) {
+		modifier_sum.clear();
+		_add_modifier_sum_sources(modifier_sum, static_modifier_cache);
+
+		modifier_sum_has_owner_core = has_owner_core;
+		modifier_sum_terrain_type = terrain_type;
+		modifier_sum_crime = crime;
+		is_modifier_sum_dirty = false;
 	}
 }
 
@@ -375,6 +436,7 @@ void ProvinceInstance::province_tick(
 	const Date today,
 	PopValuesFromProvince& reusable_pop_values,
 	RandomU32& random_number_generator,
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -391,6 +453,7 @@ void ProvinceInstance::province_tick(
 			pop.pop_tick(
 				reusable_pop_values,
 				random_number_generator,
+				order_buffer_index,
 				reusable_goods_mask,
 				reusable_vectors
 			);
@@ -400,7 +463,17 @@ void ProvinceInstance::province_tick(
 	for (BuildingInstance& building : buildings) {
 		building.tick(today);
 	}
-	rgo.rgo_tick(reusable_vectors[0]);
+	rgo.rgo_tick(order_buffer_index);
+}
+
+void ProvinceInstance::settle_rgo_trades(memory::vector<fixed_point_t>& reusable_vector) {
+	rgo.settle_trades(reusable_vector);
+}
+
+void ProvinceInstance::settle_pop_trades() {
+	for (Pop& pop : pops) {
+		pop.settle_trades();
+	}
 }
 
 bool ProvinceInstance::add_unit_instance_group(UnitInstanceGroup& group) {
@@ -506,6 +579,7 @@ void ProvinceInstance::initialise_for_new_game(
 	const Date today,
 	PopValuesFromProvince& reusable_pop_values,
 	RandomU32& random_number_generator,
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -517,6 +591,7 @@ void ProvinceInstance::initialise_for_new_game(
 		today,
 		reusable_pop_values,
 		random_number_generator,
+		order_buffer_index,
 		reusable_goods_mask,
 		reusable_vectors
 	);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 
 #include "openvic-simulation/core/memory/Colony.hpp"
@@ -15,6 +16,8 @@
 #include "openvic-simulation/population/Pop.hpp"
 #include "openvic-simulation/population/PopIdInProvince.hpp"
 #include "openvic-simulation/population/PopsAggregate.hpp"
+#include "openvic-simulation/population/PopsByType.hpp"
+#include "openvic-simulation/population/PopStore.hpp"
 #include "openvic-simulation/types/ColonyStatus.hpp"
 #include "openvic-simulation/types/FlagStrings.hpp"
 #include "openvic-simulation/types/HasIdentifier.hpp"
@@ -25,6 +28,8 @@
 
 namespace OpenVic {
 	struct BaseIssue;
+	template<typename... Holders>
+	struct BasicEventModifierExpiryQueue;
 	struct BuildingType;
 	struct CountryInstance;
 	struct CountryInstanceManager;
@@ -55,6 +60,8 @@ namespace OpenVic {
 		HasIndex<ProvinceInstance, province_index_t>,
 		FlagStrings,
 		PopsAggregate {
+		template<typename... Holders>
+		friend struct BasicEventModifierExpiryQueue;
 		friend struct MapInstance;
 
 		static constexpr std::string_view get_colony_status_string(colony_status_t colony_status) {
@@ -88,6 +95,18 @@ namespace OpenVic {
 		// The total/resultant modifier of local effects on this province (global effects come from the province's owner)
 		ModifierSum PROPERTY(modifier_sum);
 		memory::vector<ModifierInstance> SPAN_PROPERTY(event_modifiers);
+		// modifier_sum is only rebuilt when dirty, event modifiers are added to and removed from it directly.
+		// The sources the last rebuild used are kept so changes made through plain setters still mark it dirty.
+		bool is_modifier_sum_dirty = true;
+		bool modifier_sum_has_owner_core = false;
+		TerrainType const* modifier_sum_terrain_type = nullptr;
+		Crime const* modifier_sum_crime = nullptr;
+
+		void _add_modifier_sum_sources(ModifierSum& target_sum, StaticModifierCache const& static_modifier_cache) const;
+
+		// Only called by EventModifierExpiryQueue, which tracks when each event modifier expires
+		void add_event_modifier(Modifier const& modifier, const Date expiry_date);
+		bool expire_event_modifier(Modifier const& modifier, const Date expiry_date);
 
 		bool PROPERTY(slave, false);
 		// Used for "minorities = yes/no" condition
@@ -116,7 +135,11 @@ namespace OpenVic {
 
 	private:
 		pop_id_in_province_t last_pop_id{0};
-		memory::colony<Pop> PROPERTY(pops); // TODO - replace with a more easily vectorisable container?
+		memory::colony<Pop> PROPERTY(pops);
+		// Hot pop fields in columns, refilled by _update_pops.
+		PopStore PROPERTY_REF(pop_store);
+		// The rows pop_store had before the last update, the aggregate only re-adds rows that differ from these.
+		PopStore previous_pop_store;
 		void _update_pops(MilitaryDefines const& military_defines);
 		bool convert_rgo_worker_pops_to_equivalent(
 			TypedSpan<pop_type_index_t, const PopType> pop_types,
@@ -124,10 +147,8 @@ namespace OpenVic {
 		);
 		void initialise_rgo();
 
-		memory::FixedVector<
-			memory::vector<std::reference_wrapper<Pop>>,
-			pop_type_index_t
-		> SPAN_PROPERTY(pops_cache_by_type);
+		// Regrouped by _update_pops, pops created since then aren't included until the next update.
+		PopsByType PROPERTY(pops_by_type);
 	public:
 		ProvinceDefinition const& province_definition;
 
@@ -187,9 +208,18 @@ namespace OpenVic {
 			std::span<const PopBase> pop_vec,
 			PopDeps const& pop_deps
 		);
+		// Returns nullptr for water provinces
+		Pop* add_pop(PopBase const& pop_base, PopDeps const& pop_deps);
+		// Pops moved supporters in or out, maybe without changing size, so the next update re-sums them.
+		constexpr void mark_pop_supporters_changed() {
+			pop_supporters_changed = true;
+		}
 		size_t get_pop_count() const;
 
-		void update_modifier_sum(Date today, StaticModifierCache const& static_modifier_cache);
+		// verify_modifier_sum compares the incrementally maintained sum with a full rebuild
+		void update_modifier_sum(
+			StaticModifierCache const& static_modifier_cache, const bool verify_modifier_sum = false
+		);
 		void update_country_modifier_sum();
 		fixed_point_t get_modifier_effect_value(ModifierEffect const& effect) const;
 
@@ -206,24 +236,27 @@ namespace OpenVic {
 			}
 		}
 		void update_gamestate(InstanceManager const& instance_manager);
-		static constexpr size_t VECTORS_FOR_PROVINCE_TICK = std::max(
-			ResourceGatheringOperation::VECTORS_FOR_RGO_TICK,
-			Pop::VECTORS_FOR_POP_TICK
-		);
+		static constexpr size_t VECTORS_FOR_PROVINCE_TICK = Pop::VECTORS_FOR_POP_TICK;
 		void province_tick(
 			const Date today,
 			PopValuesFromProvince& reusable_pop_values,
 			RandomU32& random_number_generator,
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
 				VECTORS_FOR_PROVINCE_TICK
 			> reusable_vectors
 		);
+		//Apply this tick's trade results, once the market has executed the orders.
+		//The rgo pays its owners' deferred income, so it must settle before any pops in its state do.
+		void settle_rgo_trades(memory::vector<fixed_point_t>& reusable_vector);
+		void settle_pop_trades();
 		void initialise_for_new_game(
 			const Date today,
 			PopValuesFromProvince& reusable_pop_values,
 			RandomU32& random_number_generator,
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
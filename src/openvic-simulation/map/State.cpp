@@ -2,6 +2,7 @@
 
 #include "openvic-simulation/core/error/ErrorMacros.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
 #include "openvic-simulation/map/MapDefinition.hpp"
 #include "openvic-simulation/map/MapInstance.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
@@ -25,7 +26,7 @@ State::State(
 	capital { new_capital },
 	provinces { std::move(new_provinces) },
 	colony_status { new_colony_status },
-	pops_cache_by_type { generate_values, pops_aggregate_deps.pop_type_count }
+	pops_by_type { pops_aggregate_deps.pop_type_count }
 {
 	_update_country();
 }
@@ -46,32 +47,26 @@ CountryInstance* State::get_owner() const {
 }
 
 void State::update_gamestate() {
-	clear_pops_aggregate();
-
-	for (memory::vector<std::reference_wrapper<Pop>>& pops_cache : pops_cache_by_type) {
-		pops_cache.clear();
-	}
-
 	coastal = false;
-	for (ProvinceInstance& province : provinces) {
+	for (ProvinceInstance const& province : provinces) {
 		coastal |= province.province_definition.is_coastal();
-		add_pops_aggregate(province);
-
-		{
-			pop_type_index_t pop_type_index {};
-			for (auto const& province_pops_of_type : province.get_pops_cache_by_type()) {
-				memory::vector<std::reference_wrapper<Pop>>& state_pops_of_type = pops_cache_by_type[pop_type_index];
-				state_pops_of_type.insert(
-					state_pops_of_type.end(),
-					province_pops_of_type.begin(),
-					province_pops_of_type.end()
-				);
-				++pop_type_index;
-			}
-		}
 	}
 
-	normalise_pops_aggregate();
+	//provinces only change their pops during updates, so the grouping only needs rebuilding alongside the aggregate
+	const bool pops_changed = update_pops_aggregate_from_parts(
+		provinces,
+		[](std::reference_wrapper<ProvinceInstance> const& province) -> ProvinceInstance& {
+			return province.get();
+		}
+	);
+	if (pops_changed) {
+		pops_by_type.rebuild_from_parts(
+			provinces,
+			[](std::reference_wrapper<ProvinceInstance> const& province) -> PopsByType const& {
+				return province.get().get_pops_by_type();
+			}
+		);
+	}
 
 	// TODO - use actual values when State has factory data
 	const int32_t total_factory_levels_in_state = 0;
@@ -91,7 +86,6 @@ void State::update_gamestate() {
 	}
 
 	industrial_power = total_factory_levels_in_state * workforce_scalar;
-	_update_country();
 }
 
 void State::_update_country() {
@@ -223,9 +217,20 @@ void StateManager::reset() {
 	state_sets.clear();
 }
 
-void StateManager::update_gamestate() {
+void StateManager::update_gamestate(ecs::EcsThreadPool& executor) {
+	//states only read their own provinces
+	executor.parallel_for(
+		state_sets.size(),
+		[this](const std::size_t state_set_index, const uint32_t /*worker_id*/) -> void {
+			state_sets[state_set_index].update_gamestate();
+		}
+	);
+
+	//changing owner edits the countries' state lists, so do it serially and in the same order every time
 	for (StateSet& state_set : state_sets) {
-		state_set.update_gamestate();
+		for (State& state : state_set.states) {
+			state._update_country();
+		}
 	}
 }
 
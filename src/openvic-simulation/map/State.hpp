@@ -5,15 +5,19 @@
 #include <fmt/base.h>
 
 #include "openvic-simulation/core/memory/Colony.hpp"
-#include "openvic-simulation/core/memory/FixedVector.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/portable/ForwardableSpan.hpp"
 #include "openvic-simulation/population/PopsAggregate.hpp"
+#include "openvic-simulation/population/PopsByType.hpp"
 #include "openvic-simulation/types/ColonyStatus.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
+namespace OpenVic::ecs {
+	class EcsThreadPool;
+}
+
 namespace OpenVic {
 	struct BaseIssue;
 	struct CountryInstance;
@@ -41,10 +45,7 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(industrial_power);
 		bool PROPERTY_CUSTOM_PREFIX(coastal, is, false);
 
-		memory::FixedVector<
-			memory::vector<std::reference_wrapper<Pop>>,
-			pop_type_index_t
-		> SPAN_PROPERTY(pops_cache_by_type);
+		PopsByType PROPERTY(pops_by_type);
 
 		void _update_country();
 
@@ -70,6 +71,7 @@ namespace OpenVic {
 			return is_colonial(colony_status);
 		}
 
+		//Only touches this state, StateManager moves it to its new owner afterwards.
 		void update_gamestate();
 	};
 
@@ -121,7 +123,7 @@ namespace OpenVic {
 
 		void reset();
 
-		void update_gamestate();
+		void update_gamestate(ecs::EcsThreadPool& executor);
 	};
 }
 
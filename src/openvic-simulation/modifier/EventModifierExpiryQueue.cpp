@@ -0,0 +1,8 @@
+#include "EventModifierExpiryQueue.hpp"
+
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+
+using namespace OpenVic;
+
+template struct OpenVic::BasicEventModifierExpiryQueue<CountryInstance, ProvinceInstance>;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <variant>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+namespace OpenVic {
+	struct CountryInstance;
+	struct ProvinceInstance;
+
+	/* Min-heap of every active event modifier keyed by expiry date. Event modifiers are added through it,
+	 * so each update only touches the countries and provinces whose modifiers actually expire instead of
+	 * scanning every event modifier of every country and province.
+	 * Holders only need add_event_modifier and expire_event_modifier, the game uses EventModifierExpiryQueue below. */
+	template<typename... Holders>
+	struct BasicEventModifierExpiryQueue {
+		using holder_t = std::variant<Holders*...>;
+
+	private:
+		struct entry_t {
+			Date expiry_date;
+			holder_t holder;
+			Modifier const* modifier;
+		};
+
+		memory::vector<entry_t> heap;
+
+		static constexpr bool expires_later(entry_t const& lhs, entry_t const& rhs) {
+			return lhs.expiry_date > rhs.expiry_date;
+		}
+
+	public:
+		template<typename Holder>
+		void add_event_modifier(Holder& holder, Modifier const& modifier, const Date expiry_date) {
+			holder.add_event_modifier(modifier, expiry_date);
+			heap.push_back({ expiry_date, &holder, &modifier });
+			std::push_heap(heap.begin(), heap.end(), expires_later);
+		}
+
+		// Removes every event modifier that expired before today from its holder, returns how many were removed.
+		std::size_t expire_event_modifiers(const Date today) {
+			std::size_t expired_count = 0;
+
+			// Modifiers are active up to and including their expiry date
+			while (!heap.empty() && heap.front().expiry_date < today) {
+				std::pop_heap(heap.begin(), heap.end(), expires_later);
+				entry_t const& entry = heap.back();
+
+				const bool expired = std::visit(
+					[&entry](auto* holder) -> bool {
+						return holder->expire_event_modifier(*entry.modifier, entry.expiry_date);
+					},
+					entry.holder
+				);
+				if (expired) {
+					++expired_count;
+				} else {
+					spdlog::error_s(
+						"Event modifier {} expiring on {} was not found on its holder!", *entry.modifier, entry.expiry_date
+					);
+				}
+
+				heap.pop_back();
+			}
+
+			return expired_count;
+		}
+
+		void clear() {
+			heap.clear();
+		}
+
+		constexpr std::size_t size() const {
+			return heap.size();
+		}
+		constexpr bool empty() const {
+			return heap.empty();
+		}
+	};
+
+	using EventModifierExpiryQueue = BasicEventModifierExpiryQueue<CountryInstance, ProvinceInstance>;
+	extern template struct BasicEventModifierExpiryQueue<CountryInstance, ProvinceInstance>;
+}
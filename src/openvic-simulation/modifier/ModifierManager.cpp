@@ -58,11 +58,13 @@ bool ModifierManager::_register_modifier_effect(
 
 	const bool ret = registry.emplace_item(
 		identifier,
-		identifier, format, targets, localisation_key, has_no_effect
+		identifier, index_from_count<ModifierEffect::index_t>(modifier_effect_count),
+		format, targets, localisation_key, has_no_effect
 	);
 
 	if (ret) {
 		effect_cache = &registry.back();
+		++modifier_effect_count;
 	}
 
 	return ret;
@@ -783,7 +785,13 @@ bool ModifierManager::_add_modifier_cb(
 	if (effect->has_no_effect) {
 		spdlog::warn_s("This modifier does nothing: {}", *effect);
 	}
-	return expect_fixed_point(map_callback(modifier_value.values, effect))(value);
+	return expect_fixed_point([&modifier_value, effect](const fixed_point_t effect_value) -> bool {
+		if (modifier_value.add_new_effect(*effect, effect_value)) {
+			return true;
+		}
+		spdlog::error_s("Duplicate modifier effect: \"{}\"", *effect);
+		return false;
+	})(value);
 }
 
 key_value_callback_t ModifierManager::_expect_modifier_effect(
@@ -32,6 +32,8 @@ namespace OpenVic {
 		modifier_effect_registry_t IDENTIFIER_REGISTRY(base_province_modifier_effect);
 		modifier_effect_registry_t IDENTIFIER_REGISTRY(terrain_modifier_effect);
 		case_insensitive_string_set_t complex_modifiers;
+		// Effects are indexed across all registries, so sums can store them densely.
+		size_t PROPERTY(modifier_effect_count, 0);
 
 		IdentifierRegistry<IconModifier> IDENTIFIER_REGISTRY(event_modifier);
 		IdentifierRegistry<TriggeredModifier> IDENTIFIER_REGISTRY(triggered_modifier);
@@ -1,5 +1,6 @@
 #include "ModifierSum.hpp"
 
+#include <algorithm>
 #include <variant>
 
 #include "openvic-simulation/core/template/Concepts.hpp"
@@ -33,6 +34,7 @@ memory::string modifier_entry_t::to_string() const {
 void ModifierSum::clear() {
 	modifiers.clear();
 	value_sum.clear();
+	contributing_sums.clear();
 }
 
 fixed_point_t ModifierSum::get_modifier_effect_value(ModifierEffect const& effect, bool* effect_found) const {
@@ -63,3 +65,34 @@ void ModifierSum::add_modifier(
 		);
 	}
 }
+
+void ModifierSum::add_modifier_sum(ModifierSum const& modifier_sum) {
+	contributing_sums.push_back(&modifier_sum);
+	value_sum += modifier_sum.value_sum;
+}
+
+bool ModifierSum::remove_modifier(
+	Modifier const& modifier, fixed_point_t multiplier, modifier_entry_t::modifier_source_t const& source,
+	ModifierEffect::target_t excluded_targets
+) {
+	if (multiplier == 0) {
+		return true;
+	}
+
+	const modifier_entry_t entry {
+		modifier,
+		multiplier,
+		modifier_entry_t::source_or_null_fallback(source, this_source),
+		excluded_targets | this_excluded_targets
+	};
+
+	// Search from the back, recently added entries are the most likely to be removed again.
+	const auto it = std::find(modifiers.rbegin(), modifiers.rend(), entry);
+	if (it == modifiers.rend()) {
+		return false;
+	}
+
+	modifiers.erase(std::next(it).base());
+	value_sum.multiply_subtract_exclude_targets(*entry.modifier, entry.multiplier, entry.excluded_targets);
+	return true;
+}
@@ -121,17 +121,36 @@ namespace OpenVic {
 		bulk_insert_wrapper<
 			memory::vector<modifier_entry_t>
 		> SPAN_PROPERTY(modifiers);
-		ModifierValue PROPERTY(value_sum);
+		DenseModifierValue PROPERTY(value_sum);
+		// Sums added with add_modifier_sum. Only their values are folded into value_sum, their entries
+		// stay where they are and are visited through these when contributions are requested.
+		memory::vector<ModifierSum const*> SPAN_PROPERTY(contributing_sums);
+
+		template<typename Callback>
+		constexpr void _for_each_contributing_modifier(ModifierEffect const& effect, Callback& callback) const {
+			for (modifier_entry_t const& modifier_entry : get_modifiers()) {
+				const fixed_point_t contribution = modifier_entry.get_modifier_effect_value(effect);
+
+				if (contribution != 0) {
+					callback(modifier_entry, contribution);
+				}
+			}
+
+			for (ModifierSum const* contributing_sum : contributing_sums) {
+				contributing_sum->_for_each_contributing_modifier(effect, callback);
+			}
+		}
 
 	public:
 		ModifierSum() {};
 		ModifierSum(ModifierSum&&) = default;
 
+		// Only counts this sum's own entries, not those of contributing sums.
 		constexpr std::size_t size() const {
 			return modifiers.size();
 		}
 		constexpr bool empty() const {
-			return modifiers.empty();
+			return modifiers.empty() && contributing_sums.empty();
 		}
 		void clear();
 
@@ -145,39 +164,31 @@ namespace OpenVic {
 			ModifierEffect::target_t excluded_targets = ModifierEffect::target_t::NO_TARGETS
 		);
 
-		constexpr void make_room_for(ModifierSum const& modifier_sum) {
-			modifiers.make_room_for(modifier_sum.size());
-		}
-
-		// Inserts modifiers directly via std::ranges::copy. Requires resizing beforehand!
-		// with the modifier entries' attributes as arguments. This means non-null sources are preserved (null ones are
-		// replaced with this_source, but in practice the other sum should've set them itself already) and exclusion targets
-		// are combined with this_excluded_targets.
-		constexpr void add_modifier_sum(ModifierSum const& modifier_sum) {
-			// We could test that excluded_targets != ALL_TARGETS, but in practice it's always
-			// called with an explcit/hardcoded value and so won't ever exclude everything.
-			modifiers.append_range(modifier_sum.modifiers);
-
-			for (modifier_entry_t const& m : modifier_sum.get_modifiers()) {
-				value_sum.multiply_add_exclude_targets(
-					*m.modifier,
-					m.multiplier,
-					m.excluded_targets
-				);
-			}
-		}
+		// Removes the entry add_modifier created with the same arguments and subtracts its contribution exactly.
+		// Returns false if there is no such entry.
+		bool remove_modifier(
+			Modifier const& modifier,
+			fixed_point_t multiplier = 1,
+			modifier_entry_t::modifier_source_t const& source = {},
+			ModifierEffect::target_t excluded_targets = ModifierEffect::target_t::NO_TARGETS
+		);
 
+		// Adds the other sum's values and keeps a reference to it for for_each_contributing_modifier, rather than
+		// copying its entries. The other sum must outlive this one's next clear(); entries keep the sources and
+		// exclusion targets they were added with.
+		// The values are a snapshot: if the other sum changes afterwards, this sum must be cleared and rebuilt before
+		// it is read again, otherwise its values and its contributions disagree. InstanceManager::update_modifier_sums
+		// rebuilds countries before their provinces contribute, and any province change between updates leaves the
+		// country stale until the next update.
+		void add_modifier_sum(ModifierSum const& modifier_sum);
+
+		// Contributions of referenced sums are looked up lazily from those sums' current entries, so they only match
+		// value_sum while every referenced sum is unchanged since it was added, see add_modifier_sum.
 		// TODO - help calculate value_sum[effect]? Early return if lookup in value_sum fails?
 		constexpr void for_each_contributing_modifier(
 			ModifierEffect const& effect, ContributingModifierCallback auto callback
 		) const {
-			for (modifier_entry_t const& modifier_entry : get_modifiers()) {
-				const fixed_point_t contribution = modifier_entry.get_modifier_effect_value(effect);
-
-				if (contribution != 0) {
-					callback(modifier_entry, contribution);
-				}
-			}
+			_for_each_contributing_modifier(effect, callback);
 		}
 	};
 }
@@ -1,12 +1,39 @@
 #include "ModifierValue.hpp"
 
-#include "openvic-simulation/core/stl/MutableIterator.hpp"
+#include <algorithm>
 
 using namespace OpenVic;
 
+ModifierValue::effect_entry_t* ModifierValue::find_entry(ModifierEffect const& effect) {
+	for (effect_entry_t& entry : values) {
+		if (entry.effect == &effect) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+ModifierValue::effect_entry_t const* ModifierValue::find_entry(ModifierEffect const& effect) const {
+	for (effect_entry_t const& entry : values) {
+		if (entry.effect == &effect) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+fixed_point_t& ModifierValue::get_or_add_value(ModifierEffect const& effect) {
+	effect_entry_t* entry = find_entry(effect);
+	if (entry == nullptr) {
+		values.push_back({ &effect, effect.index, effect.targets, fixed_point_t::_0 });
+		entry = &values.back();
+	}
+	return entry->value;
+}
+
 void ModifierValue::trim() {
-	erase_if(values, [](effect_map_t::value_type const& value) -> bool {
-		return value.second == 0;
+	std::erase_if(values, [](effect_entry_t const& entry) -> bool {
+		return entry.value == 0;
 	});
 }
 
@@ -23,12 +50,12 @@ bool ModifierValue::empty() const {
 }
 
 fixed_point_t ModifierValue::get_effect(ModifierEffect const& effect, bool* effect_found) const {
-	const effect_map_t::const_iterator it = values.find(&effect);
-	if (it != values.end()) {
+	effect_entry_t const* entry = find_entry(effect);
+	if (entry != nullptr) {
 		if (effect_found != nullptr) {
 			*effect_found = true;
 		}
-		return it->second;
+		return entry->value;
 	}
 
 	if (effect_found != nullptr) {
@@ -38,16 +65,24 @@ fixed_point_t ModifierValue::get_effect(ModifierEffect const& effect, bool* effe
 }
 
 bool ModifierValue::has_effect(ModifierEffect const& effect) const {
-	return values.contains(&effect);
+	return find_entry(effect) != nullptr;
 }
 
 void ModifierValue::set_effect(ModifierEffect const& effect, fixed_point_t value) {
-	values[&effect] = value;
+	get_or_add_value(effect) = value;
+}
+
+bool ModifierValue::add_new_effect(ModifierEffect const& effect, fixed_point_t value) {
+	if (find_entry(effect) != nullptr) {
+		return false;
+	}
+	values.push_back({ &effect, effect.index, effect.targets, value });
+	return true;
 }
 
 ModifierValue& ModifierValue::operator+=(ModifierValue const& right) {
-	for (effect_map_t::value_type const& value : right.values) {
-		values[value.first] += value.second;
+	for (effect_entry_t const& entry : right.values) {
+		get_or_add_value(*entry.effect) += entry.value;
 	}
 	return *this;
 }
@@ -59,15 +94,15 @@ ModifierValue ModifierValue::operator+(ModifierValue const& right) const {
 
 ModifierValue ModifierValue::operator-() const {
 	ModifierValue copy = *this;
-	for (auto value : mutable_iterator(copy.values)) {
-		value.second = -value.second;
+	for (effect_entry_t& entry : copy.values) {
+		entry.value = -entry.value;
 	}
 	return copy;
 }
 
 ModifierValue& ModifierValue::operator-=(ModifierValue const& right) {
-	for (effect_map_t::value_type const& value : right.values) {
-		values[value.first] -= value.second;
+	for (effect_entry_t const& entry : right.values) {
+		get_or_add_value(*entry.effect) -= entry.value;
 	}
 	return *this;
 }
@@ -78,8 +113,8 @@ ModifierValue ModifierValue::operator-(ModifierValue const& right) const {
 }
 
 ModifierValue& ModifierValue::operator*=(const fixed_point_t right) {
-	for (auto value : mutable_iterator(values)) {
-		value.second *= right;
+	for (effect_entry_t& entry : values) {
+		entry.value *= right;
 	}
 	return *this;
 }
@@ -94,10 +129,10 @@ void ModifierValue::apply_exclude_targets(ModifierEffect::target_t excluded_targ
 
 	// We could test if excluded_targets is NO_TARGETS (and so we do nothing) or ALL_TARGETS (and so we clear everything),
 	// but so long as this is always called with an explicit/hardcoded value then we'll never have either of those cases.
-	erase_if(
+	std::erase_if(
 		values,
-		[excluded_targets](effect_map_t::value_type const& value) -> bool {
-			return !ModifierEffect::excludes_targets(value.first->targets, excluded_targets);
+		[excluded_targets](effect_entry_t const& entry) -> bool {
+			return !ModifierEffect::excludes_targets(entry.targets, excluded_targets);
 		}
 	);
 }
@@ -112,9 +147,9 @@ void ModifierValue::multiply_add_exclude_targets(
 	} else if (multiplier != 0) {
 		// We could test that excluded_targets != ALL_TARGETS, but in practice it's always
 		// called with an explcit/hardcoded value and so won't ever exclude everything.
-		for (effect_map_t::value_type const& value : other.values) {
-			if (ModifierEffect::excludes_targets(value.first->targets, excluded_targets)) {
-				values[value.first] += value.second * multiplier;
+		for (effect_entry_t const& entry : other.values) {
+			if (ModifierEffect::excludes_targets(entry.targets, excluded_targets)) {
+				get_or_add_value(*entry.effect) += entry.value * multiplier;
 			}
 		}
 	}
@@ -122,9 +157,82 @@ void ModifierValue::multiply_add_exclude_targets(
 
 namespace OpenVic { // so the compiler shuts up
 	std::ostream& operator<<(std::ostream& stream, ModifierValue const& value) {
-		for (ModifierValue::effect_map_t::value_type const& effect : value.values) {
-			stream << effect.first << ": " << effect.second << "\n";
+		for (ModifierValue::effect_entry_t const& entry : value.values) {
+			stream << entry.effect << ": " << entry.value << "\n";
 		}
 		return stream;
 	}
 }
+
+void DenseModifierValue::grow_to(const std::size_t size) {
+	if (values.size() < size) {
+		values.resize(size, fixed_point_t::_0);
+	}
+}
+
+void DenseModifierValue::clear() {
+	std::fill(values.begin(), values.end(), fixed_point_t::_0);
+}
+
+bool DenseModifierValue::operator==(DenseModifierValue const& right) const {
+	const std::size_t common_size = std::min(values.size(), right.values.size());
+	const auto is_zero = [](const fixed_point_t value) -> bool {
+		return value == 0;
+	};
+
+	return std::equal(values.begin(), values.begin() + common_size, right.values.begin())
+		&& std::all_of(values.begin() + common_size, values.end(), is_zero)
+		&& std::all_of(right.values.begin() + common_size, right.values.end(), is_zero);
+}
+
+DenseModifierValue& DenseModifierValue::operator+=(DenseModifierValue const& right) {
+	grow_to(right.values.size());
+
+	// Plain element-wise add over contiguous storage, the compiler is free to vectorise it.
+	fixed_point_t* const lhs = values.data();
+	fixed_point_t const* const rhs = right.values.data();
+	for (std::size_t index = 0; index < right.values.size(); ++index) {
+		lhs[index] += rhs[index];
+	}
+	return *this;
+}
+
+template<bool Subtract>
+void DenseModifierValue::_multiply_add_exclude_targets(
+	ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+) {
+	if (multiplier == 0 || other.empty()) {
+		return;
+	}
+
+	std::size_t max_index = 0;
+	for (ModifierValue::effect_entry_t const& entry : other.get_values()) {
+		max_index = std::max<std::size_t>(max_index, type_safe::get(entry.index));
+	}
+	grow_to(max_index + 1);
+
+	// Subtracting computes the same products as adding, so fixed point rounding cancels out exactly.
+	fixed_point_t* const lhs = values.data();
+	for (ModifierValue::effect_entry_t const& entry : other.get_values()) {
+		if (ModifierEffect::excludes_targets(entry.targets, excluded_targets)) {
+			const fixed_point_t contribution = multiplier == fixed_point_t::_1 ? entry.value : entry.value * multiplier;
+			if constexpr (Subtract) {
+				lhs[type_safe::get(entry.index)] -= contribution;
+			} else {
+				lhs[type_safe::get(entry.index)] += contribution;
+			}
+		}
+	}
+}
+
+void DenseModifierValue::multiply_add_exclude_targets(
+	ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+) {
+	_multiply_add_exclude_targets<false>(other, multiplier, excluded_targets);
+}
+
+void DenseModifierValue::multiply_subtract_exclude_targets(
+	ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+) {
+	_multiply_add_exclude_targets<true>(other, multiplier, excluded_targets);
+}
@@ -1,20 +1,37 @@
 #pragma once
 
+#include <cstddef>
+
+#include <type_safe/strong_typedef.hpp>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/modifier/ModifierEffect.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
 
 namespace OpenVic {
+	/* Sparse form, used for modifier definitions and while loading them.
+	 * Entries are kept in insertion order. Definitions rarely have more than a handful of effects,
+	 * so a linear scan is cheaper than hashing. */
 	struct ModifierValue {
 		friend struct ModifierManager;
 
-		using effect_map_t = fixed_point_map_t<ModifierEffect const*>;
+		// Index and targets are copied from the effect so summing never has to dereference it.
+		struct effect_entry_t {
+			ModifierEffect const* effect;
+			modifier_effect_index_t index;
+			ModifierEffect::target_t targets;
+			fixed_point_t value;
+		};
 
 	private:
-		effect_map_t PROPERTY(values);
+		memory::vector<effect_entry_t> SPAN_PROPERTY(values);
+
+		effect_entry_t* find_entry(ModifierEffect const& effect);
+		effect_entry_t const* find_entry(ModifierEffect const& effect) const;
+		fixed_point_t& get_or_add_value(ModifierEffect const& effect);
 
 	public:
 		ModifierValue() {};
-		ModifierValue(effect_map_t&& new_values) : values { std::move(new_values) } {};
 		ModifierValue(ModifierValue const&) = default;
 		ModifierValue(ModifierValue&&) = default;
 
@@ -30,6 +47,8 @@ namespace OpenVic {
 		fixed_point_t get_effect(ModifierEffect const& effect, bool* effect_found = nullptr) const;
 		bool has_effect(ModifierEffect const& effect) const;
 		void set_effect(ModifierEffect const& effect, fixed_point_t value);
+		/* Returns false without changing anything if the effect is already present. */
+		bool add_new_effect(ModifierEffect const& effect, fixed_point_t value);
 
 		ModifierValue& operator+=(ModifierValue const& right);
 		ModifierValue operator+(ModifierValue const& right) const;
@@ -46,4 +65,57 @@ namespace OpenVic {
 
 		friend std::ostream& operator<<(std::ostream& stream, ModifierValue const& value);
 	};
+
+	/* Dense form, used for modifier sums. Holds one value per effect index, so looking up an effect is an
+	 * array load and adding a sparse ModifierValue is a multiply-add per entry without any hashing.
+	 * Grows to fit the highest effect index added, clearing keeps the storage for the next rebuild.
+	 * An effect counts as present when its value is non-zero. */
+	struct DenseModifierValue {
+	private:
+		memory::vector<fixed_point_t> values;
+
+		void grow_to(const std::size_t size);
+
+		template<bool Subtract>
+		void _multiply_add_exclude_targets(
+			ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+		);
+
+	public:
+		DenseModifierValue() {};
+		DenseModifierValue(DenseModifierValue const&) = default;
+		DenseModifierValue(DenseModifierValue&&) = default;
+
+		DenseModifierValue& operator=(DenseModifierValue const&) = default;
+		DenseModifierValue& operator=(DenseModifierValue&&) = default;
+
+		void clear();
+
+		/* Unlike ModifierValue::get_effect, an effect whose contributions sum to zero is reported as not found,
+		 * the dense storage keeps no presence bit since subtracting a contribution must leave it exactly as before. */
+		inline fixed_point_t get_effect(ModifierEffect const& effect, bool* effect_found = nullptr) const {
+			const std::size_t index = type_safe::get(effect.index);
+			const fixed_point_t value = index < values.size() ? values[index] : fixed_point_t::_0;
+			if (effect_found != nullptr) {
+				*effect_found = value != 0;
+			}
+			return value;
+		}
+		inline bool has_effect(ModifierEffect const& effect) const {
+			return get_effect(effect) != 0;
+		}
+
+		// Storage sizes may differ, missing effects compare as zero.
+		bool operator==(DenseModifierValue const& right) const;
+
+		DenseModifierValue& operator+=(DenseModifierValue const& right);
+
+		void multiply_add_exclude_targets(
+			ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+		);
+		// Exact inverse of multiply_add_exclude_targets with the same arguments.
+		void multiply_subtract_exclude_targets(
+			ModifierValue const& other, fixed_point_t multiplier, ModifierEffect::target_t excluded_targets
+		);
+	};
 }
@@ -21,9 +21,10 @@ CultureGroup::CultureGroup(
 	is_overseas { new_is_overseas }, union_country { new_union_country } {}
 
 Culture::Culture(
-	std::string_view new_identifier, colour_t new_colour, CultureGroup const& new_group, name_list_t&& new_first_names,
-	name_list_t&& new_last_names, fixed_point_t new_radicalism, CountryDefinition const* new_primary_country
-) : HasIdentifierAndColour { new_identifier, new_colour, false }, group { new_group },
+	std::string_view new_identifier, index_t new_index, colour_t new_colour, CultureGroup const& new_group,
+	name_list_t&& new_first_names, name_list_t&& new_last_names, fixed_point_t new_radicalism,
+	CountryDefinition const* new_primary_country
+) : HasIdentifierAndColour { new_identifier, new_colour, false }, HasIndex { new_index }, group { new_group },
 	first_names { std::move(new_first_names) }, last_names { std::move(new_last_names) }, radicalism { new_radicalism },
 	primary_country { new_primary_country } {}
 
@@ -98,7 +99,8 @@ bool CultureManager::add_culture(
 
 	return cultures.emplace_item(
 		identifier,
-		identifier, colour, group, std::move(first_names), std::move(last_names), radicalism, primary_country
+		identifier, index_from_count<Culture::index_t>(get_culture_count()), colour, group, std::move(first_names),
+		std::move(last_names), radicalism, primary_country
 	);
 }
 
@@ -43,7 +43,7 @@ namespace OpenVic {
 		}
 	};
 
-	struct Culture : HasIdentifierAndColour {
+	struct Culture : HasIdentifierAndColour, HasIndex<Culture, culture_index_t> {
 	private:
 		name_list_t PROPERTY(first_names);
 		name_list_t PROPERTY(last_names);
@@ -54,8 +54,9 @@ namespace OpenVic {
 		CountryDefinition const* const primary_country;
 
 		Culture(
-			std::string_view new_identifier, colour_t new_colour, CultureGroup const& new_group, name_list_t&& new_first_names,
-			name_list_t&& new_last_names, fixed_point_t new_radicalism, CountryDefinition const* new_primary_country
+			std::string_view new_identifier, index_t new_index, colour_t new_colour, CultureGroup const& new_group,
+			name_list_t&& new_first_names, name_list_t&& new_last_names, fixed_point_t new_radicalism,
+			CountryDefinition const* new_primary_country
 		);
 		Culture(Culture&&) = default;
 
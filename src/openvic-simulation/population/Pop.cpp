@@ -1,10 +1,10 @@
 #include "Pop.hpp"
 
+#include <algorithm>
 #include <concepts> // IWYU pragma: keep for lambda
 #include <cstddef>
 #include <cstdint>
 #include <optional>
-#include <ranges>
 
 #include <fmt/std.h>
 
@@ -71,11 +71,8 @@ Pop::Pop(
 				pop_deps.artisanal_producer_deps
 			}
 			: std::optional<ArtisanalProducer> {}
-	},
-	supporter_equivalents_by_ideology { generate_values, pop_deps.pops_aggregate_deps.ideology_count },
-	supporter_equivalents_by_party_policy { generate_values, pop_deps.pops_aggregate_deps.party_policy_count },
-	supporter_equivalents_by_reform { generate_values, pop_deps.pops_aggregate_deps.reform_count } {
-		reserve_needs_fulfilled_goods();
+	} {
+		resize_needs_to_pop_type();
 	}
 
 fixed_point_t Pop::get_unemployment_fraction() const {
@@ -101,46 +98,26 @@ void Pop::setup_pop_test_values(TypedSpan<reform_index_t, const Reform> reforms)
 	total_change =
 		num_grown + num_promoted + num_demoted + num_migrated_internal + num_migrated_external + num_migrated_colonial;
 
-	/* Generates a number between 0 and max (inclusive) and sets map[&key] to it if it's at least min. */
-	static auto fill_span_with_test_weights = [](std::span<fixed_point_t> span, int32_t min, int32_t max) -> void {
-		for (fixed_point_t& item : span) {
+	/* Generates a number between 0 and max (inclusive) for each of the first count indices and sets it if it's at least min. */
+	static auto fill_with_test_weights = []<typename IndexT>(
+		SparseSupportVector<IndexT>& supporters, const std::size_t count, int32_t min, int32_t max
+	) -> void {
+		supporters.clear();
+		for (std::size_t i = 0; i < count; ++i) {
 			const int32_t value = rand() % (max + 1);
-			item = value >= min ? value : 0;
-		}
-	};
-	static auto rescale_span = [](std::span<fixed_point_t> span, const fixed_point_t new_total) -> void {
-		fixed_point_t old_total = 0;
-		for (const fixed_point_t item : span) {
-			old_total += item;
-		}
-
-		if (old_total == 0) { return; }
-
-		for (fixed_point_t& item : span) {
-			item = fp::mul_div(item, new_total, old_total);
+			if (value >= min) {
+				supporters.set(index_from_count<IndexT>(i), value);
+			}
 		}
 	};
-	static auto rescale_spans = [](
-		std::span<fixed_point_t> span_a,
-		std::span<fixed_point_t> span_b,
-		const fixed_point_t new_total
+	static auto rescale_supporters = []<typename... IndexTs>(
+		const fixed_point_t new_total, SparseSupportVector<IndexTs>&... supporters
 	) -> void {
-		fixed_point_t old_total = 0;
-		for (const fixed_point_t item : span_a) {
-			old_total += item;
-		}
-		for (const fixed_point_t item : span_b) {
-			old_total += item;
-		}
+		const fixed_point_t old_total = (supporters.get_total() + ...);
 
 		if (old_total == 0) { return; }
 
-		for (fixed_point_t& item : span_a) {
-			item = fp::mul_div(item, new_total, old_total);
-		}
-		for (fixed_point_t& item : span_b) {
-			item = fp::mul_div(item, new_total, old_total);
-		}
+		(supporters.rescale(new_total, old_total), ...);
 	};
 	static auto test_weight_ordered = []<typename T, typename U>(ordered_map<T const*, fixed_point_t>& map, U const& key, int32_t min, int32_t max) -> void {
 		if constexpr (std::is_convertible_v<U const*, T const*> || std::is_convertible_v<U, T const*>) {
@@ -158,26 +135,32 @@ void Pop::setup_pop_test_values(TypedSpan<reform_index_t, const Reform> reforms)
 		}
 	};
 
+	// The location's aggregate is dense, so its sizes are the ideology, policy and reform counts.
+	ProvinceInstance const& location_aggregate = get_location();
+
 	/* All entries equally weighted for testing. */
-	fill_span_with_test_weights(supporter_equivalents_by_ideology, 1, 5);
-	rescale_span(supporter_equivalents_by_ideology, type_safe::get(size));
+	fill_with_test_weights(
+		supporter_equivalents_by_ideology, location_aggregate.get_supporter_equivalents_by_ideology().size(), 1, 5
+	);
+	rescale_supporters(type_safe::get(size), supporter_equivalents_by_ideology);
 
-	fill_span_with_test_weights(supporter_equivalents_by_party_policy, 3, 6);	
-	fill_span_with_test_weights(supporter_equivalents_by_reform, 3, 6);
+	fill_with_test_weights(
+		supporter_equivalents_by_party_policy, location_aggregate.get_supporter_equivalents_by_party_policy().size(), 3, 6
+	);
+	fill_with_test_weights(
+		supporter_equivalents_by_reform, location_aggregate.get_supporter_equivalents_by_reform().size(), 3, 6
+	);
 	for (Reform const& reform : reforms) {
 		if (reform.group.is_civilizing()) {
-			supporter_equivalents_by_reform[reform.index] = 0;
+			supporter_equivalents_by_reform.set(reform.index, 0);
 		}
 	}
-	rescale_spans(
-		supporter_equivalents_by_party_policy,
-		supporter_equivalents_by_reform,
-		type_safe::get(size)
-	);
+	rescale_supporters(type_safe::get(size), supporter_equivalents_by_party_policy, supporter_equivalents_by_reform);
 
-	if (!vote_equivalents_by_party.empty()) {
-		for (auto& [party, value] : vote_equivalents_by_party) {
-			vote_equivalents_by_party[party] = 0;
+	vote_equivalents_by_party.clear();
+	CountryInstance const* owner = get_location().get_owner();
+	if (owner != nullptr) {
+		for (CountryParty const& party : owner->country_definition.get_parties()) {
 			test_weight_ordered(vote_equivalents_by_party, party, 4, 10);
 		}
 		rescale_fixed_point_map(vote_equivalents_by_party, type_safe::get(size));
@@ -207,25 +190,13 @@ bool Pop::convert_to_equivalent() {
 	}
 
 	type = *equivalent;
-	reserve_needs_fulfilled_goods();
+	resize_needs_to_pop_type();
 	return true;
 }
 
 void Pop::update_location_based_attributes() {
 	vote_equivalents_by_party.clear();
-	CountryInstance const* owner = get_location().get_owner();
-	if (owner == nullptr) {
-		return;
-	}
-	CountryDefinition const& country_definition = owner->country_definition;
-
-	auto view = country_definition.get_parties() | std::views::transform(
-		[](CountryParty const& key) {
-			return std::make_pair(&key, fixed_point_t::_0);
-		}
-	);
-	vote_equivalents_by_party.insert(view.begin(), view.end());
-	// TODO - calculate vote distribution
+	// TODO - calculate vote distribution among the owner's parties
 }
 
 fixed_point_t Pop::get_vote_equivalents_by_party(CountryParty const& party) const {
@@ -285,25 +256,27 @@ memory::string Pop::get_pop_context_text() const {
 	);
 }
 
-void Pop::reserve_needs_fulfilled_goods() {
+static constexpr std::size_t NEEDS_FULFILLED_WORD_BITS = 64;
+
+void Pop::resize_needs_to_pop_type() {
 	PopType const& pop_type = type.get();
-	#define RESERVE_NEEDS(need_category) \
-		need_category##_needs_fulfilled_goods.reserve(pop_type.get_##need_category##_needs().size());
+	#define RESIZE_NEEDS(need_category) \
+		need_category##_need_quantities.assign(pop_type.get_##need_category##_needs().size(), 0); \
+		need_category##_needs_fulfilled_bits.assign( \
+			(pop_type.get_##need_category##_needs().size() + NEEDS_FULFILLED_WORD_BITS - 1) / NEEDS_FULFILLED_WORD_BITS, 0 \
+		);
 
-	OV_DO_FOR_ALL_NEED_CATEGORIES(RESERVE_NEEDS)
-	#undef RESERVE_NEEDS
+	OV_DO_FOR_ALL_NEED_CATEGORIES(RESIZE_NEEDS)
+	#undef RESIZE_NEEDS
 }
 
-void Pop::fill_needs_fulfilled_goods_with_false() {
-	PopType const& pop_type = type.get();
-	#define FILL_WITH_FALSE(need_category) \
-		need_category##_needs_fulfilled_goods.clear(); \
-		for (auto [good, base_demand] : pop_type.get_##need_category##_needs()) { \
-			need_category##_needs_fulfilled_goods.emplace(good, false); \
-		}
+void Pop::reset_needs() {
+	#define RESET_NEEDS(need_category) \
+		std::fill(need_category##_need_quantities.begin(), need_category##_need_quantities.end(), fixed_point_t::_0); \
+		std::fill(need_category##_needs_fulfilled_bits.begin(), need_category##_needs_fulfilled_bits.end(), 0);
 
-	OV_DO_FOR_ALL_NEED_CATEGORIES(FILL_WITH_FALSE)
-	#undef FILL_WITH_FALSE
+	OV_DO_FOR_ALL_NEED_CATEGORIES(RESET_NEEDS)
+	#undef RESET_NEEDS
 }
 
 void Pop::pay_income_tax(fixed_point_t& income) {
@@ -411,17 +384,40 @@ void Pop::add_import_subsidies(const fixed_point_t amount) {
 
 #define DEFINE_NEEDS_FULFILLED(need_category) \
 	fixed_point_t Pop::get_##need_category##_needs_fulfilled() const { \
-		const fixed_point_t desired_quantity_copy = need_category##_needs_desired_quantity.get_copy_of_value(); \
+		const fixed_point_t desired_quantity_copy = need_category##_needs_desired_quantity; \
 		if (desired_quantity_copy == 0) { \
 			return 1; \
 		} \
-		return need_category##_needs_acquired_quantity.get_copy_of_value() / desired_quantity_copy; \
+		return need_category##_needs_acquired_quantity / desired_quantity_copy; \
 	}
 OV_DO_FOR_ALL_NEED_CATEGORIES(DEFINE_NEEDS_FULFILLED)
 #undef DEFINE_NEEDS_FULFILLED
 
+#define DEFINE_NEED_GETTERS(need_category) \
+	fixed_point_t Pop::get_##need_category##_need_quantity(const good_index_t good_index) const { \
+		fixed_point_map_t<good_index_t> const& type_needs = type.get().get_##need_category##_needs(); \
+		const fixed_point_map_t<good_index_t>::const_iterator it = type_needs.find(good_index); \
+		if (it == type_needs.end()) { \
+			return 0; \
+		} \
+		return need_category##_need_quantities[it - type_needs.begin()]; \
+	} \
+	bool Pop::is_##need_category##_need_fulfilled(const good_index_t good_index) const { \
+		fixed_point_map_t<good_index_t> const& type_needs = type.get().get_##need_category##_needs(); \
+		const fixed_point_map_t<good_index_t>::const_iterator it = type_needs.find(good_index); \
+		if (it == type_needs.end()) { \
+			return false; \
+		} \
+		const std::size_t slot = it - type_needs.begin(); \
+		return (need_category##_needs_fulfilled_bits[slot / NEEDS_FULFILLED_WORD_BITS] >> (slot % NEEDS_FULFILLED_WORD_BITS)) & 1; \
+	}
+
+OV_DO_FOR_ALL_NEED_CATEGORIES(DEFINE_NEED_GETTERS)
+#undef DEFINE_NEED_GETTERS
+
 void Pop::allocate_for_needs(
-	fixed_point_map_t<good_index_t> const& scaled_needs,
+	fixed_point_map_t<good_index_t> const& type_needs,
+	std::span<const fixed_point_t> need_quantities,
 	forwardable_span<fixed_point_t> money_to_spend_per_good,
 	memory::vector<fixed_point_t>& reusable_vector,
 	fixed_point_t& weights_sum,
@@ -432,16 +428,19 @@ void Pop::allocate_for_needs(
 	}
 
 	memory::vector<fixed_point_t>& money_to_spend_per_good_draft = reusable_vector;
-	money_to_spend_per_good_draft.resize(scaled_needs.size(), 0);
+	money_to_spend_per_good_draft.resize(need_quantities.size(), 0);
 	fixed_point_t cash_left_to_spend_draft = cash_left_to_spend;
 
 	bool needs_redistribution = true;
 	while (needs_redistribution) {
 		needs_redistribution = false;
-		for (auto it = scaled_needs.begin(); it < scaled_needs.end(); it++) {
+		for (auto it = type_needs.begin(); it < type_needs.end(); it++) {
+			const ptrdiff_t i = it - type_needs.begin();
+			const fixed_point_t max_quantity_to_buy = need_quantities[i];
+			if (max_quantity_to_buy <= 0) {
+				continue;
+			}
 			const good_index_t good_index = it.key();
-			const fixed_point_t max_quantity_to_buy = it.value();
-			const ptrdiff_t i = it - scaled_needs.begin();
 			const fixed_point_t max_money_to_spend = market_instance.get_max_money_to_allocate_to_buy_quantity(
 				good_index,
 				max_quantity_to_buy
@@ -474,8 +473,8 @@ void Pop::allocate_for_needs(
 		}
 	}
 
-	for (auto it = scaled_needs.begin(); it < scaled_needs.end(); it++) {
-		const ptrdiff_t i = it - scaled_needs.begin();
+	for (auto it = type_needs.begin(); it < type_needs.end(); it++) {
+		const ptrdiff_t i = it - type_needs.begin();
 		const fixed_point_t money_to_spend = money_to_spend_per_good_draft[i];
 		money_to_spend_per_good[type_safe::get(it.key())] += money_to_spend;
 		cash_left_to_spend -= money_to_spend;
@@ -487,6 +486,7 @@ void Pop::allocate_for_needs(
 void Pop::pop_tick(
 	PopValuesFromProvince const& shared_values,
 	RandomU32& random_number_generator,
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -496,6 +496,7 @@ void Pop::pop_tick(
 	pop_tick_without_cleanup(
 		shared_values,
 		random_number_generator,
+		order_buffer_index,
 		reusable_goods_mask,
 		reusable_vectors
 	);
@@ -507,6 +508,7 @@ void Pop::pop_tick(
 void Pop::pop_tick_without_cleanup(
 	PopValuesFromProvince const& shared_values,
 	RandomU32& random_number_generator,
+	const std::size_t order_buffer_index,
 	TypedSpan<good_index_t, char> reusable_goods_mask,
 	forwardable_span<
 		memory::vector<fixed_point_t>,
@@ -521,7 +523,7 @@ void Pop::pop_tick_without_cleanup(
 	memory::vector<fixed_point_t>& money_to_spend_per_good = reusable_vectors[3];
 	money_to_spend_per_good.resize(good_count, 0);
 	cash_allocated_for_artisanal_spending = 0;
-	fill_needs_fulfilled_goods_with_false();
+	reset_needs();
 	
 	fixed_point_map_t<good_index_t> goods_to_sell {};
 	if (artisanal_producer_optional.has_value()) {
@@ -563,22 +565,20 @@ void Pop::pop_tick_without_cleanup(
 
 	PopType const& pop_type = type;
 	PopStrataValuesFromProvince const& shared_strata_values = shared_values.get_effects_by_strata()[pop_type.strata.index];
+	PopTypeValuesFromProvince const& shared_type_values = shared_values.get_pop_type_values(pop_type.index);
 	PopsDefines const& defines = shared_values.defines;
 	const fixed_point_t base_needs_scalar = (
 		fixed_point_t::_1 + 2 * consciousness / defines.get_pdef_base_con()
 	) * size;
 
 	#define FILL_NEEDS(need_category) \
-		need_category##_needs.clear(); \
 		const fixed_point_t need_category##_needs_scalar = base_needs_scalar * shared_strata_values.get_shared_##need_category##_needs_scalar(); \
 		fixed_point_t need_category##_needs_price_inverse_sum = 0; \
 		if (OV_likely(need_category##_needs_scalar > 0)) { \
 			need_category##_needs_acquired_quantity = need_category##_needs_desired_quantity = 0; \
-			for (auto [good_index, quantity] : pop_type.get_##need_category##_needs()) { \
-				if (!market_instance.get_is_available(good_index)) { \
-					continue; \
-				} \
-				fixed_point_t max_quantity_to_buy = quantity * need_category##_needs_scalar / size_denominator; \
+			for (PopTypeValuesFromProvince::need_t const& need : shared_type_values.get_available_##need_category##_needs()) { \
+				const good_index_t good_index = need.good_index; \
+				fixed_point_t max_quantity_to_buy = need.base_quantity * need_category##_needs_scalar / size_denominator; \
 				if (max_quantity_to_buy == 0) { \
 					continue; \
 				} \
@@ -586,19 +586,21 @@ void Pop::pop_tick_without_cleanup(
 					country_to_report_economy_nullable->report_pop_need_demand(pop_type, good_index, max_quantity_to_buy); \
 				} \
 				need_category##_needs_desired_quantity += max_quantity_to_buy; \
-				auto goods_to_sell_iterator = goods_to_sell.find(good_index); \
-				if (goods_to_sell_iterator != goods_to_sell.end() && goods_to_sell_iterator.value() > 0) { \
-					const fixed_point_t own_produce_consumed = std::min(goods_to_sell_iterator.value(), max_quantity_to_buy); \
-					goods_to_sell_iterator.value() -= own_produce_consumed; \
-					max_quantity_to_buy -= own_produce_consumed; \
-					need_category##_needs_acquired_quantity += own_produce_consumed; \
-					if (country_to_report_economy_nullable != nullptr) { \
-						country_to_report_economy_nullable->report_pop_need_consumption(pop_type, good_index, own_produce_consumed); \
+				if (!goods_to_sell.empty()) { \
+					auto goods_to_sell_iterator = goods_to_sell.find(good_index); \
+					if (goods_to_sell_iterator != goods_to_sell.end() && goods_to_sell_iterator.value() > 0) { \
+						const fixed_point_t own_produce_consumed = std::min(goods_to_sell_iterator.value(), max_quantity_to_buy); \
+						goods_to_sell_iterator.value() -= own_produce_consumed; \
+						max_quantity_to_buy -= own_produce_consumed; \
+						need_category##_needs_acquired_quantity += own_produce_consumed; \
+						if (country_to_report_economy_nullable != nullptr) { \
+							country_to_report_economy_nullable->report_pop_need_consumption(pop_type, good_index, own_produce_consumed); \
+						} \
 					} \
 				} \
 				if (OV_likely(max_quantity_to_buy > 0)) { \
-					need_category##_needs_price_inverse_sum += market_instance.get_good_instance(good_index).get_price_inverse(); \
-					need_category##_needs[good_index] += max_quantity_to_buy; \
+					need_category##_needs_price_inverse_sum += need.price_inverse; \
+					need_category##_need_quantities[need.slot] = max_quantity_to_buy; \
 					max_quantity_to_buy_per_good[type_safe::get(good_index)] += max_quantity_to_buy; \
 				} \
 			} \
@@ -608,13 +610,14 @@ void Pop::pop_tick_without_cleanup(
 	#undef FILL_NEEDS
 
 	//It's safe to use cash as this happens before cash is updated via spending
-	fixed_point_t cash_left_to_spend = cash.get_copy_of_value() / shared_values.get_max_cost_multiplier()
+	fixed_point_t cash_left_to_spend = cash / shared_values.get_max_cost_multiplier()
 		- cash_allocated_for_artisanal_spending;
 
 	#define ALLOCATE_FOR_NEEDS(need_category) \
 		if (cash_left_to_spend > 0) { \
 			allocate_for_needs( \
-				need_category##_needs, \
+				pop_type.get_##need_category##_needs(), \
+				need_category##_need_quantities, \
 				money_to_spend_per_good, \
 				reusable_vector_0, \
 				need_category##_needs_price_inverse_sum, \
@@ -629,6 +632,18 @@ void Pop::pop_tick_without_cleanup(
 		? std::nullopt
 		: std::optional<country_index_t>{country_to_report_economy_nullable->index};
 
+	//orders point into the pending slots, so they must not reallocate while orders are placed
+	pending_buys.clear();
+	pending_buys.reserve(std::count_if(
+		max_quantity_to_buy_per_good.begin(),
+		max_quantity_to_buy_per_good.end(),
+		[](const fixed_point_t max_quantity_to_buy) -> bool {
+			return max_quantity_to_buy > 0;
+		}
+	));
+	pending_sells.clear();
+	pending_sells.reserve(goods_to_sell.size());
+
 	for (std::size_t i = 0; i < good_count; ++i) {
 		const fixed_point_t max_quantity_to_buy = max_quantity_to_buy_per_good[i];
 
@@ -638,13 +653,12 @@ void Pop::pop_tick_without_cleanup(
 		
 		const fixed_point_t money_to_spend = money_to_spend_per_good[i];
 
-		market_instance.place_buy_up_to_order({
+		market_instance.place_buy_up_to_order(order_buffer_index, {
 			good_index_t(i),
 			country_index_optional,
 			max_quantity_to_buy,
 			money_to_spend,
-			this,
-			after_buy
+			&pending_buys.emplace_back()
 		});
 	}
 
@@ -656,31 +670,55 @@ void Pop::pop_tick_without_cleanup(
 			continue;
 		}
 
-		market_instance.place_market_sell_order(
-			{
-				good_index,
-				country_index_optional,
-				quantity_to_sell,
-				this,
-				after_sell
-			},
-			reusable_vectors[4]
-		);
+		market_instance.place_market_sell_order(order_buffer_index, {
+			good_index,
+			country_index_optional,
+			quantity_to_sell,
+			&pending_sells.emplace_back()
+		});
+	}
+}
+
+void Pop::settle_trades() {
+	for (std::optional<BuyResult> const& pending_buy : pending_buys) {
+		if (OV_unlikely(!pending_buy.has_value())) {
+			spdlog::error_s("Pop buy order was not executed. Context{}", get_pop_context_text());
+			continue;
+		}
+		settle_buy(*pending_buy);
+	}
+	for (std::optional<SellResult> const& pending_sell : pending_sells) {
+		if (OV_unlikely(!pending_sell.has_value())) {
+			spdlog::error_s("Pop sell order was not executed. Context{}", get_pop_context_text());
+			continue;
+		}
+		settle_sell(*pending_sell);
+	}
+	pending_buys.clear();
+	pending_sells.clear();
+
+	const fixed_point_t rgo_owner_income_to_add = deferred_rgo_owner_income.get_copy_of_value();
+	if (rgo_owner_income_to_add > 0) {
+		deferred_rgo_owner_income = 0;
+		add_rgo_owner_income(rgo_owner_income_to_add);
 	}
 }
 
-void Pop::after_buy(void* actor, BuyResult const& buy_result) {
+void Pop::defer_rgo_owner_income(const fixed_point_t amount) {
+	deferred_rgo_owner_income += amount;
+}
+
+void Pop::settle_buy(BuyResult const& buy_result) {
 	const fixed_point_t quantity_bought = buy_result.quantity_bought;
 
 	if (quantity_bought == 0) {
 		return;
 	}
 
-	Pop& pop = *static_cast<Pop*>(actor);
-	CountryInstance* const country_to_report_economy_nullable = pop.get_location().get_country_to_report_economy();
+	CountryInstance* const country_to_report_economy_nullable = get_location().get_country_to_report_economy();
 
 	fixed_point_t money_spent = buy_result.money_spent_total;
-	pop.yesterdays_import_value += buy_result.money_spent_on_imports;
+	yesterdays_import_value += buy_result.money_spent_on_imports;
 	if (country_to_report_economy_nullable != nullptr) {
 		const fixed_point_t tariff = country_to_report_economy_nullable->apply_tariff(buy_result.money_spent_on_imports);
 		money_spent += tariff;
@@ -688,11 +726,11 @@ void Pop::after_buy(void* actor, BuyResult const& buy_result) {
 
 	const good_index_t good_index = buy_result.good_index;
 	fixed_point_t quantity_left_to_consume = quantity_bought;
-	if (pop.artisanal_producer_optional.has_value()) {
+	if (artisanal_producer_optional.has_value()) {
 		if (quantity_left_to_consume <= 0) {
 			return;
 		}
-		const fixed_point_t quantity_added_to_stockpile = pop.artisanal_producer_optional.value().add_to_stockpile(
+		const fixed_point_t quantity_added_to_stockpile = artisanal_producer_optional.value().add_to_stockpile(
 			good_index,
 			quantity_left_to_consume
 		);
@@ -704,52 +742,58 @@ void Pop::after_buy(void* actor, BuyResult const& buy_result) {
 				quantity_added_to_stockpile,
 				quantity_bought
 			);
-			pop.add_artisan_inputs_expense(expense);
+			add_artisan_inputs_expense(expense);
 		}
 	}
 
-	CountryInstance* get_country_to_report_economy_nullable = pop.get_location().get_country_to_report_economy();
-	
+	CountryInstance* get_country_to_report_economy_nullable = get_location().get_country_to_report_economy();
+	PopType const& pop_type = type;
+
 	#define CONSUME_NEED(need_category) \
 		if (quantity_left_to_consume <= 0) { \
 			return; \
 		} \
-		const fixed_point_map_t<good_index_t>::const_iterator need_category##it = pop.need_category##_needs.find(good_index); \
-		if (need_category##it != pop.need_category##_needs.end()) { \
-			const fixed_point_t desired_quantity = need_category##it->second; \
+		fixed_point_map_t<good_index_t> const& need_category##_type_needs = pop_type.get_##need_category##_needs(); \
+		const fixed_point_map_t<good_index_t>::const_iterator need_category##it = need_category##_type_needs.find(good_index); \
+		const std::size_t need_category##_slot = need_category##it - need_category##_type_needs.begin(); \
+		if ( \
+			need_category##it != need_category##_type_needs.end() \
+			&& need_category##_need_quantities[need_category##_slot] > 0 \
+		) { \
+			const fixed_point_t desired_quantity = need_category##_need_quantities[need_category##_slot]; \
 			fixed_point_t consumed_quantity; \
 			if (quantity_left_to_consume >= desired_quantity) { \
 				consumed_quantity = desired_quantity; \
-				pop.need_category##_needs_fulfilled_goods.at(good_index) = true; \
+				need_category##_needs_fulfilled_bits[need_category##_slot / NEEDS_FULFILLED_WORD_BITS] \
+					|= uint64_t { 1 } << (need_category##_slot % NEEDS_FULFILLED_WORD_BITS); \
 			} else { \
 				consumed_quantity = quantity_left_to_consume; \
 			} \
-			pop.need_category##_needs_acquired_quantity += consumed_quantity; \
+			need_category##_needs_acquired_quantity += consumed_quantity; \
 			quantity_left_to_consume -= consumed_quantity; \
 			if (get_country_to_report_economy_nullable != nullptr) { \
-				get_country_to_report_economy_nullable->report_pop_need_consumption(pop.type, good_index, consumed_quantity); \
+				get_country_to_report_economy_nullable->report_pop_need_consumption(pop_type, good_index, consumed_quantity); \
 			} \
 			const fixed_point_t expense = fp::mul_div( \
 				money_spent, \
 				consumed_quantity, \
 				quantity_bought \
 			); \
-			pop.add_##need_category##_needs_expense(expense); \
+			add_##need_category##_needs_expense(expense); \
 		}
 
 	OV_DO_FOR_ALL_NEED_CATEGORIES(CONSUME_NEED)
 	#undef CONSUME_NEED
 }
 
-void Pop::after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) {
-	Pop& pop = *static_cast<Pop*>(actor);
+void Pop::settle_sell(SellResult const& sell_result) {
 	if (sell_result.money_gained > 0) {
-		OV_ERR_FAIL_COND_MSG(!pop.artisanal_producer_optional.has_value(), "Pop is selling artisanal goods but has no artisan.");
-		ArtisanalProducer& artisan = pop.artisanal_producer_optional.value();
+		OV_ERR_FAIL_COND_MSG(!artisanal_producer_optional.has_value(), "Pop is selling artisanal goods but has no artisan.");
+		ArtisanalProducer& artisan = artisanal_producer_optional.value();
 		if (artisan.get_last_produced_good() != nullptr && artisan.get_last_produced_good()->index == sell_result.good_index) {
-			pop.add_artisanal_revenue<true>(sell_result.money_gained);
+			add_artisanal_revenue<true>(sell_result.money_gained);
 		} else {
-			pop.add_artisanal_revenue<false>(sell_result.money_gained);
+			add_artisanal_revenue<false>(sell_result.money_gained);
 		}
 		artisan.subtract_from_stockpile(sell_result.good_index, sell_result.quantity_sold);
 	}
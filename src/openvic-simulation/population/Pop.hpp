@@ -1,23 +1,28 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <optional>
+#include <span>
 
 #include <type_safe/strong_typedef.hpp>
 
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/portable/ForwardableSpan.hpp"
 #include "openvic-simulation/economy/production/ArtisanalProducer.hpp"
+#include "openvic-simulation/economy/trading/BuyResult.hpp"
+#include "openvic-simulation/economy/trading/SellResult.hpp"
 #include "openvic-simulation/population/PopIdInProvince.hpp"
 #include "openvic-simulation/population/PopNeedsMacro.hpp"
 #include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/population/SparseSupportVector.hpp"
 #include "openvic-simulation/types/fixed_point/Atomic.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
 #include "openvic-simulation/types/UnitBranchType.hpp"
 
 namespace OpenVic {
-	struct BuyResult;
 	struct CountryInstance;
 	struct CountryParty;
 	struct Culture;
@@ -25,16 +30,17 @@ namespace OpenVic {
 	struct MilitaryDefines;
 	struct PopDeps;
 	struct PopManager;
+	struct PopMovement;
 	struct PopType;
 	struct PopValuesFromProvince;
 	struct ProvinceInstance;
 	struct RebelType;
 	struct Reform;
 	struct Religion;
-	struct SellResult;
 
 	struct PopBase {
 		friend PopManager;
+		friend PopMovement;
 
 	protected:
 		std::reference_wrapper<const PopType> PROPERTY_ACCESS(type, protected);
@@ -75,6 +81,8 @@ namespace OpenVic {
 	 * POP-18, POP-19, POP-20, POP-21, POP-34, POP-35, POP-36, POP-37
 	 */
 	struct Pop : PopBase {
+		friend PopMovement;
+
 		enum struct culture_status_t : uint8_t {
 			UNACCEPTED, ACCEPTED, PRIMARY
 		};
@@ -120,9 +128,11 @@ namespace OpenVic {
 		// All of these should have a total size equal to the pop size, allowing the distributions from different pops to be
 		// added together with automatic weighting based on their relative sizes. Similarly, the province, state and country
 		// equivalents of these distributions will have a total size equal to their total population size.
-		memory::FixedVector<fixed_point_t, ideology_index_t> SPAN_PROPERTY(supporter_equivalents_by_ideology);
-		memory::FixedVector<fixed_point_t, party_policy_index_t> SPAN_PROPERTY(supporter_equivalents_by_party_policy);
-		memory::FixedVector<fixed_point_t, reform_index_t> SPAN_PROPERTY(supporter_equivalents_by_reform);
+		// Pops only store their non-zero entries, the aggregates stay dense.
+		SparseSupportVector<ideology_index_t> PROPERTY(supporter_equivalents_by_ideology);
+		SparseSupportVector<party_policy_index_t> PROPERTY(supporter_equivalents_by_party_policy);
+		SparseSupportVector<reform_index_t> PROPERTY(supporter_equivalents_by_reform);
+		// Parties without votes have no entry.
 		fixed_point_map_t<CountryParty const*> PROPERTY(vote_equivalents_by_party);
 
 	public:
@@ -131,7 +141,7 @@ namespace OpenVic {
 		fixed_point_t get_vote_equivalents_by_party(CountryParty const& party) const;
 
 		static constexpr pop_size_t size_denominator = 200000;
-		static constexpr size_t VECTORS_FOR_POP_TICK = 5;
+		static constexpr size_t VECTORS_FOR_POP_TICK = 4;
 
 		constexpr pop_size_t get_unemployed() const {
 			return size - employed;
@@ -140,17 +150,31 @@ namespace OpenVic {
 	private:
 		fixed_point_t PROPERTY(income);
 		fixed_point_t PROPERTY(savings);
-		moveable_atomic_fixed_point_t PROPERTY(cash);
-		moveable_atomic_fixed_point_t PROPERTY(expenses); //positive value means POP paid for goods. This is displayed * -1 in UI.
-		moveable_atomic_fixed_point_t PROPERTY(yesterdays_import_value);
-
+		fixed_point_t PROPERTY(cash);
+		fixed_point_t PROPERTY(expenses); //positive value means POP paid for goods. This is displayed * -1 in UI.
+		fixed_point_t PROPERTY(yesterdays_import_value);
+
+		// Trade results are only recorded by the market, the thread clearing a good writes the result
+		// into the slot of the order it belongs to. settle_trades applies them afterwards from the pop's own thread,
+		// in the order the orders were placed, so the money and needs fields don't need to be atomic.
+		// Slots are reserved before orders are placed as the orders point to them.
+		memory::vector<std::optional<BuyResult>> pending_buys;
+		memory::vector<std::optional<SellResult>> pending_sells;
+		// RGOs pay owners across the whole state while other provinces are ticking, so this is the one atomic
+		// and it's moved into rgo_owner_income by settle_trades.
+		moveable_atomic_fixed_point_t deferred_rgo_owner_income;
+
+		// Needs are stored per slot of the pop type's need list for that category (PopType::get_*_needs()),
+		// slot quantities are 0 for goods the pop isn't buying this tick.
 		#define NEED_MEMBERS(need_category) \
-			moveable_atomic_fixed_point_t need_category##_needs_acquired_quantity, need_category##_needs_desired_quantity; \
+			fixed_point_t need_category##_needs_acquired_quantity, need_category##_needs_desired_quantity; \
 			public: \
 				fixed_point_t get_##need_category##_needs_fulfilled() const; \
+				fixed_point_t get_##need_category##_need_quantity(const good_index_t good_index) const; \
+				bool is_##need_category##_need_fulfilled(const good_index_t good_index) const; \
 			private: \
-				fixed_point_map_t<good_index_t> PROPERTY(need_category##_needs); /* TODO pool? (if recalculating in UI is acceptable) */ \
-				ordered_map<good_index_t, bool> PROPERTY(need_category##_needs_fulfilled_goods);
+				memory::vector<fixed_point_t> SPAN_PROPERTY(need_category##_need_quantities); \
+				memory::vector<uint64_t> need_category##_needs_fulfilled_bits;
 
 		OV_DO_FOR_ALL_NEED_CATEGORIES(NEED_MEMBERS)
 		#undef NEED_MEMBERS
@@ -167,10 +191,11 @@ namespace OpenVic {
 		std::size_t PROPERTY(max_supported_regiments, 0);
 
 		memory::string get_pop_context_text() const;
-		void reserve_needs_fulfilled_goods();
-		void fill_needs_fulfilled_goods_with_false();
+		void resize_needs_to_pop_type();
+		void reset_needs();
 		void allocate_for_needs(
-			fixed_point_map_t<good_index_t> const& scaled_needs,
+			fixed_point_map_t<good_index_t> const& type_needs,
+			std::span<const fixed_point_t> need_quantities,
 			forwardable_span<fixed_point_t> money_to_spend_per_good,
 			memory::vector<fixed_point_t>& reusable_vector,
 			fixed_point_t& price_inverse_sum,
@@ -179,6 +204,7 @@ namespace OpenVic {
 		void pop_tick_without_cleanup(
 			PopValuesFromProvince const& shared_values,
 			RandomU32& random_number_generator,
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
@@ -190,9 +216,8 @@ namespace OpenVic {
 		template<bool IsTaxable>
 		void add_artisanal_revenue(const fixed_point_t revenue);
 
-		static void after_buy(void* actor, BuyResult const& buy_result);
-		//matching GoodMarketSellOrder::callback_t
-		static void after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector);
+		void settle_buy(BuyResult const& buy_result);
+		void settle_sell(SellResult const& sell_result);
 
 	public:
 		Pop(
@@ -227,12 +252,17 @@ namespace OpenVic {
 		void pop_tick(
 			PopValuesFromProvince const& shared_values,
 			RandomU32& random_number_generator,
+			const std::size_t order_buffer_index,
 			TypedSpan<good_index_t, char> reusable_goods_mask,
 			forwardable_span<
 				memory::vector<fixed_point_t>,
 				VECTORS_FOR_POP_TICK
 			> reusable_vectors
 		);
+		//Applies the results of the orders placed in pop_tick, call once the market has executed them.
+		void settle_trades();
+		//Thread safe, applied by settle_trades.
+		void defer_rgo_owner_income(const fixed_point_t amount);
 		void allocate_cash_for_artisanal_spending(const fixed_point_t money_to_spend);
 		void hire(pop_size_t count);
 		//recruit or conscript
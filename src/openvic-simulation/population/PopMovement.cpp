@@ -0,0 +1,399 @@
+#include "PopMovement.hpp"
+
+#include <algorithm>
+
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/defines/PopsDefines.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopType.hpp"
+#include "openvic-simulation/population/SparseSupportVector.hpp"
+#include "openvic-simulation/types/fixed_point/Math.hpp"
+
+using namespace OpenVic;
+
+PopMovement::PopMovement(
+	forwardable_span<const PopType> pop_types,
+	PopsDefines const& pops_defines,
+	PopDeps const& new_pop_deps
+) : PopMovement {
+	pop_types,
+	[](PopType const& pop_type, PopType const& target_type) -> fixed_point_t {
+		PopType::poptype_weight_map_t const& promote_to = pop_type.get_promote_to();
+		return promote_to.get_keys().empty() || !promote_to.contains(target_type)
+			? fixed_point_t::_0
+			: promote_to.at(target_type).get_base();
+	},
+	pops_defines.get_promotion_scale(),
+	pops_defines.get_immigration_scale(),
+	new_pop_deps
+} {}
+
+PopMovement::PopMovement(
+	forwardable_span<const PopType> pop_types,
+	promotion_weight_func_t promotion_weights,
+	const fixed_point_t new_promotion_scale,
+	const fixed_point_t new_immigration_scale,
+	PopDeps const& new_pop_deps
+) : promotion_scale { new_promotion_scale },
+	immigration_scale { new_immigration_scale },
+	pop_deps { new_pop_deps },
+	promotion_targets_by_type(pop_types.size()),
+	demotion_targets_by_type(pop_types.size()) {
+	for (PopType const& pop_type : pop_types) {
+		memory::vector<promotion_target_t>& promotion_targets = promotion_targets_by_type[type_safe::get(pop_type.index)];
+		memory::vector<promotion_target_t>& demotion_targets = demotion_targets_by_type[type_safe::get(pop_type.index)];
+		fixed_point_t promotion_weight_sum = 0, demotion_weight_sum = 0;
+
+		for (PopType const& target_type : pop_types) {
+			const fixed_point_t weight = promotion_weights(pop_type, target_type);
+			if (weight <= 0 || &target_type == &pop_type) {
+				continue;
+			}
+
+			if (target_type.strata.index > pop_type.strata.index) {
+				promotion_targets.push_back({ &target_type, weight });
+				promotion_weight_sum += weight;
+			} else if (target_type.strata.index < pop_type.strata.index) {
+				demotion_targets.push_back({ &target_type, weight });
+				demotion_weight_sum += weight;
+			}
+		}
+
+		for (promotion_target_t& target : promotion_targets) {
+			target.share /= promotion_weight_sum;
+		}
+		for (promotion_target_t& target : demotion_targets) {
+			target.share /= demotion_weight_sum;
+		}
+	}
+}
+
+void PopMovement::find_country_targets(CountryInstance& country) {
+	country_targets_t& targets = targets_by_country[type_safe::get(country.index)];
+	targets = {};
+
+	//ties go to the lowest province index so the target doesn't depend on the owned_provinces order
+	const auto is_better_target = [](ProvinceInstance const& province, ProvinceInstance const* current) -> bool {
+		return current == nullptr
+			|| province.get_life_rating() > current->get_life_rating()
+			|| (
+				province.get_life_rating() == current->get_life_rating()
+				&& province.province_definition.index < current->province_definition.index
+			);
+	};
+
+	for (ProvinceInstance* province : country.get_owned_provinces()) {
+		ProvinceInstance*& target = province->is_colonial_province() ? targets.colonial_target : targets.internal_target;
+		if (is_better_target(*province, target)) {
+			target = province;
+		}
+	}
+}
+
+void PopMovement::stage_movement(
+	province_movements_t& province_movements,
+	Pop& pop,
+	const movement_type_t movement_type,
+	ProvinceInstance const& destination,
+	forwardable_span<ProvinceInstance> provinces,
+	PopType const& destination_type,
+	const pop_size_t count
+) {
+	const fixed_point_t cash_share = fp::mul_div(pop.cash, count, pop.size);
+
+	const auto take_shares = [&province_movements, &pop, count]<typename IndexT>(
+		SparseSupportVector<IndexT>& supporter_equivalents
+	) -> uint32_t {
+		const std::size_t first_share = province_movements.supporter_shares.size();
+		supporter_equivalents.take_share(
+			count, pop.size,
+			[&province_movements](const IndexT index, const fixed_point_t share) -> void {
+				province_movements.supporter_shares.push_back({ type_safe::get(index), share });
+			}
+		);
+		return static_cast<uint32_t>(province_movements.supporter_shares.size() - first_share);
+	};
+	const std::size_t supporter_shares_offset = province_movements.supporter_shares.size();
+	const uint32_t ideology_share_count = take_shares(pop.supporter_equivalents_by_ideology);
+	const uint32_t party_policy_share_count = take_shares(pop.supporter_equivalents_by_party_policy);
+	const uint32_t reform_share_count = take_shares(pop.supporter_equivalents_by_reform);
+
+	province_movements.movements.push_back({
+		.destination_province = static_cast<std::size_t>(&destination - provinces.data()),
+		.type = &destination_type,
+		.culture = &pop.culture,
+		.religion = &pop.religion,
+		.rebel_type = pop.rebel_type,
+		.size = count,
+		.militancy = pop.militancy,
+		.consciousness = pop.consciousness,
+		.literacy = pop.literacy,
+		.cash = cash_share,
+		.supporter_shares_offset = supporter_shares_offset,
+		.ideology_share_count = ideology_share_count,
+		.party_policy_share_count = party_policy_share_count,
+		.reform_share_count = reform_share_count,
+		.movement_type = movement_type
+	});
+
+	pop.cash -= cash_share;
+	pop.size -= count;
+	pop.total_change -= count;
+}
+
+void PopMovement::emigrate_province_pops(
+	forwardable_span<ProvinceInstance> provinces, const std::size_t province_index
+) {
+	ProvinceInstance& province = provinces[province_index];
+	province_movements_t& province_movements = movements_by_source[province_index];
+	province_movements.movements.clear();
+	province_movements.supporter_shares.clear();
+
+	CountryInstance const* const owner = province.get_owner();
+	country_targets_t const* const targets = owner == nullptr ? nullptr : &targets_by_country[type_safe::get(owner->index)];
+
+	for (Pop& pop : province.get_mutable_pops()) {
+		pop.total_change = pop.num_grown;
+		pop.num_promoted = 0;
+		pop.num_demoted = 0;
+		pop.num_migrated_internal = 0;
+		pop.num_migrated_external = 0;
+		pop.num_migrated_colonial = 0;
+
+		//every source pop keeps at least 1 member
+		pop_size_t available = pop.size - 1;
+		if (available <= 0) {
+			continue;
+		}
+
+		PopType const& pop_type = pop.get_type();
+		const std::size_t type_index = type_safe::get(pop_type.index);
+
+		const auto move_to_types = [&](
+			memory::vector<promotion_target_t> const& type_targets, const fixed_point_t rate, const movement_type_t movement_type
+		) -> pop_size_t {
+			const pop_size_t total = std::min(available, pop_size_t { (pop.size * rate).floor<int32_t>() });
+			pop_size_t moved = 0;
+			if (total <= 0) {
+				return moved;
+			}
+			for (promotion_target_t const& target : type_targets) {
+				const pop_size_t count = pop_size_t { (total * target.share).floor<int32_t>() };
+				if (count > 0) {
+					stage_movement(province_movements, pop, movement_type, province, provinces, *target.type, count);
+					moved += count;
+				}
+			}
+			available -= moved;
+			return moved;
+		};
+
+		const fixed_point_t life_needs_fulfilled = pop.get_life_needs_fulfilled();
+		if (life_needs_fulfilled < fixed_point_t::_1) {
+			pop.num_demoted = -move_to_types(
+				demotion_targets_by_type[type_index],
+				promotion_scale * (fixed_point_t::_1 - life_needs_fulfilled),
+				movement_type_t::DEMOTION
+			);
+		} else {
+			pop.num_promoted = -move_to_types(
+				promotion_targets_by_type[type_index],
+				promotion_scale * pop.get_everyday_needs_fulfilled(),
+				movement_type_t::PROMOTION
+			);
+		}
+
+		if (targets == nullptr || available <= 0 || !pop_type.can_be_unemployed) {
+			continue;
+		}
+
+		//unemployed pops move to their owner's best province, colonies only take accepted cultures
+		ProvinceInstance const* destination = nullptr;
+		movement_type_t movement_type = movement_type_t::MIGRATION_INTERNAL;
+		if (
+			targets->colonial_target != nullptr && pop.culture_status != Pop::culture_status_t::UNACCEPTED
+			&& targets->colonial_target->get_life_rating() > province.get_life_rating()
+		) {
+			destination = targets->colonial_target;
+			movement_type = movement_type_t::MIGRATION_COLONIAL;
+		} else if (
+			targets->internal_target != nullptr && targets->internal_target->get_life_rating() > province.get_life_rating()
+		) {
+			destination = targets->internal_target;
+		}
+
+		if (destination == nullptr) {
+			continue;
+		}
+
+		const pop_size_t count = std::min(
+			available, pop_size_t { (pop.get_unemployed() * immigration_scale).floor<int32_t>() }
+		);
+		if (count <= 0) {
+			continue;
+		}
+
+		stage_movement(province_movements, pop, movement_type, *destination, provinces, pop_type, count);
+		if (movement_type == movement_type_t::MIGRATION_COLONIAL) {
+			pop.num_migrated_colonial = -count;
+		} else {
+			pop.num_migrated_internal = -count;
+		}
+	}
+
+	//leavers are taken from the unemployed first
+	for (Pop& pop : province.get_mutable_pops()) {
+		pop.employed = std::min(pop.employed, pop.size);
+	}
+
+	if (!province_movements.movements.empty()) {
+		province.mark_pop_supporters_changed();
+	}
+}
+
+void PopMovement::immigrate_province_pops(
+	forwardable_span<ProvinceInstance> provinces, const std::size_t province_index,
+	memory::vector<Pop*>& created_pops
+) {
+	ProvinceInstance& province = provinces[province_index];
+	created_pops.clear();
+
+	const auto find_matching_pop = [&province, &created_pops](movement_t const& movement) -> Pop* {
+		for (Pop* pop : province.get_pops_by_type()[movement.type->index]) {
+			if (&pop->culture == movement.culture && &pop->religion == movement.religion) {
+				return pop;
+			}
+		}
+		for (Pop* pop : created_pops) {
+			if (&pop->get_type() == movement.type && &pop->culture == movement.culture && &pop->religion == movement.religion) {
+				return pop;
+			}
+		}
+		return nullptr;
+	};
+
+	for (std::size_t i = destination_offsets[province_index]; i < destination_offsets[province_index + 1]; ++i) {
+		const auto [source_index, movement_index] = movements_by_destination[i];
+		province_movements_t const& source_movements = movements_by_source[source_index];
+		movement_t const& movement = source_movements.movements[movement_index];
+		supporter_share_t const* supporter_share = source_movements.supporter_shares.data() + movement.supporter_shares_offset;
+
+		Pop* pop = find_matching_pop(movement);
+		if (pop == nullptr) {
+			pop = province.add_pop(
+				PopBase {
+					*movement.type, *movement.culture, *movement.religion, 0,
+					movement.militancy, movement.consciousness, movement.rebel_type
+				},
+				pop_deps
+			);
+			if (pop == nullptr) {
+				continue;
+			}
+			pop->update_location_based_attributes();
+			created_pops.push_back(pop);
+		}
+
+		const pop_size_t new_size = pop->size + movement.size;
+		pop->militancy = (pop->militancy * pop->size + movement.militancy * movement.size) / new_size;
+		pop->consciousness = (pop->consciousness * pop->size + movement.consciousness * movement.size) / new_size;
+		pop->literacy = (pop->literacy * pop->size + movement.literacy * movement.size) / new_size;
+		pop->size = new_size;
+		pop->cash += movement.cash;
+		pop->total_change += movement.size;
+
+		const auto add_shares = [&supporter_share]<typename IndexT>(
+			SparseSupportVector<IndexT>& supporter_equivalents, const uint32_t share_count
+		) -> void {
+			for (supporter_share_t const* const end = supporter_share + share_count; supporter_share != end; ++supporter_share) {
+				supporter_equivalents.add(IndexT { supporter_share->index }, supporter_share->value);
+			}
+		};
+		add_shares(pop->supporter_equivalents_by_ideology, movement.ideology_share_count);
+		add_shares(pop->supporter_equivalents_by_party_policy, movement.party_policy_share_count);
+		add_shares(pop->supporter_equivalents_by_reform, movement.reform_share_count);
+
+		switch (movement.movement_type) {
+			using enum movement_type_t;
+			case PROMOTION:
+				pop->num_promoted += movement.size;
+				break;
+			case DEMOTION:
+				pop->num_demoted += movement.size;
+				break;
+			case MIGRATION_INTERNAL:
+				pop->num_migrated_internal += movement.size;
+				break;
+			case MIGRATION_COLONIAL:
+				pop->num_migrated_colonial += movement.size;
+				break;
+		}
+	}
+
+	if (destination_offsets[province_index] != destination_offsets[province_index + 1]) {
+		province.mark_pop_supporters_changed();
+	}
+}
+
+void PopMovement::pop_movement_tick(
+	forwardable_span<ProvinceInstance> provinces,
+	std::span<CountryInstance> countries,
+	ecs::EcsThreadPool& executor
+) {
+	targets_by_country.resize(countries.size());
+	executor.parallel_for(
+		countries.size(),
+		[this, &countries](const std::size_t country_index, const uint32_t /*worker_id*/) -> void {
+			find_country_targets(countries[country_index]);
+		}
+	);
+
+	//sources only write to their own pops and movement buffer
+	movements_by_source.resize(provinces.size());
+	executor.parallel_for(
+		provinces.size(),
+		[this, &provinces](const std::size_t province_index, const uint32_t /*worker_id*/) -> void {
+			emigrate_province_pops(provinces, province_index);
+		}
+	);
+
+	//Group movements by destination with a stable counting sort, so each destination receives its arrivals
+	//in source province order then source pop order, exactly like a serial loop would.
+	destination_offsets.assign(provinces.size() + 1, 0);
+	for (province_movements_t const& province_movements : movements_by_source) {
+		for (movement_t const& movement : province_movements.movements) {
+			++destination_offsets[movement.destination_province + 1];
+		}
+	}
+	for (std::size_t province_index = 0; province_index < provinces.size(); ++province_index) {
+		destination_offsets[province_index + 1] += destination_offsets[province_index];
+	}
+
+	movements_by_destination.resize(destination_offsets.back());
+	destination_cursors.assign(destination_offsets.begin(), destination_offsets.end() - 1);
+	for (std::size_t source_index = 0; source_index < movements_by_source.size(); ++source_index) {
+		memory::vector<movement_t> const& movements = movements_by_source[source_index].movements;
+		for (std::size_t movement_index = 0; movement_index < movements.size(); ++movement_index) {
+			movements_by_destination[destination_cursors[movements[movement_index].destination_province]++] = {
+				source_index, movement_index
+			};
+		}
+	}
+
+	if (movements_by_destination.empty()) {
+		return;
+	}
+
+	//destinations only write to their own pops
+	created_pops_by_worker.resize(executor.worker_count());
+	executor.parallel_for(
+		provinces.size(),
+		[this, &provinces](const std::size_t province_index, const uint32_t worker_id) -> void {
+			if (destination_offsets[province_index] != destination_offsets[province_index + 1]) {
+				immigrate_province_pops(provinces, province_index, created_pops_by_worker[worker_id]);
+			}
+		}
+	);
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include <function2/function2.hpp>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/portable/ForwardableSpan.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic::ecs {
+	class EcsThreadPool;
+}
+
+namespace OpenVic {
+	struct CountryInstance;
+	struct Culture;
+	struct Pop;
+	struct PopDeps;
+	struct PopsDefines;
+	struct PopType;
+	struct ProvinceInstance;
+	struct RebelType;
+	struct Religion;
+
+	/* Daily promotion, demotion and migration for every pop in the world, in three parallel passes:
+	 * 1. each country picks its best internal and colonial migration target provinces,
+	 * 2. each province computes the flows of its own pops, takes them out of the sources and stages them as movements,
+	 * 3. movements are grouped by destination with a stable counting sort and each destination merges its arrivals
+	 *    into a pop of the same type, culture and religion, creating a new pop if there is none.
+	 * Arrivals are applied in source province order then source pop order, so the result doesn't depend on the worker count.
+	 * Source pops always keep at least 1 member, so pops are never removed and their regiments are never orphaned. */
+	struct PopMovement {
+	private:
+		enum struct movement_type_t : uint8_t {
+			PROMOTION, DEMOTION, MIGRATION_INTERNAL, MIGRATION_COLONIAL
+		};
+
+		struct movement_t {
+			std::size_t destination_province;
+			PopType const* type;
+			Culture const* culture;
+			Religion const* religion;
+			RebelType const* rebel_type;
+			pop_size_t size;
+			fixed_point_t militancy;
+			fixed_point_t consciousness;
+			fixed_point_t literacy;
+			fixed_point_t cash;
+			// Into supporter_shares of the source province, ideologies then party policies then reforms.
+			std::size_t supporter_shares_offset;
+			uint32_t ideology_share_count;
+			uint32_t party_policy_share_count;
+			uint32_t reform_share_count;
+			movement_type_t movement_type;
+		};
+
+		// Pops only carry their non-zero supporter equivalents, so the shares that move are sparse too.
+		struct supporter_share_t {
+			uint32_t index;
+			fixed_point_t value;
+		};
+
+		struct province_movements_t {
+			memory::vector<movement_t> movements;
+			memory::vector<supporter_share_t> supporter_shares;
+		};
+
+		struct promotion_target_t {
+			PopType const* type;
+			// Share of the pops promoting or demoting out of the source type, all shares of a type sum to 1.
+			fixed_point_t share;
+		};
+
+		struct country_targets_t {
+			ProvinceInstance* internal_target = nullptr;
+			ProvinceInstance* colonial_target = nullptr;
+		};
+
+		const fixed_point_t promotion_scale;
+		const fixed_point_t immigration_scale;
+		PopDeps const& pop_deps;
+
+		memory::vector<memory::vector<promotion_target_t>> promotion_targets_by_type;
+		memory::vector<memory::vector<promotion_target_t>> demotion_targets_by_type;
+
+		memory::vector<country_targets_t> targets_by_country;
+		memory::vector<province_movements_t> movements_by_source;
+		memory::vector<std::size_t> destination_offsets;
+		memory::vector<std::size_t> destination_cursors;
+		// Pairs of source province and movement index, grouped by destination province.
+		memory::vector<std::pair<std::size_t, std::size_t>> movements_by_destination;
+		// Pops a destination created this tick, one reused vector per worker.
+		memory::vector<memory::vector<Pop*>> created_pops_by_worker;
+
+		void find_country_targets(CountryInstance& country);
+		void emigrate_province_pops(
+			forwardable_span<ProvinceInstance> provinces, const std::size_t province_index
+		);
+		void stage_movement(
+			province_movements_t& province_movements,
+			Pop& pop,
+			const movement_type_t movement_type,
+			ProvinceInstance const& destination,
+			forwardable_span<ProvinceInstance> provinces,
+			PopType const& destination_type,
+			const pop_size_t count
+		);
+		void immigrate_province_pops(
+			forwardable_span<ProvinceInstance> provinces, const std::size_t province_index,
+			memory::vector<Pop*>& created_pops
+		);
+
+	public:
+		// The weight of pops of the first type moving to the second, pops only promote or demote to another strata.
+		using promotion_weight_func_t = fu2::function_view<fixed_point_t(PopType const&, PopType const&) const>;
+
+		// Only the base weights of promote_to are used, the weight scripts aren't evaluated.
+		PopMovement(
+			forwardable_span<const PopType> pop_types,
+			PopsDefines const& pops_defines,
+			PopDeps const& new_pop_deps
+		);
+		PopMovement(
+			forwardable_span<const PopType> pop_types,
+			promotion_weight_func_t promotion_weights,
+			const fixed_point_t new_promotion_scale,
+			const fixed_point_t new_immigration_scale,
+			PopDeps const& new_pop_deps
+		);
+
+		void pop_movement_tick(
+			forwardable_span<ProvinceInstance> provinces,
+			std::span<CountryInstance> countries,
+			ecs::EcsThreadPool& executor
+		);
+	};
+}
@@ -0,0 +1,64 @@
+#include "PopStore.hpp"
+
+#include "openvic-simulation/population/Culture.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopType.hpp"
+#include "openvic-simulation/population/Religion.hpp"
+
+using namespace OpenVic;
+
+void PopStore::clear() {
+	pops.clear();
+	type_indices.clear();
+	strata_indices.clear();
+	culture_indices.clear();
+	religion_indices.clear();
+	sizes.clear();
+	unemployed.clear();
+	literacy.clear();
+	consciousness.clear();
+	militancy.clear();
+	yesterdays_import_value.clear();
+	life_needs_fulfilled.clear();
+	everyday_needs_fulfilled.clear();
+	luxury_needs_fulfilled.clear();
+	recruitable_regiments.clear();
+}
+
+void PopStore::reserve(const std::size_t count) {
+	pops.reserve(count);
+	type_indices.reserve(count);
+	strata_indices.reserve(count);
+	culture_indices.reserve(count);
+	religion_indices.reserve(count);
+	sizes.reserve(count);
+	unemployed.reserve(count);
+	literacy.reserve(count);
+	consciousness.reserve(count);
+	militancy.reserve(count);
+	yesterdays_import_value.reserve(count);
+	life_needs_fulfilled.reserve(count);
+	everyday_needs_fulfilled.reserve(count);
+	luxury_needs_fulfilled.reserve(count);
+	recruitable_regiments.reserve(count);
+}
+
+void PopStore::push_back(Pop& pop) {
+	PopType const& pop_type = pop.get_type();
+
+	pops.push_back(&pop);
+	type_indices.push_back(pop_type.index);
+	strata_indices.push_back(pop_type.strata.index);
+	culture_indices.push_back(pop.culture.index);
+	religion_indices.push_back(pop.religion.index);
+	sizes.push_back(pop.get_size());
+	unemployed.push_back(pop.get_unemployed());
+	literacy.push_back(pop.get_literacy());
+	consciousness.push_back(pop.get_consciousness());
+	militancy.push_back(pop.get_militancy());
+	yesterdays_import_value.push_back(pop.get_yesterdays_import_value());
+	life_needs_fulfilled.push_back(pop.get_life_needs_fulfilled());
+	everyday_needs_fulfilled.push_back(pop.get_everyday_needs_fulfilled());
+	luxury_needs_fulfilled.push_back(pop.get_luxury_needs_fulfilled());
+	recruitable_regiments.push_back(pop_type.can_be_recruited ? pop.get_max_supported_regiments() : 0);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	struct Pop;
+
+	/* Columnar copy of the fields of a province's pops that PopsAggregate reads, one array per field.
+	 * Row i of every column belongs to the pop at get_pops()[i], rows follow the province's pop iteration order.
+	 * Filled once per gamestate update, after the pops themselves are updated, so aggregation passes can stream
+	 * through contiguous arrays instead of visiting every Pop with its maps and optionals.
+	 * The Pop remains the owner of the values, the store must be refilled whenever pops change.
+	 * Provinces also keep the previous update's store, so columns the aggregate doesn't read don't belong here. */
+	struct PopStore {
+	private:
+		memory::vector<Pop*> SPAN_PROPERTY(pops);
+		memory::vector<pop_type_index_t> SPAN_PROPERTY(type_indices);
+		memory::vector<strata_index_t> SPAN_PROPERTY(strata_indices);
+		memory::vector<culture_index_t> SPAN_PROPERTY(culture_indices);
+		memory::vector<religion_index_t> SPAN_PROPERTY(religion_indices);
+		memory::vector<pop_size_t> SPAN_PROPERTY(sizes);
+		memory::vector<pop_size_t> SPAN_PROPERTY(unemployed);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(literacy);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(consciousness);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(militancy);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(yesterdays_import_value);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(life_needs_fulfilled);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(everyday_needs_fulfilled);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(luxury_needs_fulfilled);
+		// 0 for pops which cannot be recruited
+		memory::vector<std::size_t> SPAN_PROPERTY(recruitable_regiments);
+
+	public:
+		void clear();
+		void reserve(const std::size_t count);
+		void push_back(Pop& pop);
+
+		inline std::size_t size() const {
+			return pops.size();
+		}
+		inline bool empty() const {
+			return pops.empty();
+		}
+	};
+}
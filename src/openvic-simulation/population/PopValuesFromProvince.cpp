@@ -1,5 +1,6 @@
 #include "PopValuesFromProvince.hpp"
 #include <algorithm>
+#include <span>
 
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/defines/PopsDefines.hpp"
@@ -8,6 +9,9 @@
 #include "openvic-simulation/economy/production/ProductionType.hpp"
 #include "openvic-simulation/modifier/ModifierEffectCache.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopsByType.hpp"
+#include "openvic-simulation/population/PopType.hpp"
 #include "openvic-simulation/misc/GameRulesManager.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 
@@ -40,6 +44,32 @@ void PopStrataValuesFromProvince::update_pop_strata_values_from_province(
 		* (fixed_point_t::_1 + province.get_modifier_effect_value(*strata_effects.get_luxury_needs()));
 }
 
+void PopTypeValuesFromProvince::update_pop_type_values_from_province(
+	GoodInstanceManager const& good_instance_manager,
+	PopType const& pop_type
+) {
+	#define UPDATE_NEEDS(need_category) \
+		available_##need_category##_needs.clear(); \
+		{ \
+			fixed_point_map_t<good_index_t> const& type_needs = pop_type.get_##need_category##_needs(); \
+			for (auto it = type_needs.begin(); it < type_needs.end(); it++) { \
+				GoodInstance const& good_instance = *good_instance_manager.get_good_instance_by_index(it.key()); \
+				if (!good_instance.get_is_available()) { \
+					continue; \
+				} \
+				available_##need_category##_needs.push_back({ \
+					it.key(), \
+					static_cast<std::size_t>(it - type_needs.begin()), \
+					it.value(), \
+					good_instance.get_price_inverse() \
+				}); \
+			} \
+		}
+
+	OV_DO_FOR_ALL_NEED_CATEGORIES(UPDATE_NEEDS)
+	#undef UPDATE_NEEDS
+}
+
 PopValuesFromProvince::PopValuesFromProvince(
 	GameRulesManager const& new_game_rules_manager,
 	GoodInstanceManager const& new_good_instance_manager,
@@ -62,6 +92,18 @@ void PopValuesFromProvince::update_pop_values_from_province(ProvinceInstance& pr
 		values.update_pop_strata_values_from_province(defines, modifier_effect_cache, province);
 	}
 
+	PopsByType const& pops_by_type = province.get_pops_by_type();
+	values_by_pop_type.resize(type_safe::get(pops_by_type.size()));
+	for (pop_type_index_t pop_type_index {}; pop_type_index < pops_by_type.size(); ++pop_type_index) {
+		std::span<Pop* const> pops_of_type = pops_by_type[pop_type_index];
+		if (!pops_of_type.empty()) {
+			values_by_pop_type[type_safe::get(pop_type_index)].update_pop_type_values_from_province(
+				good_instance_manager,
+				pops_of_type.front()->get_type()
+			);
+		}
+	}
+
 	max_cost_multiplier = 1;	
 	CountryInstance* const country_to_report_economy_nullable = province.get_country_to_report_economy();
 	if (country_to_report_economy_nullable != nullptr) {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
+
 #include "openvic-simulation/core/memory/FixedVector.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/population/PopNeedsMacro.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
@@ -14,6 +17,7 @@ namespace OpenVic {
 	struct ProductionTypeManager;
 	struct ProvinceInstance;
 	struct PopsDefines;
+	struct PopType;
 	struct PopValuesFromProvince;
 	struct Strata;
 
@@ -34,6 +38,32 @@ namespace OpenVic {
 		);
 	};
 
+	//Per pop type work shared by all pops of that type in a province, so a pop's needs only cost
+	//a multiply and divide per good instead of a map walk plus market lookups.
+	struct PopTypeValuesFromProvince {
+		struct need_t {
+			good_index_t good_index;
+			//position in the pop type's needs for this category, matches Pop::get_*_need_quantities
+			std::size_t slot;
+			fixed_point_t base_quantity;
+			fixed_point_t price_inverse;
+		};
+
+	private:
+		#define NEED_VALUES(need_category) \
+			memory::vector<need_t> SPAN_PROPERTY(available_##need_category##_needs);
+
+		OV_DO_FOR_ALL_NEED_CATEGORIES(NEED_VALUES)
+		#undef NEED_VALUES
+
+	public:
+		//Keeps only goods available on the market, in the pop type's order.
+		void update_pop_type_values_from_province(
+			GoodInstanceManager const& good_instance_manager,
+			PopType const& pop_type
+		);
+	};
+
 	struct PopValuesFromProvince {
 	private:
 		GoodInstanceManager const& good_instance_manager;
@@ -41,6 +71,8 @@ namespace OpenVic {
 		ProductionTypeManager const& production_type_manager;
 		fixed_point_t PROPERTY(max_cost_multiplier);
 		memory::FixedVector<PopStrataValuesFromProvince, strata_index_t> PROPERTY(effects_by_strata);
+		//only updated for pop types present in the province
+		memory::vector<PopTypeValuesFromProvince> values_by_pop_type;
 		//excludes availability of goods on market
 		memory::vector<std::pair<ProductionType const*, fixed_point_t>> SPAN_PROPERTY(ranked_artisanal_production_types);
 	public:
@@ -57,5 +89,9 @@ namespace OpenVic {
 		);
 
 		void update_pop_values_from_province(ProvinceInstance& province);
+
+		inline PopTypeValuesFromProvince const& get_pop_type_values(const pop_type_index_t pop_type_index) const {
+			return values_by_pop_type[type_safe::get(pop_type_index)];
+		}
 	};
 }
\ No newline at end of file
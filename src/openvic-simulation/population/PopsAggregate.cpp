@@ -1,15 +1,19 @@
 #include "PopsAggregate.hpp"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 
 #include <type_safe/strong_typedef.hpp>
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/population/Culture.hpp"
 #include "openvic-simulation/population/Pop.hpp"
 #include "openvic-simulation/population/PopsAggregateDeps.hpp"
+#include "openvic-simulation/population/PopStore.hpp"
 #include "openvic-simulation/population/PopType.hpp"
+#include "openvic-simulation/population/Religion.hpp"
 #include "openvic-simulation/types/ConstructorTags.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/OrderedContainersMath.hpp"
@@ -29,7 +33,27 @@ PopsAggregate::PopsAggregate(PopsAggregateDeps const& deps)
 	unemployed_pops_by_type { generate_values, deps.pop_type_count },
 	supporter_equivalents_by_ideology { generate_values, deps.ideology_count },
 	supporter_equivalents_by_party_policy { generate_values, deps.party_policy_count },
-	supporter_equivalents_by_reform { generate_values, deps.reform_count } {}
+	supporter_equivalents_by_reform { generate_values, deps.reform_count },
+	population_by_culture { generate_values, deps.culture_count },
+	population_by_religion { generate_values, deps.religion_count },
+	contributed_values { deps },
+	contributed_breakdowns { deps } {}
+
+PopsAggregate::contributed_values_t::contributed_values_t(PopsAggregateDeps const& deps)
+  : militancy_by_strata_raw { generate_values, deps.strata_count },
+	life_needs_fulfilled_by_strata_raw { generate_values, deps.strata_count },
+	everyday_needs_fulfilled_by_strata_raw { generate_values, deps.strata_count },
+	luxury_needs_fulfilled_by_strata_raw { generate_values, deps.strata_count },
+	unemployed_pops_by_type { generate_values, deps.pop_type_count } {}
+
+PopsAggregate::contributed_breakdowns_t::contributed_breakdowns_t(PopsAggregateDeps const& deps)
+  : population_by_strata { generate_values, deps.strata_count },
+	population_by_type { generate_values, deps.pop_type_count },
+	supporter_equivalents_by_ideology { generate_values, deps.ideology_count },
+	supporter_equivalents_by_party_policy { generate_values, deps.party_policy_count },
+	supporter_equivalents_by_reform { generate_values, deps.reform_count },
+	population_by_culture { generate_values, deps.culture_count },
+	population_by_religion { generate_values, deps.religion_count } {}
 
 fixed_point_t PopsAggregate::get_vote_equivalents_by_party(CountryParty const& party) const {
 	const decltype(vote_equivalents_by_party)::const_iterator it = vote_equivalents_by_party.find(&party);
@@ -39,22 +63,10 @@ fixed_point_t PopsAggregate::get_vote_equivalents_by_party(CountryParty const& p
 	return it.value();
 }
 pop_sum_t PopsAggregate::get_population_by_culture(Culture const& culture) const {
-	const decltype(population_by_culture)::const_iterator it = population_by_culture.find(&culture);
-
-	if (it != population_by_culture.end()) {
-		return it->second;
-	} else {
-		return 0;
-	}
+	return population_by_culture[culture.index];
 }
 pop_sum_t PopsAggregate::get_population_by_religion(Religion const& religion) const {
-	const decltype(population_by_religion)::const_iterator it = population_by_religion.find(&religion);
-
-	if (it != population_by_religion.end()) {
-		return it->second;
-	} else {
-		return 0;
-	}
+	return population_by_religion[religion.index];
 }
 
 template <typename... Vectors>
@@ -88,12 +100,16 @@ void PopsAggregate::clear_pops_aggregate() {
 		unemployed_pops_by_type,
 		supporter_equivalents_by_ideology,
 		supporter_equivalents_by_party_policy,
-		supporter_equivalents_by_reform
+		supporter_equivalents_by_reform,
+		population_by_culture,
+		population_by_religion
 	);
 
 	vote_equivalents_by_party.clear();
-	population_by_culture.clear();
-	population_by_religion.clear();
+}
+
+constexpr boost::int128::int128_t running_total_raw_128(const pop_sum_t part_population, const fixed_point_t average) {
+	return type_safe::get(part_population) * static_cast<boost::int128::int128_t>(average.get_raw_value());
 }
 
 constexpr void update_running_total_raw_128 (
@@ -101,153 +117,358 @@ constexpr void update_running_total_raw_128 (
 	const pop_sum_t part_population,
 	const fixed_point_t average
 ) {
-	running_total_raw += type_safe::get(part_population) * static_cast<boost::int128::int128_t>(average.get_raw_value());
+	running_total_raw += running_total_raw_128(part_population, average);
 };
 
-constexpr void add(std::span<pop_sum_t> total, std::span<const pop_sum_t> part) {
-	std::transform(total.begin(), total.end(), part.begin(), total.begin(), std::plus<pop_sum_t>());
+template<bool Subtract, typename T>
+constexpr void add(std::span<T> total, std::span<const T> part) {
+	if constexpr (Subtract) {
+		std::transform(total.begin(), total.end(), part.begin(), total.begin(), std::minus<T>());
+	} else {
+		std::transform(total.begin(), total.end(), part.begin(), total.begin(), std::plus<T>());
+	}
 }
-constexpr void add(std::span<fixed_point_t> total, std::span<const fixed_point_t> part) {
-	std::transform(total.begin(), total.end(), part.begin(), total.begin(), std::plus<fixed_point_t>());
+
+template<bool Subtract, typename T>
+constexpr void add(T& total, const T part) {
+	if constexpr (Subtract) {
+		total -= part;
+	} else {
+		total += part;
+	}
+}
+
+template<typename Dst, typename Src>
+constexpr void copy_values(Dst& dst, Src const& src) {
+	std::copy(src.begin(), src.end(), dst.begin());
 }
 
-void PopsAggregate::add_pops_aggregate(PopsAggregate& part) {
-	total_population += part.get_total_population();
-	max_supported_regiment_count += part.get_max_supported_regiment_count();
-	_yesterdays_import_value_running_total += part.get_yesterdays_import_value_untracked();
-
-	const pop_sum_t part_population = part.get_total_population();
-	update_running_total_raw_128(literacy_running_total_raw, part_population, part.get_average_literacy());
-	update_running_total_raw_128(consciousness_running_total_raw, part_population, part.get_average_consciousness());
-	update_running_total_raw_128(militancy_running_total_raw, part_population, part.get_average_militancy());
-
-	{
-		strata_index_t strata_index {};
-		for (const pop_sum_t strata_population : part.get_population_by_strata()) {
-			population_by_strata[strata_index] += strata_population;
-			update_running_total_raw_128(
-				militancy_by_strata_running_total_raw[strata_index],
-				strata_population,
-				part.militancy_by_strata[strata_index]
-			);
-			update_running_total_raw_128(
-				life_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population,
-				part.life_needs_fulfilled_by_strata[strata_index]
-			);
-			update_running_total_raw_128(
-				everyday_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population,
-				part.everyday_needs_fulfilled_by_strata[strata_index]
-			);
-			update_running_total_raw_128(
-				luxury_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population,
-				part.luxury_needs_fulfilled_by_strata[strata_index]
-			);
-			++strata_index;
+void PopsAggregate::_update_contributed_values() {
+	contributed_values.max_supported_regiment_count = max_supported_regiment_count;
+	contributed_values.yesterdays_import_value = get_yesterdays_import_value_untracked();
+	contributed_values.literacy_raw = running_total_raw_128(total_population, average_literacy);
+	contributed_values.consciousness_raw = running_total_raw_128(total_population, average_consciousness);
+	contributed_values.militancy_raw = running_total_raw_128(total_population, average_militancy);
+
+	strata_index_t strata_index {};
+	for (const pop_sum_t strata_population : population_by_strata) {
+		contributed_values.militancy_by_strata_raw[strata_index] =
+			running_total_raw_128(strata_population, militancy_by_strata[strata_index]);
+		contributed_values.life_needs_fulfilled_by_strata_raw[strata_index] =
+			running_total_raw_128(strata_population, life_needs_fulfilled_by_strata[strata_index]);
+		contributed_values.everyday_needs_fulfilled_by_strata_raw[strata_index] =
+			running_total_raw_128(strata_population, everyday_needs_fulfilled_by_strata[strata_index]);
+		contributed_values.luxury_needs_fulfilled_by_strata_raw[strata_index] =
+			running_total_raw_128(strata_population, luxury_needs_fulfilled_by_strata[strata_index]);
+		++strata_index;
+	}
+
+	copy_values(contributed_values.unemployed_pops_by_type, unemployed_pops_by_type);
+}
+
+void PopsAggregate::_update_contributed_breakdowns() {
+	contributed_breakdowns.total_population = total_population;
+	copy_values(contributed_breakdowns.population_by_strata, population_by_strata);
+	copy_values(contributed_breakdowns.population_by_type, population_by_type);
+	copy_values(contributed_breakdowns.supporter_equivalents_by_ideology, supporter_equivalents_by_ideology);
+	copy_values(contributed_breakdowns.supporter_equivalents_by_party_policy, supporter_equivalents_by_party_policy);
+	copy_values(contributed_breakdowns.supporter_equivalents_by_reform, supporter_equivalents_by_reform);
+	contributed_breakdowns.vote_equivalents_by_party = vote_equivalents_by_party;
+	copy_values(contributed_breakdowns.population_by_culture, population_by_culture);
+	copy_values(contributed_breakdowns.population_by_religion, population_by_religion);
+}
+
+template<bool Subtract>
+void PopsAggregate::_add_contributed_values(contributed_values_t const& values) {
+	add<Subtract>(max_supported_regiment_count, values.max_supported_regiment_count);
+	add<Subtract>(_yesterdays_import_value_running_total, values.yesterdays_import_value);
+	add<Subtract>(literacy_running_total_raw, values.literacy_raw);
+	add<Subtract>(consciousness_running_total_raw, values.consciousness_raw);
+	add<Subtract>(militancy_running_total_raw, values.militancy_raw);
+	add<Subtract, boost::int128::int128_t>(militancy_by_strata_running_total_raw, values.militancy_by_strata_raw);
+	add<Subtract, boost::int128::int128_t>(
+		life_needs_fulfilled_by_strata_running_total_raw, values.life_needs_fulfilled_by_strata_raw
+	);
+	add<Subtract, boost::int128::int128_t>(
+		everyday_needs_fulfilled_by_strata_running_total_raw, values.everyday_needs_fulfilled_by_strata_raw
+	);
+	add<Subtract, boost::int128::int128_t>(
+		luxury_needs_fulfilled_by_strata_running_total_raw, values.luxury_needs_fulfilled_by_strata_raw
+	);
+	add<Subtract, pop_sum_t>(unemployed_pops_by_type, values.unemployed_pops_by_type);
+}
+
+template<bool Subtract>
+void PopsAggregate::_add_contributed_breakdowns(contributed_breakdowns_t const& breakdowns) {
+	add<Subtract>(total_population, breakdowns.total_population);
+	add<Subtract, pop_sum_t>(population_by_strata, breakdowns.population_by_strata);
+	add<Subtract, pop_sum_t>(population_by_type, breakdowns.population_by_type);
+	add<Subtract, fixed_point_t>(supporter_equivalents_by_ideology, breakdowns.supporter_equivalents_by_ideology);
+	add<Subtract, fixed_point_t>(supporter_equivalents_by_party_policy, breakdowns.supporter_equivalents_by_party_policy);
+	add<Subtract, fixed_point_t>(supporter_equivalents_by_reform, breakdowns.supporter_equivalents_by_reform);
+	add<Subtract, pop_sum_t>(population_by_culture, breakdowns.population_by_culture);
+	add<Subtract, pop_sum_t>(population_by_religion, breakdowns.population_by_religion);
+
+	// A party no part votes for anymore keeps its entry at 0, as the owner's parties do after a rebuild.
+	if constexpr (Subtract) {
+		vote_equivalents_by_party -= breakdowns.vote_equivalents_by_party;
+	} else {
+		vote_equivalents_by_party += breakdowns.vote_equivalents_by_party;
+	}
+}
+
+void PopsAggregate::take_part_pops_aggregate(PopsAggregate& part, const bool rebuilding) {
+	// The part's contributions are exact integer sums, so subtracting the old ones leaves exactly what a rebuild would add.
+	if (part.contributed_values_outdated) {
+		if (!rebuilding) {
+			_add_contributed_values<true>(part.contributed_values);
 		}
+		part._update_contributed_values();
+		part.contributed_values_outdated = false;
+		_add_contributed_values<false>(part.contributed_values);
+	} else if (rebuilding) {
+		_add_contributed_values<false>(part.contributed_values);
 	}
 
-	add(population_by_type, part.get_population_by_type());
-	add(unemployed_pops_by_type, part.get_unemployed_pops_by_type());
-	add(supporter_equivalents_by_ideology, part.get_supporter_equivalents_by_ideology());
-	add(supporter_equivalents_by_party_policy, part.get_supporter_equivalents_by_party_policy());
-	add(supporter_equivalents_by_reform, part.get_supporter_equivalents_by_reform());
-	vote_equivalents_by_party += part.get_vote_equivalents_by_party();
-	population_by_culture += part.get_population_by_culture();
-	population_by_religion += part.get_population_by_religion();
+	if (part.contributed_breakdowns_outdated) {
+		if (!rebuilding) {
+			_add_contributed_breakdowns<true>(part.contributed_breakdowns);
+		}
+		part._update_contributed_breakdowns();
+		part.contributed_breakdowns_outdated = false;
+		_add_contributed_breakdowns<false>(part.contributed_breakdowns);
+	} else if (rebuilding) {
+		_add_contributed_breakdowns<false>(part.contributed_breakdowns);
+	}
+}
+
+void PopsAggregate::_set_pops_aggregate_updated(
+	const update_kind_t update_kind, const bool values_changed, const bool breakdowns_changed
+) {
+	last_pops_aggregate_update = update_kind;
+	pops_aggregate_changed = values_changed || breakdowns_changed;
+	contributed_values_outdated |= values_changed;
+	contributed_breakdowns_outdated |= breakdowns_changed;
 }
 
-void PopsAggregate::add_pops_aggregate(Pop const& pop) {
-	const pop_size_t pop_size = pop.get_size();
+void PopsAggregate::add_pops_aggregate(PopStore const& pop_store) {
+	std::span<const pop_size_t> sizes = pop_store.get_sizes();
+	std::span<const strata_index_t> strata_indices = pop_store.get_strata_indices();
+	std::span<const pop_type_index_t> type_indices = pop_store.get_type_indices();
 
-	total_population += pop_size;
-	yesterdays_import_value += pop.get_yesterdays_import_value().get_copy_of_value();
-	const int64_t pop_size_v = type_safe::get(pop_size);
-	update_running_total_raw_128(literacy_running_total_raw, pop_size, pop.get_literacy());
-	update_running_total_raw_128(consciousness_running_total_raw, pop_size, pop.get_consciousness());
-	update_running_total_raw_128(militancy_running_total_raw, pop_size, pop.get_militancy());
+	// Each pass reads only the columns it needs, one row per pop.
+	for (std::size_t i = 0; i < pop_store.size(); ++i) {
+		const pop_size_t pop_size = sizes[i];
+		total_population += pop_size;
+		_yesterdays_import_value_running_total += pop_store.get_yesterdays_import_value()[i];
+		update_running_total_raw_128(literacy_running_total_raw, pop_size, pop_store.get_literacy()[i]);
+		update_running_total_raw_128(consciousness_running_total_raw, pop_size, pop_store.get_consciousness()[i]);
+		update_running_total_raw_128(militancy_running_total_raw, pop_size, pop_store.get_militancy()[i]);
+		max_supported_regiment_count += pop_store.get_recruitable_regiments()[i];
+	}
+
+	for (std::size_t i = 0; i < pop_store.size(); ++i) {
+		const pop_size_t pop_size = sizes[i];
+		const strata_index_t strata_index = strata_indices[i];
+		population_by_strata[strata_index] += pop_size;
+		update_running_total_raw_128(
+			militancy_by_strata_running_total_raw[strata_index],
+			pop_size, pop_store.get_militancy()[i]
+		);
+		update_running_total_raw_128(
+			life_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			pop_size, pop_store.get_life_needs_fulfilled()[i]
+		);
+		update_running_total_raw_128(
+			everyday_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			pop_size, pop_store.get_everyday_needs_fulfilled()[i]
+		);
+		update_running_total_raw_128(
+			luxury_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			pop_size, pop_store.get_luxury_needs_fulfilled()[i]
+		);
+	}
+
+	for (std::size_t i = 0; i < pop_store.size(); ++i) {
+		population_by_type[type_indices[i]] += sizes[i];
+		unemployed_pops_by_type[type_indices[i]] += pop_store.get_unemployed()[i];
+		population_by_culture[pop_store.get_culture_indices()[i]] += sizes[i];
+		population_by_religion[pop_store.get_religion_indices()[i]] += sizes[i];
+	}
+
+	// Pop ideology, issue and vote distributions are scaled to pop size so we can add them directly
+	for (Pop const* pop : pop_store.get_pops()) {
+		pop->get_supporter_equivalents_by_ideology().add_to_dense(supporter_equivalents_by_ideology);
+		pop->get_supporter_equivalents_by_party_policy().add_to_dense(supporter_equivalents_by_party_policy);
+		pop->get_supporter_equivalents_by_reform().add_to_dense(supporter_equivalents_by_reform);
+		vote_equivalents_by_party += pop->get_vote_equivalents_by_party();
+	}
 
-	PopType const& pop_type = pop.get_type();
-	const pop_type_index_t pop_type_index = pop_type.index;
-	const strata_index_t strata_index = pop_type.strata.index;
+	yesterdays_import_value.set(_yesterdays_import_value_running_total);
+}
 
-	population_by_strata[strata_index] += pop_size;
-	update_running_total_raw_128(
-		militancy_by_strata_running_total_raw[strata_index],
-		pop_size, pop.get_militancy()
+template<bool Subtract>
+constexpr void apply_running_total_raw_128(
+	boost::int128::int128_t& running_total_raw,
+	const pop_size_t pop_size,
+	const fixed_point_t value
+) {
+	add<Subtract>(running_total_raw, running_total_raw_128(pop_size, value));
+}
+
+// Everything a row adds except its supporters and votes, which are only stored in the pops themselves.
+template<bool Subtract>
+void PopsAggregate::_add_pop_row(PopStore const& pop_store, const std::size_t row) {
+	const pop_size_t pop_size = pop_store.get_sizes()[row];
+	const strata_index_t strata_index = pop_store.get_strata_indices()[row];
+	const pop_type_index_t type_index = pop_store.get_type_indices()[row];
+
+	apply_running_total_raw_128<Subtract>(literacy_running_total_raw, pop_size, pop_store.get_literacy()[row]);
+	apply_running_total_raw_128<Subtract>(consciousness_running_total_raw, pop_size, pop_store.get_consciousness()[row]);
+	apply_running_total_raw_128<Subtract>(militancy_running_total_raw, pop_size, pop_store.get_militancy()[row]);
+	apply_running_total_raw_128<Subtract>(
+		militancy_by_strata_running_total_raw[strata_index], pop_size, pop_store.get_militancy()[row]
 	);
-	update_running_total_raw_128(
-		life_needs_fulfilled_by_strata_running_total_raw[strata_index],
-		pop_size, pop.get_life_needs_fulfilled()
+	apply_running_total_raw_128<Subtract>(
+		life_needs_fulfilled_by_strata_running_total_raw[strata_index], pop_size, pop_store.get_life_needs_fulfilled()[row]
 	);
-	update_running_total_raw_128(
-		everyday_needs_fulfilled_by_strata_running_total_raw[strata_index],
-		pop_size, pop.get_everyday_needs_fulfilled()
+	apply_running_total_raw_128<Subtract>(
+		everyday_needs_fulfilled_by_strata_running_total_raw[strata_index], pop_size,
+		pop_store.get_everyday_needs_fulfilled()[row]
 	);
-	update_running_total_raw_128(
-		luxury_needs_fulfilled_by_strata_running_total_raw[strata_index],
-		pop_size, pop.get_luxury_needs_fulfilled()
+	apply_running_total_raw_128<Subtract>(
+		luxury_needs_fulfilled_by_strata_running_total_raw[strata_index], pop_size,
+		pop_store.get_luxury_needs_fulfilled()[row]
 	);
 
-	population_by_type[pop_type_index] += pop_size;
-	unemployed_pops_by_type[pop_type_index] += pop.get_unemployed();
-	// Pop ideology, issue and vote distributions are scaled to pop size so we can add them directly
-	add(supporter_equivalents_by_ideology, pop.get_supporter_equivalents_by_ideology());
-	add(supporter_equivalents_by_party_policy, pop.get_supporter_equivalents_by_party_policy());
-	add(supporter_equivalents_by_reform, pop.get_supporter_equivalents_by_reform());
-	vote_equivalents_by_party += pop.get_vote_equivalents_by_party();
-	population_by_culture[&pop.culture] += pop_size;
-	population_by_religion[&pop.religion] += pop_size;
-
-	if (pop_type.can_be_recruited) {
-		max_supported_regiment_count += pop.get_max_supported_regiments();
+	add<Subtract>(_yesterdays_import_value_running_total, pop_store.get_yesterdays_import_value()[row]);
+	add<Subtract>(max_supported_regiment_count, pop_store.get_recruitable_regiments()[row]);
+	add<Subtract>(unemployed_pops_by_type[type_index], pop_sum_t { pop_store.get_unemployed()[row] });
+
+	add<Subtract>(total_population, pop_sum_t { pop_size });
+	add<Subtract>(population_by_strata[strata_index], pop_sum_t { pop_size });
+	add<Subtract>(population_by_type[type_index], pop_sum_t { pop_size });
+	add<Subtract>(population_by_culture[pop_store.get_culture_indices()[row]], pop_sum_t { pop_size });
+	add<Subtract>(population_by_religion[pop_store.get_religion_indices()[row]], pop_sum_t { pop_size });
+}
+
+void PopsAggregate::_resum_pop_supporters(PopStore const& pop_store) {
+	bulk_fill_default(supporter_equivalents_by_ideology, supporter_equivalents_by_party_policy, supporter_equivalents_by_reform);
+	vote_equivalents_by_party.clear();
+	for (Pop const* pop : pop_store.get_pops()) {
+		pop->get_supporter_equivalents_by_ideology().add_to_dense(supporter_equivalents_by_ideology);
+		pop->get_supporter_equivalents_by_party_policy().add_to_dense(supporter_equivalents_by_party_policy);
+		pop->get_supporter_equivalents_by_reform().add_to_dense(supporter_equivalents_by_reform);
+		vote_equivalents_by_party += pop->get_vote_equivalents_by_party();
 	}
+}
+
+static bool same_pop_rows(PopStore const& lhs, PopStore const& rhs) {
+	return std::ranges::equal(lhs.get_pops(), rhs.get_pops())
+		&& std::ranges::equal(lhs.get_type_indices(), rhs.get_type_indices())
+		&& std::ranges::equal(lhs.get_culture_indices(), rhs.get_culture_indices())
+		&& std::ranges::equal(lhs.get_religion_indices(), rhs.get_religion_indices());
+}
+
+static bool pop_row_changed(PopStore const& lhs, PopStore const& rhs, const std::size_t row) {
+	return lhs.get_sizes()[row] != rhs.get_sizes()[row]
+		|| lhs.get_unemployed()[row] != rhs.get_unemployed()[row]
+		|| lhs.get_literacy()[row] != rhs.get_literacy()[row]
+		|| lhs.get_consciousness()[row] != rhs.get_consciousness()[row]
+		|| lhs.get_militancy()[row] != rhs.get_militancy()[row]
+		|| lhs.get_yesterdays_import_value()[row] != rhs.get_yesterdays_import_value()[row]
+		|| lhs.get_life_needs_fulfilled()[row] != rhs.get_life_needs_fulfilled()[row]
+		|| lhs.get_everyday_needs_fulfilled()[row] != rhs.get_everyday_needs_fulfilled()[row]
+		|| lhs.get_luxury_needs_fulfilled()[row] != rhs.get_luxury_needs_fulfilled()[row]
+		|| lhs.get_recruitable_regiments()[row] != rhs.get_recruitable_regiments()[row];
+}
+
+void PopsAggregate::update_pops_aggregate(PopStore const& pop_store, PopStore const& previous_pop_store) {
+	if (pops_aggregate_needs_rebuild || !same_pop_rows(pop_store, previous_pop_store)) {
+		pops_aggregate_needs_rebuild = false;
+		pop_supporters_changed = false;
+		clear_pops_aggregate();
+		add_pops_aggregate(pop_store);
+		normalise_pops_aggregate();
+		_set_pops_aggregate_updated(update_kind_t::REBUILD, true, true);
+		return;
+	}
+
+	bool any_size_changed = false;
+	changed_rows.clear();
+	for (std::size_t row = 0; row < pop_store.size(); ++row) {
+		if (pop_row_changed(pop_store, previous_pop_store, row)) {
+			changed_rows.push_back(row);
+			any_size_changed |= pop_store.get_sizes()[row] != previous_pop_store.get_sizes()[row];
+		}
+	}
+
+	const bool supporters_changed = any_size_changed || pop_supporters_changed;
+	pop_supporters_changed = false;
+	if (changed_rows.empty() && !supporters_changed) {
+		_set_pops_aggregate_updated(update_kind_t::UNCHANGED, false, false);
+		return;
+	}
+
+	// The subtracted products are exactly those added last update, so the running totals match a rebuild exactly.
+	for (const std::size_t row : changed_rows) {
+		_add_pop_row<true>(previous_pop_store, row);
+		_add_pop_row<false>(pop_store, row);
+	}
+	// Pops don't keep their previous supporters, but they are scaled to size so re-adding them all is a plain sum.
+	if (supporters_changed) {
+		_resum_pop_supporters(pop_store);
+	}
+
 	yesterdays_import_value.set(_yesterdays_import_value_running_total);
+	normalise_pops_aggregate();
+	_set_pops_aggregate_updated(update_kind_t::DELTA, !changed_rows.empty(), supporters_changed);
 }
 
+// A delta can empty a population that had values, those go back to 0 as after a rebuild.
 constexpr void normalise(fixed_point_t& value, const boost::int128::int128_t running_total_raw, const pop_sum_t population) {
-	value = fixed_point_t::parse_raw(static_cast<int64_t>(
-		running_total_raw / type_safe::get(population)
-	));
+	if (population > 0) {
+		value = fixed_point_t::parse_raw(static_cast<int64_t>(
+			running_total_raw / type_safe::get(population)
+		));
+	} else {
+		value = fixed_point_t::_0;
+	}
 }
 
 void PopsAggregate::normalise_pops_aggregate() {
-	if (total_population > 0) {
-		const int64_t total_population_v = type_safe::get(total_population);
-		average_literacy = fixed_point_t::parse_raw(static_cast<int64_t>(literacy_running_total_raw / total_population_v));
-		average_consciousness = fixed_point_t::parse_raw(static_cast<int64_t>(consciousness_running_total_raw / total_population_v));
-		average_militancy = fixed_point_t::parse_raw(static_cast<int64_t>(militancy_running_total_raw / total_population_v));
-
-		strata_index_t strata_index {};
-		for (const pop_sum_t strata_population : population_by_strata) {
-			normalise(
-				militancy_by_strata[strata_index],
-				militancy_by_strata_running_total_raw[strata_index],
-				strata_population
-			);
-			normalise(
-				life_needs_fulfilled_by_strata[strata_index],
-				life_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population
-			);
-			normalise(
-				everyday_needs_fulfilled_by_strata[strata_index],
-				everyday_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population
-			);
-			normalise(
-				luxury_needs_fulfilled_by_strata[strata_index],
-				luxury_needs_fulfilled_by_strata_running_total_raw[strata_index],
-				strata_population
-			);
-			++strata_index;
-		}
+	normalise(average_literacy, literacy_running_total_raw, total_population);
+	normalise(average_consciousness, consciousness_running_total_raw, total_population);
+	normalise(average_militancy, militancy_running_total_raw, total_population);
+
+	strata_index_t strata_index {};
+	for (const pop_sum_t strata_population : population_by_strata) {
+		normalise(
+			militancy_by_strata[strata_index],
+			militancy_by_strata_running_total_raw[strata_index],
+			strata_population
+		);
+		normalise(
+			life_needs_fulfilled_by_strata[strata_index],
+			life_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			strata_population
+		);
+		normalise(
+			everyday_needs_fulfilled_by_strata[strata_index],
+			everyday_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			strata_population
+		);
+		normalise(
+			luxury_needs_fulfilled_by_strata[strata_index],
+			luxury_needs_fulfilled_by_strata_running_total_raw[strata_index],
+			strata_population
+		);
+		++strata_index;
 	}
 }
 
 void PopsAggregate::update_parties_for_votes(CountryDefinition const* country_definition) {
+	pops_aggregate_needs_rebuild = true;
 	vote_equivalents_by_party.clear();
 	if (country_definition == nullptr) {
 		return;
@@ -261,9 +482,7 @@ void PopsAggregate::update_parties_for_votes(CountryDefinition const* country_de
 	vote_equivalents_by_party.insert(view.begin(), view.end());
 }
 void PopsAggregate::update_parties_for_votes(CountryInstance const* country_instance) {
-	if (country_instance == nullptr) {
-		vote_equivalents_by_party.clear();
-		return;
-	}
-	update_parties_for_votes(&country_instance->country_definition);
+	update_parties_for_votes(
+		country_instance == nullptr ? nullptr : &country_instance->country_definition
+	);
 }
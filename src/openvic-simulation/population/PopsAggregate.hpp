@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <boost/int128/detail/int128_imp.hpp>
 
 #include "openvic-simulation/core/memory/FixedVector.hpp"
+#include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/population/PopSum.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
@@ -20,12 +24,23 @@ namespace OpenVic {
 	struct PartyPolicy;
 	struct Pop;
 	struct PopsAggregateDeps;
+	struct PopStore;
 	struct PopType;
 	struct Reform;
 	struct Religion;
 	struct Strata;
 
 	struct PopsAggregate {
+	public:
+		// How the last update brought the aggregate up to date.
+		enum struct update_kind_t : uint8_t {
+			UNCHANGED,
+			// Only what changed was subtracted and re-added.
+			DELTA,
+			// Everything was cleared and re-added.
+			REBUILD
+		};
+
 	private:
 		pop_sum_t PROPERTY(total_population, 0);
 		size_t PROPERTY(max_supported_regiment_count, 0);
@@ -56,16 +71,112 @@ namespace OpenVic {
 		memory::FixedVector<fixed_point_t, party_policy_index_t> SPAN_PROPERTY(supporter_equivalents_by_party_policy);
 		memory::FixedVector<fixed_point_t, reform_index_t> SPAN_PROPERTY(supporter_equivalents_by_reform);
 		fixed_point_map_t<CountryParty const*> PROPERTY(vote_equivalents_by_party);
-		ordered_map<Culture const*, pop_sum_t> PROPERTY(population_by_culture);
-		ordered_map<Religion const*, pop_sum_t> PROPERTY(population_by_religion);
+		memory::FixedVector<pop_sum_t, culture_index_t> SPAN_PROPERTY(population_by_culture);
+		memory::FixedVector<pop_sum_t, religion_index_t> SPAN_PROPERTY(population_by_religion);
+
+		// Reused by update_pops_aggregate
+		memory::vector<std::size_t> changed_rows;
+
+		/* What this aggregate last added to its parent, so the parent can subtract it again and add the new values
+		 * when this aggregate changes instead of re-adding all of its parts. The values change with most updates,
+		 * the breakdowns only when pop sizes or supporters change, so they are taken separately. */
+		struct contributed_values_t {
+			size_t max_supported_regiment_count = 0;
+			fixed_point_t yesterdays_import_value;
+			boost::int128::int128_t literacy_raw;
+			boost::int128::int128_t consciousness_raw;
+			boost::int128::int128_t militancy_raw;
+			memory::FixedVector<boost::int128::int128_t, strata_index_t> militancy_by_strata_raw;
+			memory::FixedVector<boost::int128::int128_t, strata_index_t> life_needs_fulfilled_by_strata_raw;
+			memory::FixedVector<boost::int128::int128_t, strata_index_t> everyday_needs_fulfilled_by_strata_raw;
+			memory::FixedVector<boost::int128::int128_t, strata_index_t> luxury_needs_fulfilled_by_strata_raw;
+			memory::FixedVector<pop_sum_t, pop_type_index_t> unemployed_pops_by_type;
+
+			contributed_values_t(PopsAggregateDeps const& deps);
+		};
+		struct contributed_breakdowns_t {
+			pop_sum_t total_population = 0;
+			memory::FixedVector<pop_sum_t, strata_index_t> population_by_strata;
+			memory::FixedVector<pop_sum_t, pop_type_index_t> population_by_type;
+			memory::FixedVector<fixed_point_t, ideology_index_t> supporter_equivalents_by_ideology;
+			memory::FixedVector<fixed_point_t, party_policy_index_t> supporter_equivalents_by_party_policy;
+			memory::FixedVector<fixed_point_t, reform_index_t> supporter_equivalents_by_reform;
+			fixed_point_map_t<CountryParty const*> vote_equivalents_by_party;
+			memory::FixedVector<pop_sum_t, culture_index_t> population_by_culture;
+			memory::FixedVector<pop_sum_t, religion_index_t> population_by_religion;
+
+			contributed_breakdowns_t(PopsAggregateDeps const& deps);
+		};
+		contributed_values_t contributed_values;
+		contributed_breakdowns_t contributed_breakdowns;
+		// Set by every update that changes them, cleared once the parent has taken them.
+		bool contributed_values_outdated = true;
+		bool contributed_breakdowns_outdated = true;
+
+		// Whether the last update changed any value.
+		bool PROPERTY(pops_aggregate_changed, true);
+		update_kind_t PROPERTY(last_pops_aggregate_update, update_kind_t::UNCHANGED);
+
+		template<bool Subtract>
+		void _add_pop_row(PopStore const& pop_store, const std::size_t row);
+		void _resum_pop_supporters(PopStore const& pop_store);
+
+		void _update_contributed_values();
+		void _update_contributed_breakdowns();
+		template<bool Subtract>
+		void _add_contributed_values(contributed_values_t const& values);
+		template<bool Subtract>
+		void _add_contributed_breakdowns(contributed_breakdowns_t const& breakdowns);
+		void _set_pops_aggregate_updated(const update_kind_t update_kind, const bool values_changed, const bool breakdowns_changed);
 
 	protected:
+		// Set when the parts themselves change (added, removed, new party list), the next update rebuilds everything.
+		bool pops_aggregate_needs_rebuild = true;
+		// Set when pop supporters may have changed while pop sizes stayed the same, the next update re-sums them.
+		bool pop_supporters_changed = false;
+
 		PopsAggregate(PopsAggregateDeps const& deps);
 
 		void clear_pops_aggregate();
-		void add_pops_aggregate(PopsAggregate& part);
-		void add_pops_aggregate(Pop const& pop);
+		void add_pops_aggregate(PopStore const& pop_store);
 		void normalise_pops_aggregate();
+		/* Brings the aggregate from previous_pop_store's rows to pop_store's rows. When both hold the same pops with the
+		 * same types, cultures and religions, only the rows that changed are subtracted and re-added, and supporters
+		 * are only re-summed if a size changed. Otherwise it rebuilds. */
+		void update_pops_aggregate(PopStore const& pop_store, PopStore const& previous_pop_store);
+		// Adds what the part changed since it was last taken, or all of it when rebuilding.
+		void take_part_pops_aggregate(PopsAggregate& part, const bool rebuilding);
+		/* For aggregates of aggregates, subtracts what each changed part contributed last time and adds its new values.
+		 * Rebuilds from all parts if the set of parts changed. Returns whether any part's breakdowns changed,
+		 * which includes any change to the pops of a part. */
+		template<typename Parts, typename GetPart>
+		bool update_pops_aggregate_from_parts(Parts const& parts, GetPart&& get_part) {
+			const bool rebuilding = pops_aggregate_needs_rebuild;
+			if (rebuilding) {
+				pops_aggregate_needs_rebuild = false;
+				clear_pops_aggregate();
+			}
+
+			bool values_changed = rebuilding;
+			bool breakdowns_changed = rebuilding;
+			for (auto const& part : parts) {
+				PopsAggregate& part_aggregate = get_part(part);
+				values_changed |= part_aggregate.contributed_values_outdated;
+				breakdowns_changed |= part_aggregate.contributed_breakdowns_outdated;
+				take_part_pops_aggregate(part_aggregate, rebuilding);
+			}
+
+			if (!values_changed && !breakdowns_changed) {
+				_set_pops_aggregate_updated(update_kind_t::UNCHANGED, false, false);
+				return false;
+			}
+
+			normalise_pops_aggregate();
+			_set_pops_aggregate_updated(
+				rebuilding ? update_kind_t::REBUILD : update_kind_t::DELTA, values_changed, breakdowns_changed
+			);
+			return breakdowns_changed;
+		}
 		void update_parties_for_votes(CountryDefinition const* country_definition);
 		void update_parties_for_votes(CountryInstance const* country_instance);
 	public:
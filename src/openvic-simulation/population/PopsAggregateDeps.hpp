@@ -4,10 +4,12 @@
 
 namespace OpenVic {
 	struct PopsAggregateDeps {
+		culture_index_t culture_count;
 		ideology_index_t ideology_count;
 		party_policy_index_t party_policy_count;
 		pop_type_index_t pop_type_count;
 		reform_index_t reform_count;
+		religion_index_t religion_count;
 		strata_index_t strata_count;
 	};
 }
\ No newline at end of file
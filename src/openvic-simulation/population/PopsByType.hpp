@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+#include <type_safe/strong_typedef.hpp>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+namespace OpenVic {
+	struct Pop;
+
+	/* Pops grouped by type in a single array, the pops of type i are at [offsets[i], offsets[i + 1]).
+	 * Rebuilt with a counting sort which keeps the relative order of pops of the same type and reuses its arrays,
+	 * so the pops of a type are a contiguous span and rebuilding doesn't allocate once the arrays are large enough. */
+	struct PopsByType {
+	private:
+		memory::vector<Pop*> pops;
+		memory::vector<std::size_t> offsets;
+		// Reused by the rebuilds
+		memory::vector<std::size_t> cursors;
+
+		// offsets[i + 1] holds the count of type i.
+		constexpr void _counts_to_offsets() {
+			for (std::size_t i = 1; i < offsets.size(); ++i) {
+				offsets[i] += offsets[i - 1];
+			}
+			std::copy(offsets.begin(), offsets.end() - 1, cursors.begin());
+			pops.resize(offsets.back());
+		}
+
+	public:
+		PopsByType(const pop_type_index_t pop_type_count)
+		  : offsets(type_safe::get(pop_type_count) + 1, 0),
+			cursors(type_safe::get(pop_type_count), 0) {}
+
+		constexpr pop_type_index_t size() const {
+			return index_from_count<pop_type_index_t>(cursors.size());
+		}
+		constexpr std::size_t get_pop_count() const {
+			return pops.size();
+		}
+
+		constexpr std::span<Pop* const> operator[](const pop_type_index_t pop_type_index) const {
+			const std::size_t index = type_safe::get(pop_type_index);
+			return { pops.data() + offsets[index], pops.data() + offsets[index + 1] };
+		}
+
+		template<typename Pops>
+		void rebuild(Pops& source_pops) {
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (auto const& pop : source_pops) {
+				++offsets[type_safe::get(pop.get_type().index) + 1];
+			}
+			_counts_to_offsets();
+			for (auto& pop : source_pops) {
+				pops[cursors[type_safe::get(pop.get_type().index)]++] = &pop;
+			}
+		}
+
+		// Concatenates the parts' pops type by type, pops of the same type stay in part order.
+		template<typename Parts, typename GetPart>
+		void rebuild_from_parts(Parts const& parts, GetPart&& get_part) {
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (auto const& part : parts) {
+				PopsByType const& part_pops = get_part(part);
+				for (std::size_t i = 0; i < cursors.size(); ++i) {
+					offsets[i + 1] += part_pops.offsets[i + 1] - part_pops.offsets[i];
+				}
+			}
+			_counts_to_offsets();
+			for (auto const& part : parts) {
+				PopsByType const& part_pops = get_part(part);
+				for (std::size_t i = 0; i < cursors.size(); ++i) {
+					cursors[i] = std::copy(
+						part_pops.pops.begin() + part_pops.offsets[i],
+						part_pops.pops.begin() + part_pops.offsets[i + 1],
+						pops.begin() + cursors[i]
+					) - pops.begin();
+				}
+			}
+		}
+	};
+}
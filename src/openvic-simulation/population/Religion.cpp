@@ -9,11 +9,13 @@ ReligionGroup::ReligionGroup(std::string_view new_identifier) : HasIdentifier {
 
 Religion::Religion(
 	std::string_view new_identifier,
+	index_t new_index,
 	colour_t new_colour,
 	ReligionGroup const& new_group,
 	icon_t new_icon,
 	bool new_pagan
 ) : HasIdentifierAndColour { new_identifier, new_colour, false },
+	HasIndex { new_index },
 	group { new_group },
 	icon { new_icon },
 	pagan { new_pagan } {}
@@ -43,7 +45,7 @@ bool ReligionManager::add_religion(
 	}
 	return religions.emplace_item(
 		identifier,
-		identifier, colour, group, icon, pagan
+		identifier, index_from_count<Religion::index_t>(get_religion_count()), colour, group, icon, pagan
 	);
 }
 
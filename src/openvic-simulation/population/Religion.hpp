@@ -2,7 +2,9 @@
 
 #include "openvic-simulation/dataloader/NodeTools.hpp"
 #include "openvic-simulation/types/HasIdentifier.hpp"
+#include "openvic-simulation/types/HasIndex.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
 
 namespace OpenVic {
 	struct ReligionGroup : HasIdentifier {
@@ -11,7 +13,7 @@ namespace OpenVic {
 		ReligionGroup(ReligionGroup&&) = default;
 	};
 
-	struct Religion : HasIdentifierAndColour {
+	struct Religion : HasIdentifierAndColour, HasIndex<Religion, religion_index_t> {
 		using icon_t = uint8_t;
 
 	public:
@@ -20,8 +22,8 @@ namespace OpenVic {
 		const bool pagan;
 
 		Religion(
-			std::string_view new_identifier, colour_t new_colour, ReligionGroup const& new_group, icon_t new_icon,
-			bool new_pagan
+			std::string_view new_identifier, index_t new_index, colour_t new_colour, ReligionGroup const& new_group,
+			icon_t new_icon, bool new_pagan
 		);
 		Religion(Religion&&) = default;
 	};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+#include <type_safe/strong_typedef.hpp>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/fixed_point/Math.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	/* Sparse form of a pop's supporter equivalents, one entry per index with non-zero support.
+	 * Indices are kept sorted in their own column so lookups are a binary search and adding into a dense total
+	 * is a single pass. Pops only support a handful of the ideologies, policies and reforms, so this is far smaller
+	 * than a dense vector with one value per index. Zero values are never stored. */
+	template<typename IndexT>
+	struct SparseSupportVector {
+	private:
+		memory::vector<IndexT> SPAN_PROPERTY(indices);
+		memory::vector<fixed_point_t> SPAN_PROPERTY(values);
+
+		constexpr std::size_t lower_bound(const IndexT index) const {
+			return std::lower_bound(indices.begin(), indices.end(), index) - indices.begin();
+		}
+
+		void erase_at(const std::size_t position) {
+			indices.erase(indices.begin() + position);
+			values.erase(values.begin() + position);
+		}
+
+		void remove_zeros() {
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < values.size(); ++i) {
+				if (values[i] != 0) {
+					indices[kept] = indices[i];
+					values[kept] = values[i];
+					++kept;
+				}
+			}
+			indices.resize(kept);
+			values.resize(kept);
+		}
+
+	public:
+		constexpr std::size_t size() const {
+			return indices.size();
+		}
+		constexpr bool empty() const {
+			return indices.empty();
+		}
+		void clear() {
+			indices.clear();
+			values.clear();
+		}
+
+		constexpr fixed_point_t get(const IndexT index) const {
+			const std::size_t position = lower_bound(index);
+			return position < indices.size() && indices[position] == index ? values[position] : fixed_point_t::_0;
+		}
+
+		// Setting 0 removes the entry.
+		void set(const IndexT index, const fixed_point_t value) {
+			const std::size_t position = lower_bound(index);
+			if (position < indices.size() && indices[position] == index) {
+				if (value == 0) {
+					erase_at(position);
+				} else {
+					values[position] = value;
+				}
+			} else if (value != 0) {
+				indices.insert(indices.begin() + position, index);
+				values.insert(values.begin() + position, value);
+			}
+		}
+
+		void add(const IndexT index, const fixed_point_t value) {
+			set(index, get(index) + value);
+		}
+
+		// Replaces the contents with the non-zero values of a dense vector, dense[i] belongs to index i.
+		void assign_dense(std::span<const fixed_point_t> dense) {
+			clear();
+			for (std::size_t i = 0; i < dense.size(); ++i) {
+				if (dense[i] != 0) {
+					indices.push_back(index_from_count<IndexT>(i));
+					values.push_back(dense[i]);
+				}
+			}
+		}
+
+		constexpr fixed_point_t get_total() const {
+			fixed_point_t total = 0;
+			for (const fixed_point_t value : values) {
+				total += value;
+			}
+			return total;
+		}
+
+		// Each value becomes value * numerator / denominator, values rounding to 0 are removed.
+		template<typename T>
+		void rescale(T const& numerator, T const& denominator) {
+			for (fixed_point_t& value : values) {
+				value = fp::mul_div(value, numerator, denominator);
+			}
+			remove_zeros();
+		}
+
+		// dense[i] belongs to index i and must be large enough for every stored index.
+		constexpr void add_to_dense(std::span<fixed_point_t> dense) const {
+			for (std::size_t i = 0; i < indices.size(); ++i) {
+				dense[type_safe::get(indices[i])] += values[i];
+			}
+		}
+
+		// Removes numerator / denominator of every value, calling callback(index, removed_value) for each non-zero part.
+		template<typename T, typename Callback>
+		void take_share(T const& numerator, T const& denominator, Callback&& callback) {
+			for (std::size_t i = 0; i < indices.size(); ++i) {
+				const fixed_point_t share = fp::mul_div(values[i], numerator, denominator);
+				if (share != 0) {
+					values[i] -= share;
+					callback(indices[i], share);
+				}
+			}
+			remove_zeros();
+		}
+	};
+}
@@ -0,0 +1,215 @@
+#include "TimeSeriesStore.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace OpenVic;
+
+TimeSeriesStore::TimeSeriesStore(const std::size_t new_series_count, const std::size_t new_retention)
+  : series_count { new_series_count },
+	retention { std::max<std::size_t>(new_retention, 1) },
+	delta_capacity { retention + KEYFRAME_INTERVAL },
+	keyframe_capacity { 2 * (delta_capacity / KEYFRAME_INTERVAL + 1) },
+	dates(retention),
+	series_states(series_count),
+	deltas(series_count * delta_capacity, 0),
+	keyframe_values(series_count * keyframe_capacity),
+	keyframe_samples(series_count * keyframe_capacity, 0) {}
+
+std::size_t TimeSeriesStore::get_keyframe_slot(const std::size_t series_index, const std::size_t keyframe_index) const {
+	return series_index * keyframe_capacity
+		+ (series_states[series_index].keyframe_head + keyframe_index) % keyframe_capacity;
+}
+
+void TimeSeriesStore::push_keyframe(const std::size_t series_index, const std::size_t sample_index, const fixed_point_t value) {
+	series_state_t& state = series_states[series_index];
+	if (state.keyframe_count == keyframe_capacity) {
+		state.keyframe_head = (state.keyframe_head + 1) % keyframe_capacity;
+		--state.keyframe_count;
+	}
+	const std::size_t slot = get_keyframe_slot(series_index, state.keyframe_count++);
+	keyframe_values[slot] = value;
+	keyframe_samples[slot] = sample_index;
+}
+
+std::size_t TimeSeriesStore::get_oldest_sample(const std::size_t series_index) const {
+	series_state_t const& state = series_states[series_index];
+	if (state.keyframe_count == 0) {
+		return sample_count;
+	}
+	return std::max(get_first_sample(), keyframe_samples[get_keyframe_slot(series_index, 0)]);
+}
+
+Date TimeSeriesStore::get_sample_date(const std::size_t sample_index) const {
+	assert(sample_index >= get_first_sample() && sample_index < sample_count);
+	return dates[sample_index % retention];
+}
+
+std::pair<std::size_t, std::size_t> TimeSeriesStore::find_sample_range(const Date from_date, const Date to_date) const {
+	// Dates only ever increase, so both ends are a binary search over the retained samples.
+	const auto first_not_before = [this](std::size_t begin, std::size_t end, auto&& is_before) -> std::size_t {
+		while (begin < end) {
+			const std::size_t middle = begin + (end - begin) / 2;
+			if (is_before(dates[middle % retention])) {
+				begin = middle + 1;
+			} else {
+				end = middle;
+			}
+		}
+		return begin;
+	};
+	const std::size_t begin = first_not_before(
+		get_first_sample(), sample_count, [from_date](const Date date) -> bool { return date < from_date; }
+	);
+	const std::size_t end = first_not_before(
+		begin, sample_count, [to_date](const Date date) -> bool { return date <= to_date; }
+	);
+	return { begin, end };
+}
+
+void TimeSeriesStore::push_sample(const Date date, std::span<const fixed_point_t> values) {
+	assert(values.size() == series_count);
+	assert(sample_count == 0 || dates[(sample_count - 1) % retention] <= date);
+
+	const std::size_t sample_index = sample_count++;
+	dates[sample_index % retention] = date;
+
+	for (std::size_t series_index = 0; series_index < series_count; ++series_index) {
+		series_state_t& state = series_states[series_index];
+		const fixed_point_t value = values[series_index];
+		const int64_t delta = value.get_raw_value() - state.last_value.get_raw_value();
+		int32_t& delta_slot = deltas[series_index * delta_capacity + sample_index % delta_capacity];
+
+		if (
+			state.keyframe_count == 0
+			|| sample_index - keyframe_samples[get_keyframe_slot(series_index, state.keyframe_count - 1)] >= KEYFRAME_INTERVAL
+			|| delta < std::numeric_limits<int32_t>::min() || delta > std::numeric_limits<int32_t>::max()
+		) {
+			push_keyframe(series_index, sample_index, value);
+			delta_slot = 0;
+		} else {
+			delta_slot = static_cast<int32_t>(delta);
+		}
+		state.last_value = value;
+	}
+}
+
+template<typename Callback>
+std::size_t TimeSeriesStore::for_each_value(
+	const std::size_t series_index, std::size_t begin, std::size_t end, Callback&& callback
+) const {
+	begin = std::max(begin, get_oldest_sample(series_index));
+	end = std::min(end, sample_count);
+	if (begin >= end) {
+		return 0;
+	}
+
+	// Start from the last keyframe at or before begin.
+	series_state_t const& state = series_states[series_index];
+	std::size_t low = 0;
+	std::size_t high = state.keyframe_count;
+	while (high - low > 1) {
+		const std::size_t middle = low + (high - low) / 2;
+		if (keyframe_samples[get_keyframe_slot(series_index, middle)] <= begin) {
+			low = middle;
+		} else {
+			high = middle;
+		}
+	}
+
+	std::size_t next_keyframe_index = low;
+	std::size_t next_keyframe_sample = keyframe_samples[get_keyframe_slot(series_index, next_keyframe_index)];
+	int32_t const* const series_deltas = deltas.data() + series_index * delta_capacity;
+	fixed_point_t value = fixed_point_t::_0;
+
+	for (std::size_t sample_index = next_keyframe_sample; sample_index < end; ++sample_index) {
+		if (sample_index == next_keyframe_sample) {
+			value = keyframe_values[get_keyframe_slot(series_index, next_keyframe_index)];
+			if (++next_keyframe_index < state.keyframe_count) {
+				next_keyframe_sample = keyframe_samples[get_keyframe_slot(series_index, next_keyframe_index)];
+			}
+		} else {
+			value = fixed_point_t::parse_raw(value.get_raw_value() + series_deltas[sample_index % delta_capacity]);
+		}
+
+		if (sample_index >= begin) {
+			callback(value);
+		}
+	}
+
+	return end - begin;
+}
+
+std::size_t TimeSeriesStore::read(
+	const std::size_t series_index, const std::size_t begin, const std::size_t end, std::span<fixed_point_t> values
+) const {
+	std::size_t written = 0;
+	for_each_value(
+		series_index, begin, std::min(end, std::max(begin, get_oldest_sample(series_index)) + values.size()),
+		[&values, &written](const fixed_point_t value) -> void {
+			values[written++] = value;
+		}
+	);
+	return written;
+}
+
+std::size_t TimeSeriesStore::downsample(
+	const std::size_t series_index,
+	const std::size_t begin,
+	const std::size_t end,
+	const std::size_t bucket_size,
+	const aggregate_t aggregate,
+	std::span<fixed_point_t> buckets
+) const {
+	assert(bucket_size > 0);
+
+	std::size_t bucket_count = 0;
+	std::size_t bucket_fill = 0;
+	int64_t bucket_sum = 0;
+	fixed_point_t bucket_value = fixed_point_t::_0;
+
+	const auto finish_bucket = [&]() -> void {
+		if (aggregate == aggregate_t::MEAN) {
+			bucket_value = fixed_point_t::parse_raw(bucket_sum / static_cast<int64_t>(bucket_fill));
+		}
+		buckets[bucket_count++] = bucket_value;
+		bucket_fill = 0;
+		bucket_sum = 0;
+	};
+
+	const std::size_t clamped_begin = std::max(begin, get_oldest_sample(series_index));
+	const std::size_t clamped_end = clamped_begin + std::min(
+		end > clamped_begin ? end - clamped_begin : 0,
+		// Whole buckets that fit in buckets
+		buckets.size() * bucket_size
+	);
+
+	for_each_value(
+		series_index, clamped_begin, clamped_end,
+		[&](const fixed_point_t value) -> void {
+			switch (aggregate) {
+				case aggregate_t::MEAN:
+					bucket_sum += value.get_raw_value();
+					break;
+				case aggregate_t::MIN:
+					bucket_value = bucket_fill == 0 ? value : std::min(bucket_value, value);
+					break;
+				case aggregate_t::MAX:
+					bucket_value = bucket_fill == 0 ? value : std::max(bucket_value, value);
+					break;
+				case aggregate_t::LAST:
+					bucket_value = value;
+					break;
+			}
+			if (++bucket_fill == bucket_size) {
+				finish_bucket();
+			}
+		}
+	);
+
+	if (bucket_fill > 0) {
+		finish_bucket();
+	}
+	return bucket_count;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	/* Columnar store of fixed point series that are all sampled together, e.g. one series per good and metric.
+	 * Each series keeps the changes between its samples as 32 bit deltas, with a full value keyframe at least every
+	 * KEYFRAME_INTERVAL samples and whenever a change doesn't fit in 32 bits, so it takes about half the memory of
+	 * plain fixed_point_ts. The last `retention` samples are kept, addressed by their index since the store was created.
+	 * Queries write into caller provided spans and cost the length of the range plus up to KEYFRAME_INTERVAL samples
+	 * decoded from the preceding keyframe, so reading history never allocates or touches the live objects. */
+	struct TimeSeriesStore {
+		enum struct aggregate_t : uint8_t {
+			MEAN, MIN, MAX, LAST
+		};
+
+		static constexpr std::size_t KEYFRAME_INTERVAL = 32;
+
+	private:
+		struct series_state_t {
+			fixed_point_t last_value;
+			// Keyframes of a series are a ring ordered by sample, the oldest is at keyframe_head.
+			std::size_t keyframe_head = 0;
+			std::size_t keyframe_count = 0;
+		};
+
+		const std::size_t series_count;
+		const std::size_t retention;
+		// A sample's delta slot is only reused KEYFRAME_INTERVAL samples after it leaves the retention,
+		// so the oldest retained sample can always be decoded from the keyframe before it.
+		const std::size_t delta_capacity;
+		// Room for the regular keyframes of the retention and as many again for changes too large for a delta,
+		// a series that needs more keeps a shorter history, see get_oldest_sample.
+		const std::size_t keyframe_capacity;
+		std::size_t sample_count = 0;
+
+		memory::vector<Date> dates;
+		memory::vector<series_state_t> series_states;
+		// By series then slot.
+		memory::vector<int32_t> deltas;
+		memory::vector<fixed_point_t> keyframe_values;
+		memory::vector<std::size_t> keyframe_samples;
+
+		std::size_t get_keyframe_slot(const std::size_t series_index, const std::size_t keyframe_index) const;
+		void push_keyframe(const std::size_t series_index, const std::size_t sample_index, const fixed_point_t value);
+
+		template<typename Callback>
+		std::size_t for_each_value(
+			const std::size_t series_index, std::size_t begin, std::size_t end, Callback&& callback
+		) const;
+
+	public:
+		TimeSeriesStore(const std::size_t new_series_count, const std::size_t new_retention);
+		TimeSeriesStore(TimeSeriesStore&&) = delete;
+		TimeSeriesStore(TimeSeriesStore const&) = delete;
+		TimeSeriesStore& operator=(TimeSeriesStore&&) = delete;
+		TimeSeriesStore& operator=(TimeSeriesStore const&) = delete;
+
+		constexpr std::size_t get_series_count() const {
+			return series_count;
+		}
+		constexpr std::size_t get_retention() const {
+			return retention;
+		}
+		// Samples recorded since the store was created, the next sample gets this index.
+		constexpr std::size_t get_sample_count() const {
+			return sample_count;
+		}
+		// Index of the oldest retained sample.
+		constexpr std::size_t get_first_sample() const {
+			return sample_count > retention ? sample_count - retention : 0;
+		}
+		// Index of the oldest sample of the series that can still be read, later than get_first_sample()
+		// only if the series needed more keyframes than keyframe_capacity within the retention.
+		std::size_t get_oldest_sample(const std::size_t series_index) const;
+		Date get_sample_date(const std::size_t sample_index) const;
+		// Samples [begin, end) are the retained samples dated from from_date to to_date inclusive.
+		std::pair<std::size_t, std::size_t> find_sample_range(const Date from_date, const Date to_date) const;
+
+		// values holds one value per series, in series order.
+		void push_sample(const Date date, std::span<const fixed_point_t> values);
+
+		/* Writes the values of samples [begin, end) of the series into values, clamped to the samples that can be read
+		 * and to the size of values, starting from the clamped begin. Returns the number of values written. */
+		std::size_t read(
+			const std::size_t series_index, const std::size_t begin, const std::size_t end, std::span<fixed_point_t> values
+		) const;
+		/* Aggregates samples [begin, end) of the series, clamped like read, into buckets of bucket_size consecutive
+		 * samples, the last bucket may be partial. Returns the number of buckets written. */
+		std::size_t downsample(
+			const std::size_t series_index,
+			const std::size_t begin,
+			const std::size_t end,
+			const std::size_t bucket_size,
+			const aggregate_t aggregate,
+			std::span<fixed_point_t> buckets
+		) const;
+	};
+}
@@ -47,6 +47,7 @@ TYPED_INDEX(building_type_index_t)
 TYPED_INDEX(province_building_index_t)
 TYPED_INDEX(country_index_t)
 TYPED_INDEX(crime_index_t)
+TYPED_INDEX(culture_index_t)
 TYPED_INDEX(good_category_index_t)
 TYPED_INDEX(good_index_t)
 TYPED_INDEX(government_type_index_t)
@@ -54,12 +55,15 @@ TYPED_INDEX(graphical_culture_index_t)
 TYPED_INDEX(ideology_index_t)
 TYPED_INDEX(invention_index_t)
 TYPED_INDEX(map_mode_index_t)
+TYPED_INDEX(modifier_effect_index_t)
 TYPED_INDEX(party_policy_index_t)
 TYPED_INDEX(party_policy_group_index_t)
 TYPED_INDEX(pop_type_index_t)
+TYPED_INDEX(production_type_index_t)
 TYPED_INDEX(rebel_type_index_t)
 TYPED_INDEX(reform_index_t)
 TYPED_INDEX(reform_group_index_t)
+TYPED_INDEX(religion_index_t)
 TYPED_INDEX(regiment_type_index_t)
 TYPED_INDEX(ship_type_index_t)
 TYPED_INDEX(strata_index_t)
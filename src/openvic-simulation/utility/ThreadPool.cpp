@@ -1,38 +1,65 @@
 #include "ThreadPool.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <span>
-#include <thread>
+#include <utility>
 
 #include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
 #include "openvic-simulation/economy/GoodDefinition.hpp" // IWYU pragma: keep for constructor requirement
 #include "openvic-simulation/economy/GoodInstance.hpp"
 #include "openvic-simulation/economy/trading/GoodMarket.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/ConstructorTags.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
 
 using namespace OpenVic;
 
-void ThreadPool::loop_until_cancelled(
-	work_t& work_type,
-	GameRulesManager const& game_rules_manager,
-	GoodInstanceManager const& good_instance_manager,
-	ModifierEffectCache const& modifier_effect_cache,
-	PopsDefines const& pop_defines,
-	ProductionTypeManager const& production_type_manager,
-	forwardable_span<const CountryInstance> country_keys,
-	const good_index_t good_count,
-	const strata_index_t strata_count,
-	forwardable_span<WorkBundle> work_bundles
+//Splits elements into WORK_BUNDLE_COUNT contiguous chunks of roughly equal total cost.
+template<typename T, typename CostFunc, typename SetChunk>
+static void partition_by_cost(
+	forwardable_span<T> elements,
+	memory::vector<std::size_t>& reusable_cost_vector,
+	CostFunc&& get_cost,
+	SetChunk&& set_chunk,
+	const std::size_t chunk_count
 ) {
-	memory::FixedVector<char, good_index_t> reusable_goods_mask { good_count, {} };
+	memory::vector<std::size_t>& prefix_cost = reusable_cost_vector;
+	prefix_cost.resize(elements.size());
+	std::size_t total_cost = 0;
+	for (std::size_t i = 0; i < elements.size(); ++i) {
+		total_cost += get_cost(elements[i]);
+		prefix_cost[i] = total_cost;
+	}
+
+	std::size_t begin = 0;
+	for (std::size_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+		std::size_t end;
+		if (chunk_index + 1 == chunk_count) {
+			end = elements.size();
+		} else {
+			//first element at which the running cost reaches this chunk's share
+			const std::size_t target_cost = total_cost * (chunk_index + 1) / chunk_count;
+			end = std::lower_bound(prefix_cost.begin() + begin, prefix_cost.end(), target_cost) - prefix_cost.begin();
+			if (end < elements.size()) {
+				++end;
+			}
+		}
 
-	memory::FixedVector<fixed_point_t, country_index_t> reusable_country_map_0 { country_index_t(country_keys.size()), fixed_point_t::_0 };
-	memory::FixedVector<fixed_point_t, country_index_t> reusable_country_map_1 { country_index_t(country_keys.size()), fixed_point_t::_0 };
+		set_chunk(chunk_index, std::span<T> { elements.data() + begin, end - begin });
+		begin = end;
+	}
 
+	prefix_cost.clear();
+}
+
+struct ThreadPool::WorkerScratch {
 	static constexpr std::size_t VECTOR_COUNT = std::max(
 		GoodMarket::VECTORS_FOR_EXECUTE_ORDERS,
 		std::max(
@@ -40,148 +67,127 @@ void ThreadPool::loop_until_cancelled(
 			ProvinceInstance::VECTORS_FOR_PROVINCE_TICK
 		)
 	);
+
+	memory::FixedVector<char, good_index_t> reusable_goods_mask;
+	memory::FixedVector<fixed_point_t, country_index_t> reusable_country_map_0;
+	memory::FixedVector<fixed_point_t, country_index_t> reusable_country_map_1;
 	std::array<memory::vector<fixed_point_t>, VECTOR_COUNT> reusable_vectors;
-	std::span<memory::vector<fixed_point_t>, VECTOR_COUNT> reusable_vectors_span = std::span(reusable_vectors);
 	memory::vector<good_index_t> reusable_good_index_vector;
-	PopValuesFromProvince reusable_pop_values {
-		game_rules_manager,
-		good_instance_manager,
-		modifier_effect_cache,
-		production_type_manager,
-		pop_defines,
-		strata_count
-	};
-
-	while (!is_cancellation_requested) {
-		work_t work_type_copy;
-		{
-			std::unique_lock<std::mutex> thread_lock { thread_mutex };
-			thread_condition.wait(
-				thread_lock,
-				[this, &work_type]() -> bool {
-					return is_cancellation_requested || work_type != work_t::NONE;
-				}
-			);
-
-			if (is_cancellation_requested) {
-				return;
+	PopValuesFromProvince reusable_pop_values;
+
+	WorkerScratch(
+		GameRulesManager const& game_rules_manager,
+		GoodInstanceManager const& good_instance_manager,
+		ModifierEffectCache const& modifier_effect_cache,
+		PopsDefines const& pop_defines,
+		ProductionTypeManager const& production_type_manager,
+		const country_index_t country_count,
+		const good_index_t good_count,
+		const strata_index_t strata_count
+	) : reusable_goods_mask { good_count, {} },
+		//GoodMarket::execute_orders uses the extra last entry for orders without a country
+		reusable_country_map_0 { country_count + country_index_t { 1 }, fixed_point_t::_0 },
+		reusable_country_map_1 { country_count + country_index_t { 1 }, fixed_point_t::_0 },
+		reusable_pop_values {
+			game_rules_manager,
+			good_instance_manager,
+			modifier_effect_cache,
+			production_type_manager,
+			pop_defines,
+			strata_count
+		} {}
+};
+
+void ThreadPool::process_work_bundle(
+	const work_t work_type,
+	const std::size_t bundle_index,
+	WorkBundle& work_bundle,
+	WorkerScratch& scratch
+) {
+	//each bundle appends its market orders to its own buffer of every good
+	static_assert(GoodMarket::ORDER_BUFFER_COUNT == WORK_BUNDLE_COUNT);
+
+	std::span<memory::vector<fixed_point_t>, WorkerScratch::VECTOR_COUNT> reusable_vectors_span = std::span(scratch.reusable_vectors);
+
+	switch (work_type) {
+		case work_t::NONE:
+			break;
+		case work_t::PROVINCE_TICK:
+			for (ProvinceInstance& province : work_bundle.provinces_chunk) {
+				province.province_tick(
+					current_date,
+					scratch.reusable_pop_values,
+					work_bundle.random_number_generator,
+					bundle_index,
+					scratch.reusable_goods_mask,
+					reusable_vectors_span.first<ProvinceInstance::VECTORS_FOR_PROVINCE_TICK>()
+				);
 			}
-			work_type_copy = work_type;
-			work_type = work_t::NONE;
-		}
-
-		switch (work_type_copy) {
-			case work_t::NONE:
-				break;
-			case work_t::GOOD_EXECUTE_ORDERS:
-				for (WorkBundle& work_bundle : work_bundles) {
-					for (GoodMarket& good : work_bundle.goods_chunk) {
-						good.execute_orders(
-							reusable_country_map_0,
-							reusable_country_map_1,
-							reusable_vectors_span.first<GoodMarket::VECTORS_FOR_EXECUTE_ORDERS>()
-						);
-					}
-				}
-				break;
-			case work_t::PROVINCE_TICK:
-				for (WorkBundle& work_bundle : work_bundles) {
-					for (ProvinceInstance& province : work_bundle.provinces_chunk) {
-						province.province_tick(
-							current_date,
-							reusable_pop_values,
-							work_bundle.random_number_generator,
-							reusable_goods_mask,
-							reusable_vectors_span.first<ProvinceInstance::VECTORS_FOR_PROVINCE_TICK>()
-						);
-					}
-				}
-				break;
-			case work_t::PROVINCE_INITIALISE_FOR_NEW_GAME:
-				for (WorkBundle& work_bundle : work_bundles) {
-					for (ProvinceInstance& province : work_bundle.provinces_chunk) {
-						province.initialise_for_new_game(
-							current_date,
-							reusable_pop_values,
-							work_bundle.random_number_generator,
-							reusable_goods_mask,
-							reusable_vectors_span.first<ProvinceInstance::VECTORS_FOR_PROVINCE_TICK>()
-						);
-					}
-				}
-				break;
-			case work_t::COUNTRY_TICK_BEFORE_MAP:
-				for (WorkBundle& work_bundle : work_bundles) {
-					for (CountryInstance& country : work_bundle.countries_chunk) {
-						country.country_tick_before_map(
-							reusable_goods_mask,
-							reusable_vectors_span.first<CountryInstance::VECTORS_FOR_COUNTRY_TICK>(),
-							reusable_good_index_vector
-						);
-					}
-				}
-				break;
-			case work_t::COUNTRY_TICK_AFTER_MAP:
-				for (WorkBundle& work_bundle : work_bundles) {
-					for (CountryInstance& country : work_bundle.countries_chunk) {
-						country.country_tick_after_map(current_date);
-					}
-				}
-				break;
-		}
-
-		{
-			std::lock_guard<std::mutex> completed_lock { completed_mutex };
-			if (--active_work_count == 0) {
-				completed_condition.notify_one();
+			break;
+		case work_t::COUNTRY_AND_RGO_SETTLE_TRADES:
+			for (CountryInstance& country : work_bundle.countries_chunk) {
+				country.settle_trades();
 			}
-		}
+			for (ProvinceInstance& province : work_bundle.provinces_chunk) {
+				province.settle_rgo_trades(reusable_vectors_span[0]);
+			}
+			break;
+		case work_t::PROVINCE_SETTLE_POP_TRADES:
+			for (ProvinceInstance& province : work_bundle.provinces_chunk) {
+				province.settle_pop_trades();
+			}
+			break;
+		case work_t::PROVINCE_INITIALISE_FOR_NEW_GAME:
+			for (ProvinceInstance& province : work_bundle.provinces_chunk) {
+				province.initialise_for_new_game(
+					current_date,
+					scratch.reusable_pop_values,
+					work_bundle.random_number_generator,
+					bundle_index,
+					scratch.reusable_goods_mask,
+					reusable_vectors_span.first<ProvinceInstance::VECTORS_FOR_PROVINCE_TICK>()
+				);
+			}
+			break;
+		case work_t::COUNTRY_TICK_BEFORE_MAP:
+			for (CountryInstance& country : work_bundle.countries_chunk) {
+				country.country_tick_before_map(
+					bundle_index,
+					scratch.reusable_goods_mask,
+					reusable_vectors_span.first<CountryInstance::VECTORS_FOR_COUNTRY_TICK>(),
+					scratch.reusable_good_index_vector
+				);
+			}
+			break;
+		case work_t::COUNTRY_TICK_AFTER_MAP:
+			for (CountryInstance& country : work_bundle.countries_chunk) {
+				country.country_tick_after_map(current_date);
+			}
+			break;
 	}
 }
 
 void ThreadPool::process_work(const work_t work_type) {
-	{
-		std::unique_lock<std::mutex> thread_lock { thread_mutex };
-		if (is_cancellation_requested) {
-			return;
-		}
-
-		{
-			std::lock_guard<std::mutex> completed_lock { completed_mutex };
-			active_work_count = threads.size();
-		}
-
-		for (work_t& work_for_thread : work_per_thread) {
-			work_for_thread = work_type;
-		}
-		thread_condition.notify_all();
+	if (scratch_per_worker.empty()) {
+		spdlog::error_s("Attempted to process work before initialising ThreadPool.");
+		return;
 	}
-	await_completion();
-}
 
-void ThreadPool::await_completion() {
-	std::unique_lock<std::mutex> completed_lock { completed_mutex };
-	completed_condition.wait(
-		completed_lock,
-		[this]() -> bool {
-			return active_work_count == 0;
+	//bundles must not dispatch nested work, the worker's scratch is in use until the bundle returns
+	executor.parallel_for(
+		WORK_BUNDLE_COUNT,
+		[this, work_type](const std::size_t bundle_index, const uint32_t worker_id) -> void {
+			process_work_bundle(work_type, bundle_index, all_work_bundles[bundle_index], scratch_per_worker[worker_id]);
 		}
 	);
 }
 
-ThreadPool::ThreadPool(Date const& new_current_date)
-	: current_date {new_current_date} {}
+ThreadPool::ThreadPool(ecs::EcsThreadPool& new_executor, Date const& new_current_date)
+	: executor { new_executor },
+	scratch_per_worker { create_empty },
+	current_date { new_current_date } {}
 
-ThreadPool::~ThreadPool() {
-	{
-		std::lock_guard<std::mutex> thread_lock { thread_mutex };
-		is_cancellation_requested = true;
-		thread_condition.notify_all();
-	}
-	for (std::thread& thread : threads) {
-		thread.join();
-	}
-}
+ThreadPool::~ThreadPool() = default;
 
 void ThreadPool::initialise_threadpool(
 	GameRulesManager const& game_rules_manager,
@@ -194,111 +200,149 @@ void ThreadPool::initialise_threadpool(
 	forwardable_span<CountryInstance> countries,
 	forwardable_span<ProvinceInstance> provinces
 ) {
-	if (threads.size() > 0) {
+	if (!scratch_per_worker.empty()) {
 		spdlog::error_s("Attempted to initialise ThreadPool again.");
 		return;
 	}
 
 	RandomU32 master_rng { }; //TODO seed?
 
+	all_goods = goods;
+	all_provinces = provinces;
+	country_count = country_index_t(countries.size());
+	goods_by_order_count.reserve(goods.size());
+	for (GoodInstance& good : goods) {
+		goods_by_order_count.push_back(&good);
+	}
 
-	const auto [goods_quotient, goods_remainder] = std::ldiv(goods.size(), WORK_BUNDLE_COUNT);
 	const auto [countries_quotient, countries_remainder] = std::ldiv(countries.size(),WORK_BUNDLE_COUNT);
-	const auto [provinces_quotient, provinces_remainder] = std::ldiv(provinces.size(),WORK_BUNDLE_COUNT);
-	auto goods_begin = goods.begin();
 	auto countries_begin = countries.begin();
-	auto provinces_begin = provinces.begin();
 
 	for (std::size_t i = 0; i < WORK_BUNDLE_COUNT; i++) {
-		const std::size_t goods_chunk_size = i < goods_remainder
-			? goods_quotient + 1
-			: goods_quotient;
 		const std::size_t countries_chunk_size = i < countries_remainder
 			? countries_quotient + 1
 			: countries_quotient;
-		const std::size_t provinces_chunk_size = i < provinces_remainder
-			? provinces_quotient + 1
-			: provinces_quotient;
 
-		auto goods_end = goods_begin + goods_chunk_size;
 		auto countries_end = countries_begin + countries_chunk_size;
-		auto provinces_end = provinces_begin + provinces_chunk_size;
 
 		all_work_bundles[i] = WorkBundle {
 			master_rng.generator().serialize(),
 			std::span<CountryInstance>{ countries_begin, countries_end },
-			std::span<GoodInstance>{ goods_begin, goods_end },
-			std::span<ProvinceInstance>{ provinces_begin, provinces_end }
+			{}
 		};
 
 		//ensure different state for next WorkBundle
 		master_rng.generator().jump();
 
-		goods_begin = goods_end;
 		countries_begin = countries_end;
-		provinces_begin = provinces_end;
 	}
 
-	const std::size_t max_worker_threads = std::min(
-		std::max<std::size_t>(std::thread::hardware_concurrency(), 1),
-		WORK_BUNDLE_COUNT
-	);
-	threads.reserve(max_worker_threads);
-	work_per_thread.resize(max_worker_threads, work_t::NONE);
-
-	
-	const auto [work_bundles_quotient, work_bundles_remainder] = std::ldiv(WORK_BUNDLE_COUNT, max_worker_threads);
-	auto work_bundles_begin = all_work_bundles.begin();
-
-	for (std::size_t i = 0; i < max_worker_threads; ++i) {
-		const std::size_t work_bundles_chunk_size = i < work_bundles_remainder
-			? work_bundles_quotient + 1
-			: work_bundles_quotient;
-
-		auto work_bundles_end = work_bundles_begin + work_bundles_chunk_size;
-
-		threads.emplace_back(
-			[
-				this,
-				&work_for_thread = work_per_thread[i],
-				&game_rules_manager,
-				&good_instance_manager,
-				&modifier_effect_cache,
-				&pop_defines,
-				&production_type_manager,
-				countries,
-				good_count = good_index_t(goods.size()),
-				strata_count,
-				work_bundles_begin,
-				work_bundles_end
-			]() -> void {
-				loop_until_cancelled(
-					work_for_thread,
-					game_rules_manager,
-					good_instance_manager,
-					modifier_effect_cache,
-					pop_defines,
-					production_type_manager,
-					countries,
-					good_count,
-					strata_count,
-					std::span<WorkBundle>{ work_bundles_begin, work_bundles_end }
-				);
-			}
+	rebalance_province_bundles();
+
+	const uint32_t worker_count = executor.worker_count();
+	memory::FixedVector<WorkerScratch> new_scratch_per_worker { create_empty, worker_count };
+	for (uint32_t i = 0; i < worker_count; ++i) {
+		new_scratch_per_worker.emplace_back(
+			game_rules_manager,
+			good_instance_manager,
+			modifier_effect_cache,
+			pop_defines,
+			production_type_manager,
+			country_index_t(countries.size()),
+			good_index_t(goods.size()),
+			strata_count
 		);
-
-		work_bundles_begin = work_bundles_end;
 	}
+	scratch_per_worker = std::move(new_scratch_per_worker);
+}
+
+void ThreadPool::rebalance_province_bundles() {
+	//pop ticks dominate, the constant covers buildings and the rgo
+	partition_by_cost(
+		all_provinces,
+		reusable_cost_vector,
+		[](ProvinceInstance const& province) -> std::size_t {
+			return 1 + province.get_pop_count();
+		},
+		[this](const std::size_t bundle_index, std::span<ProvinceInstance> provinces_chunk) -> void {
+			all_work_bundles[bundle_index].provinces_chunk = provinces_chunk;
+		},
+		WORK_BUNDLE_COUNT
+	);
 }
 
 void ThreadPool::process_good_execute_orders() {
-	process_work(work_t::GOOD_EXECUTE_ORDERS);
+	if (scratch_per_worker.empty()) {
+		spdlog::error_s("Attempted to execute orders before initialising ThreadPool.");
+		return;
+	}
+
+	executor.parallel_for(
+		all_goods.size(),
+		[this](const std::size_t good_index, const uint32_t) -> void {
+			all_goods[good_index].gather_orders(country_count);
+		}
+	);
+
+	good_order_blocks.clear();
+	for (GoodInstance& good : all_goods) {
+		for (std::size_t block_index = 0; block_index < good.get_order_block_count(); ++block_index) {
+			good_order_blocks.emplace_back(&good, block_index);
+		}
+	}
+	executor.parallel_for(
+		good_order_blocks.size(),
+		[this](const std::size_t i, const uint32_t) -> void {
+			auto const& [good, block_index] = good_order_blocks[i];
+			good->sum_order_block(block_index);
+		}
+	);
+
+	//longest processing time first, stable so ties keep good index order
+	std::stable_sort(
+		goods_by_order_count.begin(),
+		goods_by_order_count.end(),
+		[](GoodInstance const* a, GoodInstance const* b) -> bool {
+			return a->get_order_count() > b->get_order_count();
+		}
+	);
+
+	//one task per worker, each keeps taking the next largest good until none are left
+	std::atomic<std::size_t> next_good { 0 };
+	executor.parallel_for(
+		scratch_per_worker.size(),
+		[this, &next_good](const std::size_t, const uint32_t worker_id) -> void {
+			WorkerScratch& scratch = scratch_per_worker[worker_id];
+			std::span<memory::vector<fixed_point_t>, WorkerScratch::VECTOR_COUNT> reusable_vectors_span = std::span(scratch.reusable_vectors);
+			for (
+				std::size_t i = next_good.fetch_add(1, std::memory_order_relaxed);
+				i < goods_by_order_count.size();
+				i = next_good.fetch_add(1, std::memory_order_relaxed)
+			) {
+				GoodMarket& good = *goods_by_order_count[i];
+				good.execute_orders(
+					scratch.reusable_country_map_0,
+					scratch.reusable_country_map_1,
+					reusable_vectors_span.first<GoodMarket::VECTORS_FOR_EXECUTE_ORDERS>()
+				);
+				good.publish_results();
+			}
+		}
+	);
 }
 
 void ThreadPool::process_province_ticks() {
 	process_work(work_t::PROVINCE_TICK);
 }
 
+void ThreadPool::process_country_and_rgo_settle_trades() {
+	process_work(work_t::COUNTRY_AND_RGO_SETTLE_TRADES);
+}
+
+void ThreadPool::process_province_settle_pop_trades() {
+	process_work(work_t::PROVINCE_SETTLE_POP_TRADES);
+}
+
 void ThreadPool::process_province_initialise_for_new_game() {
 	process_work(work_t::PROVINCE_INITIALISE_FOR_NEW_GAME);
 }
@@ -1,13 +1,11 @@
 #pragma once
 
 #include <array>
-#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
-#include <mutex>
-#include <thread>
+#include <utility>
 
-#include "openvic-simulation/population/PopValuesFromProvince.hpp"
+#include "openvic-simulation/core/memory/FixedVector.hpp"
 #include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/portable/ForwardableSpan.hpp"
 #include "openvic-simulation/core/random/RandomGenerator.hpp"
@@ -15,6 +13,10 @@
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/TypedIndices.hpp"
 
+namespace OpenVic::ecs {
+	class EcsThreadPool;
+}
+
 namespace OpenVic {
 	struct GameRulesManager;
 	struct GoodDefinition;
@@ -31,7 +33,6 @@ namespace OpenVic {
 	public:
 		RandomU32 random_number_generator;
 		forwardable_span<CountryInstance> countries_chunk;
-		forwardable_span<GoodInstance> goods_chunk;
 		forwardable_span<ProvinceInstance> provinces_chunk;
 
 		constexpr WorkBundle() {}
@@ -39,53 +40,54 @@ namespace OpenVic {
 		WorkBundle(
 			RandomU32::state_type rng_state,
 			forwardable_span<CountryInstance> new_countries_chunk,
-			forwardable_span<GoodInstance> new_goods_chunk,
 			forwardable_span<ProvinceInstance> new_provinces_chunk
 		) : random_number_generator { rng_state },
 			countries_chunk { new_countries_chunk },
-			goods_chunk { new_goods_chunk },
 			provinces_chunk { new_provinces_chunk }
 			{}
 	};
 
+	//Dispatches legacy per-bundle work onto the shared ecs::EcsThreadPool.
+	//Bundles are the unit of scheduling, idle workers steal whole bundles.
 	struct ThreadPool {
 	private:
 		enum struct work_t : uint8_t {
 			NONE,
-			GOOD_EXECUTE_ORDERS,
 			PROVINCE_INITIALISE_FOR_NEW_GAME,
 			PROVINCE_TICK,
+			COUNTRY_AND_RGO_SETTLE_TRADES,
+			PROVINCE_SETTLE_POP_TRADES,
 			COUNTRY_TICK_BEFORE_MAP,
 			COUNTRY_TICK_AFTER_MAP
 		};
 
+		//reusable buffers, one per executor worker so bundles never share them
+		struct WorkerScratch;
+
 		constexpr static std::size_t WORK_BUNDLE_COUNT = 32;
 		std::array<WorkBundle, WORK_BUNDLE_COUNT> all_work_bundles;
-		memory::vector<std::thread> threads;
-		memory::vector<work_t> work_per_thread;
-		std::mutex thread_mutex, completed_mutex;
-		std::condition_variable thread_condition, completed_condition;
-		std::atomic<std::size_t> active_work_count = 0;
-		bool is_cancellation_requested = false;
+		forwardable_span<GoodInstance> all_goods;
+		forwardable_span<ProvinceInstance> all_provinces;
+		country_index_t country_count;
+		memory::vector<std::size_t> reusable_cost_vector;
+		//goods aren't bundled, they're cleared one by one in order of their order count, largest first
+		memory::vector<GoodInstance*> goods_by_order_count;
+		//order blocks of all goods, summed in one parallel pass so large goods are split across workers
+		memory::vector<std::pair<GoodInstance*, std::size_t>> good_order_blocks;
+		ecs::EcsThreadPool& executor;
+		memory::FixedVector<WorkerScratch> scratch_per_worker;
 		Date const& current_date;
 
-		void loop_until_cancelled(
-			work_t& work_type,
-			GameRulesManager const& game_rules_manager,
-			GoodInstanceManager const& good_instance_manager,
-			ModifierEffectCache const& modifier_effect_cache,
-			PopsDefines const& pop_defines,
-			ProductionTypeManager const& production_type_manager,
-			forwardable_span<const CountryInstance> country_keys,
-			const good_index_t good_count,
-			const strata_index_t strata_count,
-			forwardable_span<WorkBundle> work_bundles
+		void process_work_bundle(
+			const work_t work_type,
+			const std::size_t bundle_index,
+			WorkBundle& work_bundle,
+			WorkerScratch& scratch
 		);
-		void await_completion();
 		void process_work(const work_t work_type);
 
 	public:
-		ThreadPool(Date const& new_current_date);
+		ThreadPool(ecs::EcsThreadPool& new_executor, Date const& new_current_date);
 		~ThreadPool();
 
 		void initialise_threadpool(
@@ -100,8 +102,21 @@ namespace OpenVic {
 			forwardable_span<ProvinceInstance> provinces
 		);
 
+		//For work that doesn't fit the bundle shape, e.g. gamestate updates.
+		constexpr ecs::EcsThreadPool& get_executor() const {
+			return executor;
+		}
+
+		//Resize province bundles so each has roughly the same number of pops.
+		//Changes which rng stream each province uses, so only call it at fixed points of the game (load, month start).
+		void rebalance_province_bundles();
+
+		//Not bundled, the goods with the largest order books start first and idle workers take the next good.
+		//The results don't depend on the order the goods are cleared in.
 		void process_good_execute_orders();
 		void process_province_ticks();
+		void process_country_and_rgo_settle_trades();
+		void process_province_settle_pop_trades();
 		void process_province_initialise_for_new_game();
 		void process_country_ticks_before_map();
 		void process_country_ticks_after_map();
@@ -0,0 +1,105 @@
+#include "TickPipeline.hpp"
+
+#include <algorithm>
+#include <span>
+#include <utility>
+
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+
+using namespace OpenVic;
+
+constexpr bool TickPipeline::conflicts(task_t const& earlier, task_t const& later) {
+	return (earlier.writes & (later.reads | later.writes)) != tick_resource_t::NONE
+		|| (earlier.reads & later.writes) != tick_resource_t::NONE;
+}
+
+void TickPipeline::add_task(std::string_view name, tick_resource_t reads, tick_resource_t writes, task_func_t&& func) {
+	tasks.push_back({ name, reads, writes, std::move(func) });
+	is_stage_layout_dirty = true;
+}
+
+void TickPipeline::clear() {
+	tasks.clear();
+	stage_of_task.clear();
+	staged_funcs.clear();
+	stage_offsets.clear();
+	is_stage_layout_dirty = true;
+}
+
+void TickPipeline::set_serial_mode(const bool enabled) {
+	is_serial_mode = enabled;
+}
+
+void TickPipeline::build_stages() {
+	//stage of a task = 1 + the deepest stage of an earlier task it conflicts with
+	stage_of_task.assign(tasks.size(), 0);
+	std::size_t stage_count = 0;
+	for (std::size_t i = 0; i < tasks.size(); ++i) {
+		std::size_t stage = 0;
+		for (std::size_t j = 0; j < i; ++j) {
+			if (conflicts(tasks[j], tasks[i])) {
+				stage = std::max(stage, stage_of_task[j] + 1);
+			}
+		}
+		stage_of_task[i] = stage;
+		stage_count = std::max(stage_count, stage + 1);
+	}
+
+	//within a stage tasks keep their declaration order
+	staged_funcs.clear();
+	staged_funcs.reserve(tasks.size());
+	stage_offsets.clear();
+	stage_offsets.reserve(stage_count + 1);
+	for (std::size_t stage = 0; stage < stage_count; ++stage) {
+		stage_offsets.push_back(staged_funcs.size());
+		for (std::size_t i = 0; i < tasks.size(); ++i) {
+			if (stage_of_task[i] == stage) {
+				staged_funcs.push_back(tasks[i].func);
+			}
+		}
+	}
+	stage_offsets.push_back(staged_funcs.size());
+
+	is_stage_layout_dirty = false;
+}
+
+void TickPipeline::run(ecs::EcsThreadPool& executor) {
+	if (is_serial_mode) {
+		for (task_t const& task : tasks) {
+			task.func();
+		}
+		return;
+	}
+
+	if (is_stage_layout_dirty) {
+		build_stages();
+	}
+
+	for (std::size_t stage = 0; stage + 1 < stage_offsets.size(); ++stage) {
+		executor.run_concurrent(std::span<task_func_t const> {
+			staged_funcs.data() + stage_offsets[stage],
+			staged_funcs.data() + stage_offsets[stage + 1]
+		});
+	}
+}
+
+std::size_t TickPipeline::get_stage_count() {
+	if (is_stage_layout_dirty) {
+		build_stages();
+	}
+	return stage_offsets.empty() ? 0 : stage_offsets.size() - 1;
+}
+
+std::size_t TickPipeline::get_stage_index_of(std::string_view name) {
+	if (is_stage_layout_dirty) {
+		build_stages();
+	}
+	const auto it = std::find_if(tasks.begin(), tasks.end(), [name](task_t const& task) -> bool {
+		return task.name == name;
+	});
+	if (it == tasks.end()) {
+		return SIZE_MAX;
+	}
+
+	return stage_of_task[it - tasks.begin()];
+}
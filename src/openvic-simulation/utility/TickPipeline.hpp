@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/template/EnumBitfield.hpp"
+
+namespace OpenVic::ecs {
+	class EcsThreadPool;
+}
+
+namespace OpenVic {
+	//Gamestate a tick task may touch. Only used to order tasks, nothing is locked.
+	enum struct tick_resource_t : uint16_t {
+		NONE            = 0,
+		COUNTRIES       = 1 << 0,
+		PROVINCES       = 1 << 1,
+		MARKET_ORDERS   = 1 << 2,
+		GOOD_PRICES     = 1 << 3,
+		PRICE_HISTORY   = 1 << 4,
+		UNITS           = 1 << 5,
+		WORK_BUNDLES    = 1 << 6,
+		ECONOMY_HISTORY = 1 << 7
+	};
+
+	template<> struct enable_bitfield<tick_resource_t> : std::true_type {};
+
+	//Ordered list of tick tasks with declared read/write sets.
+	//A task depends on every earlier task it conflicts with (write/write, read/write or write/read),
+	//tasks are grouped into stages by dependency depth and each stage runs concurrently on the executor.
+	//Serial mode runs tasks one by one in the order they were added, i.e. the plain sequential tick.
+	//As long as the declared sets are accurate both modes produce the same gamestate.
+	struct TickPipeline {
+		using task_func_t = std::function<void()>;
+
+	private:
+		struct task_t {
+			std::string_view name;
+			tick_resource_t reads;
+			tick_resource_t writes;
+			task_func_t func;
+		};
+
+		memory::vector<task_t> tasks;
+		//built lazily after tasks change, stage_offsets[i] is the first entry of stage i in staged_funcs
+		memory::vector<std::size_t> stage_of_task;
+		memory::vector<task_func_t> staged_funcs;
+		memory::vector<std::size_t> stage_offsets;
+		bool is_stage_layout_dirty = true;
+		bool is_serial_mode = false;
+
+		static constexpr bool conflicts(task_t const& earlier, task_t const& later);
+		void build_stages();
+
+	public:
+		//name must outlive the pipeline
+		void add_task(std::string_view name, tick_resource_t reads, tick_resource_t writes, task_func_t&& func);
+		void clear();
+
+		void set_serial_mode(const bool enabled);
+		constexpr bool get_serial_mode() const {
+			return is_serial_mode;
+		}
+
+		void run(ecs::EcsThreadPool& executor);
+
+		//Test/introspection only.
+		std::size_t get_stage_count();
+		std::size_t get_stage_index_of(std::string_view name);
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "openvic-simulation/dataloader/Dataloader.hpp"
+#include "openvic-simulation/GameManager.hpp"
+#include "openvic-simulation/history/Bookmark.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+namespace OpenVic::testing {
+	/* Definitions loaded once from the installed game, for the opt-in "[.game-data]" smoke test.
+	 * nullptr when no game install is found, the test skips itself. */
+	inline GameManager const* get_game_definitions() {
+		static const std::unique_ptr<GameManager> game_manager = []() -> std::unique_ptr<GameManager> {
+			const std::filesystem::path root = Dataloader::search_for_game_path();
+			if (root.empty()) {
+				return nullptr;
+			}
+
+			std::unique_ptr<GameManager> new_game_manager = std::make_unique<GameManager>([]() {}, nullptr, nullptr);
+			Dataloader::path_vector_t roots { root };
+			if (
+				!new_game_manager->set_base_path(roots)
+				|| !new_game_manager->load_definitions(
+					[](std::string_view key, Dataloader::locale_t locale, std::string_view localisation) -> bool {
+						return true;
+					}
+				)
+			) {
+				return nullptr;
+			}
+			return new_game_manager;
+		}();
+		return game_manager.get();
+	}
+
+	/* A new game on the first bookmark with its session started, the same worker count and the same seed give the same game.
+	 * Pops get their test values from rand() while the bookmark loads, so it's seeded first. */
+	inline std::unique_ptr<InstanceManager> start_game(GameManager const& game_definitions, const uint32_t worker_count) {
+		std::srand(0);
+
+		std::unique_ptr<InstanceManager> instance_manager = std::make_unique<InstanceManager>(
+			game_definitions.get_game_rules_manager(),
+			game_definitions.get_definition_manager(),
+			[]() {},
+			worker_count
+		);
+
+		Bookmark const* bookmark = game_definitions.get_definition_manager().get_history_manager().get_bookmark_manager()
+			.get_bookmark_by_index(bookmark_index_t { 0 });
+		if (
+			bookmark == nullptr
+			|| !instance_manager->setup()
+			|| !instance_manager->load_bookmark(*bookmark)
+			|| !instance_manager->start_game_session()
+		) {
+			return nullptr;
+		}
+		return instance_manager;
+	}
+}
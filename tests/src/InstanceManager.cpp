@@ -0,0 +1,112 @@
+#include "openvic-simulation/InstanceManager.hpp"
+
+#include <cstddef>
+#include <memory>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/economy/GoodInstance.hpp"
+#include "openvic-simulation/map/MapInstance.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/map/State.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopsAggregate.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "GameData.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_misc.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	struct game_state_digest_t {
+		memory::vector<fixed_point_t> good_prices;
+		memory::vector<pop_size_t> pop_sizes;
+		memory::vector<fixed_point_t> pop_cash;
+		memory::vector<fixed_point_t> country_cash;
+
+		bool operator==(game_state_digest_t const&) const = default;
+	};
+
+	game_state_digest_t get_game_state_digest(InstanceManager& instance_manager) {
+		game_state_digest_t digest;
+		for (GoodInstance const& good_instance : instance_manager.get_good_instance_manager().get_good_instances()) {
+			digest.good_prices.push_back(good_instance.get_price());
+		}
+		for (ProvinceInstance const& province : instance_manager.get_map_instance().get_province_instances()) {
+			for (Pop const& pop : province.get_pops()) {
+				digest.pop_sizes.push_back(pop.get_size());
+				digest.pop_cash.push_back(pop.get_cash());
+			}
+		}
+		for (CountryInstance const& country : instance_manager.get_country_instance_manager().get_country_instances()) {
+			digest.country_cash.push_back(country.get_cash_stockpile().load());
+		}
+		return digest;
+	}
+
+	struct update_kind_counts_t {
+		std::size_t deltas = 0;
+		std::size_t rebuilds = 0;
+
+		void count(PopsAggregate const& aggregate) {
+			switch (aggregate.get_last_pops_aggregate_update()) {
+			case PopsAggregate::update_kind_t::DELTA:
+				++deltas;
+				break;
+			case PopsAggregate::update_kind_t::REBUILD:
+				++rebuilds;
+				break;
+			default:
+				break;
+			}
+		}
+	};
+}
+
+// The only test that loads the installed game, hidden so it only runs when asked for with "[.game-data]".
+TEST_CASE("InstanceManager ticks the same in serial mode as in stages", "[InstanceManager][.game-data]") {
+	GameManager const* game_definitions = get_game_definitions();
+	if (game_definitions == nullptr) {
+		SKIP("no game install found");
+	}
+
+	const std::unique_ptr<InstanceManager> serial_game = start_game(*game_definitions, 4);
+	const std::unique_ptr<InstanceManager> staged_game = start_game(*game_definitions, 4);
+	REQUIRE(serial_game != nullptr);
+	REQUIRE(staged_game != nullptr);
+	serial_game->set_tick_serial_mode(true);
+
+	// Past the first month start, so the monthly price history and bundle rebalancing run as well.
+	for (int day = 0; day < 35; ++day) {
+		serial_game->force_tick_and_update();
+		staged_game->force_tick_and_update();
+	}
+
+	CHECK(serial_game->get_today() == staged_game->get_today());
+	const bool staged_matches_serial = get_game_state_digest(*serial_game) == get_game_state_digest(*staged_game);
+	CHECK(staged_matches_serial);
+
+	// Past the first ticks, aggregates are kept up to date by deltas and only rebuild when their parts or parties change.
+	update_kind_counts_t province_updates;
+	for (ProvinceInstance const& province : staged_game->get_map_instance().get_province_instances()) {
+		province_updates.count(province);
+	}
+	update_kind_counts_t state_updates;
+	for (StateSet const& state_set : staged_game->get_map_instance().get_state_manager().get_state_sets()) {
+		for (State const& state : state_set.get_states()) {
+			state_updates.count(state);
+		}
+	}
+	update_kind_counts_t country_updates;
+	for (CountryInstance const& country : staged_game->get_country_instance_manager().get_country_instances()) {
+		country_updates.count(country);
+	}
+	CHECK(province_updates.deltas > province_updates.rebuilds);
+	CHECK(state_updates.deltas > state_updates.rebuilds);
+	CHECK(country_updates.deltas > country_updates.rebuilds);
+}
@@ -159,4 +159,16 @@ TEST_CASE("bulk_insert_wrapper shrink_to_fit", "[bulk_insert_wrapper][bulk_inser
 	CHECK(wrapper.capacity() <= capacity_before_shrink);
 	CHECK(spy_allocator.metrics->allocation_count >= 1);
 	CHECK(spy_allocator.metrics->allocation_count <= 2);
-}
\ No newline at end of file
+}
+
+TEST_CASE("bulk_insert_wrapper erase", "[bulk_insert_wrapper][bulk_insert_wrapper-erase]") {
+	bulk_insert_wrapper<std::vector<int>> wrapper {
+		std::vector<int> { 1, 2, 3 }
+	};
+
+	const auto next = wrapper.erase(wrapper.cbegin() + 1);
+	CHECK(wrapper.size() == 2);
+	CHECK(*next == 3);
+	CHECK(wrapper[0] == 1);
+	CHECK(wrapper[1] == 3);
+}
@@ -0,0 +1,103 @@
+#include "openvic-simulation/country/CountryEconomyReports.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("CountryEconomyReports collects what every worker reported", "[CountryEconomyReports]") {
+	ecs::EcsThreadPool pool { 4 };
+	CountryEconomyReports reports {
+		pool, country_index_t { 3 }, pop_type_index_t { 2 }, good_index_t { 5 }, {}
+	};
+
+	pool.parallel_for(400, [&reports](const std::size_t i, const uint32_t /*worker_id*/) -> void {
+		const country_index_t country_index { static_cast<uint32_t>(i % 2) };
+		reports.add_taxable_income(country_index, pop_type_index_t { 1 }, 1);
+		reports.add_need_consumption(country_index, pop_type_index_t { 0 }, good_index_t { 4 }, 2);
+		reports.add_pop_demand(country_index, good_index_t { 3 }, 3);
+		reports.add_factory_demand(country_index, good_index_t { 0 }, 4);
+	});
+
+	REQUIRE(reports.collect(country_index_t { 0 }));
+	CHECK(reports.get_taxable_income(country_index_t { 0 }, pop_type_index_t { 1 }) == 200);
+	CHECK(reports.get_taxable_income(country_index_t { 0 }, pop_type_index_t { 0 }) == 0);
+	CHECK(reports.get_need_consumption(country_index_t { 0 }, pop_type_index_t { 0 }, good_index_t { 4 }) == 400);
+	CHECK(reports.get_need_consumption(country_index_t { 0 }, pop_type_index_t { 1 }, good_index_t { 4 }) == 0);
+	CHECK(reports.get_pop_demand(country_index_t { 0 }, good_index_t { 3 }) == 600);
+	CHECK(reports.get_factory_demand(country_index_t { 0 }, good_index_t { 0 }) == 800);
+
+	CHECK_FALSE(reports.collect(country_index_t { 2 }));
+	CHECK(reports.get_pop_demand(country_index_t { 2 }, good_index_t { 3 }) == 0);
+
+	// Collecting clears the worker blocks
+	CHECK_FALSE(reports.collect(country_index_t { 0 }));
+	CHECK(reports.get_pop_demand(country_index_t { 0 }, good_index_t { 3 }) == 0);
+
+	REQUIRE(reports.collect(country_index_t { 1 }));
+	CHECK(reports.get_factory_demand(country_index_t { 1 }, good_index_t { 0 }) == 800);
+}
+
+TEST_CASE("CountryEconomyReports clears what it collected before collecting again", "[CountryEconomyReports]") {
+	ecs::EcsThreadPool pool { 2 };
+	CountryEconomyReports reports {
+		pool, country_index_t { 2 }, pop_type_index_t { 1 }, good_index_t { 3 }, {}
+	};
+
+	// Each slot goes back to 0 before it's reported again, so it's listed twice but must be collected once.
+	pool.parallel_for(2, [&reports](const std::size_t /*i*/, const uint32_t /*worker_id*/) -> void {
+		reports.add_pop_demand(country_index_t { 1 }, good_index_t { 2 }, 5);
+		reports.add_pop_demand(country_index_t { 1 }, good_index_t { 2 }, -5);
+		reports.add_pop_demand(country_index_t { 1 }, good_index_t { 2 }, 7);
+		reports.add_factory_demand(country_index_t { 1 }, good_index_t { 1 }, 0);
+	});
+
+	REQUIRE(reports.collect(country_index_t { 1 }));
+	CHECK(reports.get_pop_demand(country_index_t { 1 }, good_index_t { 2 }) == 14);
+	CHECK(reports.get_factory_demand(country_index_t { 1 }, good_index_t { 1 }) == 0);
+
+	// Only 0 reported, the previous figures are still cleared.
+	pool.parallel_for(2, [&reports](const std::size_t /*i*/, const uint32_t /*worker_id*/) -> void {
+		reports.add_factory_demand(country_index_t { 1 }, good_index_t { 1 }, 0);
+	});
+	CHECK_FALSE(reports.collect(country_index_t { 1 }));
+	CHECK(reports.get_pop_demand(country_index_t { 1 }, good_index_t { 2 }) == 0);
+
+	// The blocks allocated by the first round are reused.
+	pool.parallel_for(2, [&reports](const std::size_t /*i*/, const uint32_t /*worker_id*/) -> void {
+		reports.add_taxable_income(country_index_t { 1 }, pop_type_index_t { 0 }, 3);
+	});
+	REQUIRE(reports.collect(country_index_t { 1 }));
+	CHECK(reports.get_taxable_income(country_index_t { 1 }, pop_type_index_t { 0 }) == 6);
+	CHECK(reports.get_pop_demand(country_index_t { 1 }, good_index_t { 2 }) == 0);
+	CHECK_FALSE(reports.collect(country_index_t { 0 }));
+}
+
+TEST_CASE("CountryEconomyReports only takes reports from its executor's workers", "[CountryEconomyReports]") {
+	ecs::EcsThreadPool pool { 2 };
+	ecs::EcsThreadPool other_pool { 4 };
+	CountryEconomyReports reports {
+		pool, country_index_t { 1 }, pop_type_index_t { 1 }, good_index_t { 1 }, {}
+	};
+
+	// Outside any dispatch, and on workers of another pool, the report is dropped.
+	reports.add_pop_demand(country_index_t { 0 }, good_index_t { 0 }, 1);
+	other_pool.parallel_for(8, [&reports](const std::size_t /*i*/, const uint32_t /*worker_id*/) -> void {
+		reports.add_pop_demand(country_index_t { 0 }, good_index_t { 0 }, 1);
+	});
+	CHECK_FALSE(reports.collect(country_index_t { 0 }));
+
+	// A single chunk runs on the calling thread without spreading to the workers, it still reports as worker 0.
+	pool.parallel_for(1, [&reports](const std::size_t /*i*/, const uint32_t /*worker_id*/) -> void {
+		reports.add_pop_demand(country_index_t { 0 }, good_index_t { 0 }, 2);
+	});
+	REQUIRE(reports.collect(country_index_t { 0 }));
+	CHECK(reports.get_pop_demand(country_index_t { 0 }, good_index_t { 0 }) == 2);
+}
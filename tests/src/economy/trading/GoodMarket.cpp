@@ -1,8 +1,11 @@
 #include "openvic-simulation/economy/GoodDefinition.hpp"
 #include "openvic-simulation/economy/trading/GoodMarket.hpp"
 
+#include <array>
+#include <cstddef>
 #include <optional>
 
+#include "openvic-simulation/core/memory/Vector.hpp"
 #include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
 #include "openvic-simulation/misc/GameRulesManager.hpp"
 #include "openvic-simulation/types/Colour.hpp"
@@ -35,71 +38,310 @@ GoodDefinition good_definition {
 };
 GameRulesManager game_rules_manager {};
 
-struct Trader {
-public:
-	std::function<void(BuyResult const&)> buy_callback = [](
-		BuyResult const& buy_result
-	) -> void {
-		FAIL("Did not expect buy callback");
-	};
-	std::function<void(SellResult const&, memory::vector<fixed_point_t>&)> sell_callback = [](
-		SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector
-	) -> void {
-		FAIL("Did not expect sell callback");
-	};
-
-	static void after_buy(void* actor, BuyResult const& buy_result) {
-	}
-	static void after_sell(void* actor, SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) {
-	}
-};
-
 TEST_CASE("GoodMarket no trading when good isn't available", "[GoodMarket]") {
 	GoodMarket good_market { game_rules_manager, good_definition };
 	const std::optional<country_index_t> country_index_optional = std::nullopt;
 
-	Trader buyer {
-		.buy_callback=[](BuyResult const& buy_result) -> void {
-			CHECK(buy_result.good_index == good_definition.index);
-			CHECK(buy_result.quantity_bought == 0);
-			CHECK(buy_result.money_spent_total == 0);
-			CHECK(buy_result.money_spent_on_imports == 0);
-		}
-	};
+	std::optional<BuyResult> buy_result;
 	const fixed_point_t quantity_to_buy = 1;
 	const fixed_point_t money_to_spend = quantity_to_buy * good_market.get_max_next_price();
-	good_market.add_buy_up_to_order({
+	good_market.add_buy_up_to_order(0, {
 		country_index_optional,
 		quantity_to_buy,
 		money_to_spend,
-		&buyer,
-		Trader::after_buy
+		&buy_result
 	});
 
-	Trader seller {
-		.sell_callback=[](SellResult const& sell_result, memory::vector<fixed_point_t>& reusable_vector) -> void {
-			CHECK(sell_result.good_index == good_definition.index);
-			CHECK(sell_result.quantity_sold == 0);
-			CHECK(sell_result.money_gained == 0);
-		}
-	};
+	std::optional<SellResult> sell_result;
 	const fixed_point_t quantity_to_sell = 1;
-	good_market.add_market_sell_order({
+	good_market.add_market_sell_order(0, {
 		country_index_optional,
 		quantity_to_sell,
-		&seller,
-		Trader::after_sell
+		&sell_result
 	});
 
-	TypedSpan<country_index_t, fixed_point_t> reusable_country_map_0 {};
-	TypedSpan<country_index_t, fixed_point_t> reusable_country_map_1 {};
+	//no countries, only the entry for orders without a country
+	std::array<fixed_point_t, 1> country_map_0 {};
+	std::array<fixed_point_t, 1> country_map_1 {};
+	TypedSpan<country_index_t, fixed_point_t> reusable_country_map_0 { country_map_0.data(), country_map_0.size() };
+	TypedSpan<country_index_t, fixed_point_t> reusable_country_map_1 { country_map_1.data(), country_map_1.size() };
 	std::array<memory::vector<fixed_point_t>, GoodMarket::VECTORS_FOR_EXECUTE_ORDERS> reusable_vectors;
+	good_market.gather_orders(country_index_t { 0 });
+	for (size_t block_index = 0; block_index < good_market.get_order_block_count(); ++block_index) {
+		good_market.sum_order_block(block_index);
+	}
 	good_market.execute_orders(
 		reusable_country_map_0,
 		reusable_country_map_1,
 		reusable_vectors
 	);
+	CHECK_FALSE(buy_result.has_value());
+	CHECK_FALSE(sell_result.has_value());
+	good_market.publish_results();
+
+	REQUIRE(buy_result.has_value());
+	CHECK(buy_result->good_index == good_definition.index);
+	CHECK(buy_result->quantity_bought == 0);
+	CHECK(buy_result->money_spent_total == 0);
+	CHECK(buy_result->money_spent_on_imports == 0);
+
+	REQUIRE(sell_result.has_value());
+	CHECK(sell_result->good_index == good_definition.index);
+	CHECK(sell_result->quantity_sold == 0);
+	CHECK(sell_result->money_gained == 0);
 
 	CHECK(good_market.get_price() == base_price);
 	CHECK(good_market.get_price_change_yesterday() == 0);
-}
\ No newline at end of file
+}
+constexpr bool is_available_from_start = true;
+
+GoodDefinition available_good_definition {
+	"test_available_good",
+	colour_rgb_t {},
+	good_index_t{1},
+	good_category,
+	base_price,
+	is_available_from_start,
+	is_tradeable,
+	is_not_money,
+	does_not_counter_overseas_penalty
+};
+
+namespace {
+	//Optimal pricing with exponential price changes, so base_price 16 moves by exactly 0.125 to 16.125 or 15.875.
+	GameRulesManager make_recommended_rules() {
+		GameRulesManager recommended_rules {};
+		recommended_rules.use_recommended_rules();
+		return recommended_rules;
+	}
+
+	//Runs the clearing steps MarketInstance runs for each good, optionally summing the blocks last to first.
+	void clear_market(GoodMarket& good_market, const std::size_t country_count, const bool sum_blocks_in_reverse = false) {
+		//one entry per country plus one for orders without a country
+		memory::vector<fixed_point_t> country_map_0(country_count + 1);
+		memory::vector<fixed_point_t> country_map_1(country_count + 1);
+		std::array<memory::vector<fixed_point_t>, GoodMarket::VECTORS_FOR_EXECUTE_ORDERS> reusable_vectors;
+
+		good_market.gather_orders(index_from_count<country_index_t>(country_count));
+		const std::size_t block_count = good_market.get_order_block_count();
+		for (std::size_t i = 0; i < block_count; ++i) {
+			good_market.sum_order_block(sum_blocks_in_reverse ? block_count - 1 - i : i);
+		}
+		good_market.execute_orders(
+			{ country_map_0.data(), country_map_0.size() },
+			{ country_map_1.data(), country_map_1.size() },
+			reusable_vectors
+		);
+		good_market.publish_results();
+	}
+}
+
+TEST_CASE("GoodMarket rations supply at the max price", "[GoodMarket]") {
+	const GameRulesManager recommended_rules = make_recommended_rules();
+	GoodMarket good_market { recommended_rules, available_good_definition };
+	const fixed_point_t max_price = good_market.get_max_next_price();
+	CHECK(max_price == fixed_point_t(129) / 8);
+
+	//Purchasing powers at the max price are 40, 6 and 4, so together they buy up to 2 + 3 + 4, more than the supply of 8.
+	//Shares by purchasing power cap the first buyer at 2, then the second at 3, and the last buyer gets the remaining 3.
+	std::array<std::optional<BuyResult>, 3> buy_results;
+	good_market.add_buy_up_to_order(0, { country_index_t { 0 }, 2, max_price * 40, &buy_results[0] });
+	good_market.add_buy_up_to_order(1, { country_index_t { 1 }, 3, max_price * 6, &buy_results[1] });
+	good_market.add_buy_up_to_order(1, { std::nullopt, 20, max_price * 4, &buy_results[2] });
+
+	std::optional<SellResult> sell_result;
+	good_market.add_market_sell_order(0, { country_index_t { 0 }, 8, &sell_result });
+
+	clear_market(good_market, 2);
+
+	REQUIRE(buy_results[0].has_value());
+	CHECK(buy_results[0]->quantity_bought == 2);
+	CHECK(buy_results[0]->money_spent_total == max_price * 2);
+	//supplied by its own country
+	CHECK(buy_results[0]->money_spent_on_imports == 0);
+
+	REQUIRE(buy_results[1].has_value());
+	CHECK(buy_results[1]->quantity_bought == 3);
+	CHECK(buy_results[1]->money_spent_total == max_price * 3);
+	//its country sells nothing
+	CHECK(buy_results[1]->money_spent_on_imports == max_price * 3);
+
+	REQUIRE(buy_results[2].has_value());
+	CHECK(buy_results[2]->quantity_bought == 3);
+	CHECK(buy_results[2]->money_spent_total == max_price * 3);
+	//orders without a country import everything
+	CHECK(buy_results[2]->money_spent_on_imports == max_price * 3);
+
+	REQUIRE(sell_result.has_value());
+	CHECK(sell_result->quantity_sold == 8);
+	CHECK(sell_result->money_gained == max_price * 8);
+
+	CHECK(good_market.get_price() == max_price);
+	CHECK(good_market.get_quantity_traded_yesterday() == 8);
+	CHECK(good_market.get_total_demand_yesterday() == 25);
+	CHECK(good_market.get_total_supply_yesterday() == 8);
+}
+
+TEST_CASE("GoodMarket drops the price to what buyers can pay with optimal pricing", "[GoodMarket]") {
+	const GameRulesManager recommended_rules = make_recommended_rules();
+	GoodMarket good_market { recommended_rules, available_good_definition };
+	CHECK(good_market.get_min_next_price() == fixed_point_t(127) / 8);
+
+	//The buyer can't buy all 4 at the max price, but its money buys exactly 4 at 15.9375,
+	//which is between the min next price and the current price.
+	const fixed_point_t expected_price = fixed_point_t(255) / 16;
+	std::optional<BuyResult> buy_result;
+	good_market.add_buy_up_to_order(0, { country_index_t { 0 }, 8, expected_price * 4, &buy_result });
+
+	std::optional<SellResult> sell_result;
+	good_market.add_market_sell_order(0, { country_index_t { 1 }, 4, &sell_result });
+
+	clear_market(good_market, 2);
+
+	CHECK(good_market.get_price() == expected_price);
+	CHECK(good_market.get_price_change_yesterday() == expected_price - base_price);
+
+	REQUIRE(buy_result.has_value());
+	CHECK(buy_result->quantity_bought == 4);
+	CHECK(buy_result->money_spent_total == expected_price * 4);
+	CHECK(buy_result->money_spent_on_imports == expected_price * 4);
+
+	REQUIRE(sell_result.has_value());
+	CHECK(sell_result->quantity_sold == 4);
+	CHECK(sell_result->money_gained == expected_price * 4);
+}
+
+TEST_CASE("GoodMarket shares exports between sellers", "[GoodMarket]") {
+	const GameRulesManager recommended_rules = make_recommended_rules();
+	GoodMarket good_market { recommended_rules, available_good_definition };
+	const fixed_point_t min_price = good_market.get_min_next_price();
+
+	//Every buyer can afford its quantity at exactly the min next price, far less than the supply of 7.
+	std::array<std::optional<BuyResult>, 3> buy_results;
+	good_market.add_buy_up_to_order(0, { country_index_t { 0 }, 2, min_price * 2, &buy_results[0] });
+	good_market.add_buy_up_to_order(0, { country_index_t { 1 }, 1, min_price, &buy_results[1] });
+	good_market.add_buy_up_to_order(0, { country_index_t { 2 }, 1, min_price, &buy_results[2] });
+
+	std::array<std::optional<SellResult>, 3> sell_results;
+	good_market.add_market_sell_order(0, { country_index_t { 0 }, 4, &sell_results[0] });
+	good_market.add_market_sell_order(0, { country_index_t { 1 }, 2, &sell_results[1] });
+	good_market.add_market_sell_order(0, { std::nullopt, 1, &sell_results[2] });
+
+	clear_market(good_market, 3);
+
+	CHECK(good_market.get_price() == min_price);
+	CHECK(good_market.get_quantity_traded_yesterday() == 4);
+
+	REQUIRE(buy_results[0].has_value());
+	CHECK(buy_results[0]->quantity_bought == 2);
+	CHECK(buy_results[0]->money_spent_on_imports == 0);
+	REQUIRE(buy_results[1].has_value());
+	CHECK(buy_results[1]->quantity_bought == 1);
+	CHECK(buy_results[1]->money_spent_on_imports == 0);
+	//country 2 sells nothing, so its buyer imports the 1 unit traded as export
+	REQUIRE(buy_results[2].has_value());
+	CHECK(buy_results[2]->quantity_bought == 1);
+	CHECK(buy_results[2]->money_spent_on_imports == min_price);
+
+	//3 units are traded domestically, the 1 unit of exports is shared by the 4 units offered for export:
+	//2 by country 0, 1 by country 1 and 1 without a country.
+	const fixed_point_t export_share = fixed_point_t(1) / 4;
+	REQUIRE(sell_results[0].has_value());
+	CHECK(sell_results[0]->quantity_sold == 2 + 2 * export_share);
+	CHECK(sell_results[0]->money_gained == (2 + 2 * export_share) * min_price);
+	REQUIRE(sell_results[1].has_value());
+	CHECK(sell_results[1]->quantity_sold == 1 + export_share);
+	CHECK(sell_results[1]->money_gained == (1 + export_share) * min_price);
+	REQUIRE(sell_results[2].has_value());
+	CHECK(sell_results[2]->quantity_sold == export_share);
+	CHECK(sell_results[2]->money_gained == export_share * min_price);
+}
+
+TEST_CASE("GoodMarket block sums don't depend on the block order", "[GoodMarket]") {
+	//more orders than fit in a block
+	constexpr std::size_t buy_order_count = GoodMarket::ORDER_BLOCK_SIZE + 904;
+	constexpr std::size_t sell_order_count = GoodMarket::ORDER_BLOCK_SIZE + 404;
+	constexpr std::size_t country_count = 3;
+
+	GoodMarket in_order_market { game_rules_manager, available_good_definition };
+	GoodMarket reverse_order_market { game_rules_manager, available_good_definition };
+	memory::vector<std::optional<BuyResult>> in_order_buy_results(buy_order_count);
+	memory::vector<std::optional<BuyResult>> reverse_order_buy_results(buy_order_count);
+	memory::vector<std::optional<SellResult>> in_order_sell_results(sell_order_count);
+	memory::vector<std::optional<SellResult>> reverse_order_sell_results(sell_order_count);
+
+	//what summing every order as a single block gives
+	fixed_point_t demand_sum = 0;
+	fixed_point_t supply_sum = 0;
+
+	const auto get_country_index = [](const std::size_t i) -> std::optional<country_index_t> {
+		if (i % 5 == 0) {
+			return std::nullopt;
+		}
+		return index_from_count<country_index_t>(i % country_count);
+	};
+
+	for (std::size_t i = 0; i < buy_order_count; ++i) {
+		const fixed_point_t max_quantity = 1 + fixed_point_t(static_cast<int32_t>(i % 7)) / 8;
+		const fixed_point_t money_to_spend = 20 * static_cast<int32_t>(1 + i % 3) + fixed_point_t(static_cast<int32_t>(i % 11)) / 3;
+		demand_sum += max_quantity;
+		const std::size_t order_buffer_index = i % GoodMarket::ORDER_BUFFER_COUNT;
+		in_order_market.add_buy_up_to_order(
+			order_buffer_index, { get_country_index(i), max_quantity, money_to_spend, &in_order_buy_results[i] }
+		);
+		reverse_order_market.add_buy_up_to_order(
+			order_buffer_index, { get_country_index(i), max_quantity, money_to_spend, &reverse_order_buy_results[i] }
+		);
+	}
+	for (std::size_t i = 0; i < sell_order_count; ++i) {
+		const fixed_point_t quantity = fixed_point_t(static_cast<int32_t>(1 + i % 4)) / 3;
+		supply_sum += quantity;
+		const std::size_t order_buffer_index = i % GoodMarket::ORDER_BUFFER_COUNT;
+		in_order_market.add_market_sell_order(
+			order_buffer_index, { get_country_index(i + 1), quantity, &in_order_sell_results[i] }
+		);
+		reverse_order_market.add_market_sell_order(
+			order_buffer_index, { get_country_index(i + 1), quantity, &reverse_order_sell_results[i] }
+		);
+	}
+
+	clear_market(in_order_market, country_count);
+	clear_market(reverse_order_market, country_count, true);
+
+	CHECK(in_order_market.get_total_demand_yesterday() == demand_sum);
+	CHECK(in_order_market.get_total_supply_yesterday() == supply_sum);
+	CHECK(reverse_order_market.get_total_demand_yesterday() == demand_sum);
+	CHECK(reverse_order_market.get_total_supply_yesterday() == supply_sum);
+	CHECK(reverse_order_market.get_price() == in_order_market.get_price());
+	CHECK(reverse_order_market.get_quantity_traded_yesterday() == in_order_market.get_quantity_traded_yesterday());
+	//demand is well above supply, so the blocks' purchasing powers are used to ration it
+	CHECK(in_order_market.get_quantity_traded_yesterday() > 0);
+
+	std::size_t mismatched_buy_results = 0;
+	for (std::size_t i = 0; i < buy_order_count; ++i) {
+		REQUIRE(in_order_buy_results[i].has_value());
+		REQUIRE(reverse_order_buy_results[i].has_value());
+		BuyResult const& in_order = *in_order_buy_results[i];
+		BuyResult const& reverse_order = *reverse_order_buy_results[i];
+		if (
+			in_order.quantity_bought != reverse_order.quantity_bought
+			|| in_order.money_spent_total != reverse_order.money_spent_total
+			|| in_order.money_spent_on_imports != reverse_order.money_spent_on_imports
+		) {
+			++mismatched_buy_results;
+		}
+	}
+	CHECK(mismatched_buy_results == 0);
+
+	std::size_t mismatched_sell_results = 0;
+	for (std::size_t i = 0; i < sell_order_count; ++i) {
+		REQUIRE(in_order_sell_results[i].has_value());
+		REQUIRE(reverse_order_sell_results[i].has_value());
+		SellResult const& in_order = *in_order_sell_results[i];
+		SellResult const& reverse_order = *reverse_order_sell_results[i];
+		if (in_order.quantity_sold != reverse_order.quantity_sold || in_order.money_gained != reverse_order.money_gained) {
+			++mismatched_sell_results;
+		}
+	}
+	CHECK(mismatched_sell_results == 0);
+}
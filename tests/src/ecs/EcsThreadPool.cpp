@@ -82,3 +82,72 @@ TEST_CASE("EcsThreadPool::parallel_for blocks until done", "[ecs][EcsThreadPool]
 	});
 	CHECK(counter.load() == 100 * 1000);
 }
+
+TEST_CASE("EcsThreadPool::parallel_for nested inside run_concurrent", "[ecs][EcsThreadPool]") {
+	for (uint32_t worker_count : { 1u, 2u, 4u, 8u }) {
+		EcsThreadPool pool { worker_count };
+		std::atomic<int> counter { 0 };
+		std::atomic<bool> worker_id_in_range { true };
+		std::vector<std::function<void()>> bodies;
+		for (int i = 0; i < 4; ++i) {
+			bodies.emplace_back([&]() {
+				pool.parallel_for(250, [&](std::size_t /*chunk_idx*/, uint32_t worker_id) {
+					if (worker_id >= worker_count) {
+						worker_id_in_range.store(false, std::memory_order_relaxed);
+					}
+					counter.fetch_add(1, std::memory_order_relaxed);
+				});
+			});
+		}
+		pool.run_concurrent(std::span<std::function<void()> const>(bodies.data(), bodies.size()));
+		CHECK(counter.load() == 4 * 250);
+		CHECK(worker_id_in_range.load());
+	}
+}
+
+TEST_CASE("EcsThreadPool::this_worker_id matches the worker running the body", "[ecs][EcsThreadPool]") {
+	EcsThreadPool pool { 4 };
+	std::atomic<int> mismatches { 0 };
+	pool.parallel_for(256, [&mismatches](std::size_t /*chunk_idx*/, uint32_t worker_id) {
+		if (EcsThreadPool::this_worker_id() != worker_id) {
+			mismatches.fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+	CHECK(mismatches.load() == 0);
+	CHECK(EcsThreadPool::this_worker_id() == 0);
+}
+
+TEST_CASE("EcsThreadPool knows when the calling thread is one of its workers", "[ecs][EcsThreadPool]") {
+	EcsThreadPool pool { 4 };
+	EcsThreadPool single_pool { 1 };
+	CHECK_FALSE(pool.is_calling_thread_worker());
+
+	std::atomic<int> outside_pool { 0 };
+	std::atomic<int> inside_other_pool { 0 };
+	auto check_body = [&](std::size_t /*chunk_idx*/, uint32_t worker_id) {
+		if (!pool.is_calling_thread_worker() || EcsThreadPool::this_worker_id() != worker_id) {
+			outside_pool.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (single_pool.is_calling_thread_worker()) {
+			inside_other_pool.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+	pool.parallel_for(256, check_body);
+	// Single chunk fast path.
+	pool.parallel_for(1, check_body);
+	CHECK(outside_pool.load() == 0);
+	CHECK(inside_other_pool.load() == 0);
+
+	// The single worker fast path, nested on a worker of another pool.
+	std::atomic<int> single_pool_mismatches { 0 };
+	pool.parallel_for(64, [&](std::size_t /*chunk_idx*/, uint32_t /*worker_id*/) {
+		single_pool.parallel_for(2, [&](std::size_t /*chunk_idx*/, uint32_t worker_id) {
+			if (!single_pool.is_calling_thread_worker() || EcsThreadPool::this_worker_id() != worker_id) {
+				single_pool_mismatches.fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+	});
+	CHECK(single_pool_mismatches.load() == 0);
+	CHECK_FALSE(pool.is_calling_thread_worker());
+	CHECK_FALSE(single_pool.is_calling_thread_worker());
+}
@@ -0,0 +1,69 @@
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/ecs/SystemImpl.hpp"
+#include "openvic-simulation/ecs/World.hpp"
+#include "openvic-simulation/types/Date.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic::ecs;
+using OpenVic::Date;
+
+// A World given a shared pool dispatches its systems on that pool's workers instead of
+// building its own.
+
+namespace {
+	struct StpValue {
+		int64_t v = 0;
+	};
+}
+ECS_COMPONENT(StpValue, "test_SharedThreadPool::Value")
+
+namespace {
+	EcsThreadPool const* expected_pool = nullptr;
+	std::atomic<int> rows_ticked { 0 };
+	std::atomic<int> rows_off_pool { 0 };
+
+	struct StpStep : SystemThreaded<StpStep> {
+		void tick(TickContext const& /*ctx*/, StpValue& value) {
+			++value.v;
+			rows_ticked.fetch_add(1, std::memory_order_relaxed);
+			if (expected_pool == nullptr || !expected_pool->is_calling_thread_worker()) {
+				rows_off_pool.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	};
+}
+ECS_SYSTEM(StpStep)
+
+TEST_CASE("World dispatches its systems on a shared pool", "[ecs][World][SharedThreadPool]") {
+	EcsThreadPool shared_pool { 4 };
+	expected_pool = &shared_pool;
+	rows_ticked.store(0);
+	rows_off_pool.store(0);
+
+	World world;
+	world.set_shared_thread_pool(&shared_pool);
+	CHECK(&world.ecs_thread_pool() == &shared_pool);
+
+	for (int i = 0; i < 2000; ++i) {
+		world.create_entity(StpValue { i });
+	}
+	world.register_system<StpStep>();
+	world.tick_systems(Date {});
+
+	CHECK(rows_ticked.load() == 2000);
+	CHECK(rows_off_pool.load() == 0);
+
+	// Dropping the shared pool goes back to a pool the World owns.
+	world.set_shared_thread_pool(nullptr);
+	CHECK(&world.ecs_thread_pool() != &shared_pool);
+	expected_pool = &world.ecs_thread_pool();
+	world.tick_systems(Date {});
+	CHECK(rows_ticked.load() == 4000);
+	CHECK(rows_off_pool.load() == 0);
+	expected_pool = nullptr;
+}
@@ -0,0 +1,104 @@
+#include "openvic-simulation/modifier/EventModifierExpiryQueue.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/modifier/ModifierValue.hpp"
+#include "openvic-simulation/types/Date.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	// Keeps its event modifiers like CountryInstance and ProvinceInstance do, matching on modifier and expiry date.
+	struct test_holder_t {
+		memory::vector<std::pair<Modifier const*, Date>> event_modifiers;
+
+		void add_event_modifier(Modifier const& modifier, const Date expiry_date) {
+			event_modifiers.emplace_back(&modifier, expiry_date);
+		}
+		bool expire_event_modifier(Modifier const& modifier, const Date expiry_date) {
+			const auto it = std::find(
+				event_modifiers.begin(), event_modifiers.end(), std::pair<Modifier const*, Date> { &modifier, expiry_date }
+			);
+			if (it == event_modifiers.end()) {
+				return false;
+			}
+			event_modifiers.erase(it);
+			return true;
+		}
+	};
+
+	using test_queue_t = BasicEventModifierExpiryQueue<test_holder_t>;
+
+	IconModifier make_event_modifier(std::string_view identifier) {
+		return { identifier, ModifierValue {}, Modifier::modifier_type_t::EVENT, 0 };
+	}
+}
+
+TEST_CASE("EventModifierExpiryQueue keeps modifiers active on their expiry date", "[EventModifierExpiryQueue]") {
+	const IconModifier modifier = make_event_modifier("test_event_modifier");
+	test_holder_t holder;
+	test_queue_t queue;
+
+	const Date expiry_date { 1836, 1, 10 };
+	queue.add_event_modifier(holder, modifier, expiry_date);
+	CHECK(holder.event_modifiers.size() == 1);
+
+	CHECK(queue.expire_event_modifiers(expiry_date) == 0);
+	CHECK(holder.event_modifiers.size() == 1);
+	CHECK(queue.size() == 1);
+
+	CHECK(queue.expire_event_modifiers(expiry_date + Timespan { 1 }) == 1);
+	CHECK(holder.event_modifiers.empty());
+	CHECK(queue.empty());
+}
+
+TEST_CASE("EventModifierExpiryQueue expires instances of the same modifier separately", "[EventModifierExpiryQueue]") {
+	const IconModifier modifier = make_event_modifier("test_event_modifier");
+	const IconModifier other_modifier = make_event_modifier("other_test_event_modifier");
+	test_holder_t holder;
+	test_queue_t queue;
+
+	const Date early_expiry_date { 1836, 1, 5 };
+	const Date late_expiry_date { 1836, 1, 20 };
+	// Added out of expiry order so the heap has to reorder them.
+	queue.add_event_modifier(holder, modifier, late_expiry_date);
+	queue.add_event_modifier(holder, other_modifier, late_expiry_date + Timespan { 10 });
+	queue.add_event_modifier(holder, modifier, early_expiry_date);
+
+	CHECK(queue.expire_event_modifiers(early_expiry_date + Timespan { 1 }) == 1);
+	REQUIRE(holder.event_modifiers.size() == 2);
+	CHECK(holder.event_modifiers[0].first == &modifier);
+	CHECK(holder.event_modifiers[0].second == late_expiry_date);
+	CHECK(holder.event_modifiers[1].first == &other_modifier);
+
+	CHECK(queue.expire_event_modifiers(late_expiry_date) == 0);
+	CHECK(queue.expire_event_modifiers(late_expiry_date + Timespan { 1 }) == 1);
+	REQUIRE(holder.event_modifiers.size() == 1);
+	CHECK(holder.event_modifiers[0].first == &other_modifier);
+	CHECK(queue.size() == 1);
+}
+
+TEST_CASE("EventModifierExpiryQueue clear forgets the previous game", "[EventModifierExpiryQueue]") {
+	const IconModifier modifier = make_event_modifier("test_event_modifier");
+	test_holder_t old_game_holder;
+	test_queue_t queue;
+
+	queue.add_event_modifier(old_game_holder, modifier, Date { 1836, 1, 5 });
+	queue.clear();
+	CHECK(queue.empty());
+
+	// Only modifiers added after clearing expire, the old holder is never touched again.
+	test_holder_t new_game_holder;
+	queue.add_event_modifier(new_game_holder, modifier, Date { 1836, 1, 10 });
+	CHECK(queue.expire_event_modifiers(Date { 1837, 1, 1 }) == 1);
+	CHECK(new_game_holder.event_modifiers.empty());
+	CHECK(old_game_holder.event_modifiers.size() == 1);
+	CHECK(queue.empty());
+}
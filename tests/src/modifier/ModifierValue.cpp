@@ -0,0 +1,98 @@
+#include "openvic-simulation/modifier/ModifierValue.hpp"
+
+#include "openvic-simulation/modifier/ModifierEffect.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	using enum ModifierEffect::format_t;
+	using enum ModifierEffect::target_t;
+
+	ModifierEffect make_effect(std::string_view identifier, uint32_t index, ModifierEffect::target_t targets) {
+		return { identifier, modifier_effect_index_t { index }, FORMAT_x1_2DP_POS, targets, {}, false };
+	}
+}
+
+TEST_CASE("ModifierValue sparse effect entries", "[ModifierValue]") {
+	const ModifierEffect country_effect = make_effect("country_effect", 0, COUNTRY);
+	const ModifierEffect province_effect = make_effect("province_effect", 1, PROVINCE);
+
+	ModifierValue value;
+	CHECK(value.add_new_effect(country_effect, 2));
+	CHECK_FALSE(value.add_new_effect(country_effect, 3));
+	CHECK(value.get_effect(country_effect) == 2);
+
+	value.set_effect(province_effect, 0);
+	CHECK(value.has_effect(province_effect));
+	value.trim();
+	CHECK_FALSE(value.has_effect(province_effect));
+	CHECK(value.get_effect_count() == 1);
+
+	value += value * 2;
+	CHECK(value.get_effect(country_effect) == 6);
+}
+
+TEST_CASE("DenseModifierValue matches sparse accumulation", "[ModifierValue]") {
+	const ModifierEffect country_effect = make_effect("country_effect", 0, COUNTRY);
+	const ModifierEffect province_effect = make_effect("province_effect", 1, PROVINCE);
+	const ModifierEffect unit_effect = make_effect("unit_effect", 5, UNIT);
+
+	ModifierValue first;
+	first.set_effect(country_effect, fixed_point_t::_0_50);
+	first.set_effect(unit_effect, 3);
+
+	ModifierValue second;
+	second.set_effect(province_effect, -1);
+	second.set_effect(country_effect, fixed_point_t::_0_25);
+
+	ModifierValue sparse_sum;
+	DenseModifierValue dense_sum;
+	sparse_sum.multiply_add_exclude_targets(first, 3, NO_TARGETS);
+	dense_sum.multiply_add_exclude_targets(first, 3, NO_TARGETS);
+	sparse_sum.multiply_add_exclude_targets(second, 1, COUNTRY);
+	dense_sum.multiply_add_exclude_targets(second, 1, COUNTRY);
+
+	for (ModifierEffect const* effect : { &country_effect, &province_effect, &unit_effect }) {
+		CHECK(dense_sum.get_effect(*effect) == sparse_sum.get_effect(*effect));
+	}
+	CHECK(dense_sum.get_effect(province_effect) == -1);
+
+	DenseModifierValue total;
+	total += dense_sum;
+	total += dense_sum;
+	CHECK(total.get_effect(unit_effect) == 18);
+
+	total.clear();
+	bool effect_found = true;
+	CHECK(total.get_effect(country_effect, &effect_found) == 0);
+	CHECK_FALSE(effect_found);
+}
+
+TEST_CASE("DenseModifierValue subtract undoes add exactly", "[ModifierValue]") {
+	const ModifierEffect country_effect = make_effect("country_effect", 0, COUNTRY);
+	const ModifierEffect province_effect = make_effect("province_effect", 2, PROVINCE);
+
+	ModifierValue value;
+	value.set_effect(country_effect, fixed_point_t::_1 / 3);
+	value.set_effect(province_effect, -fixed_point_t::_1 / 7);
+
+	DenseModifierValue base;
+	base.multiply_add_exclude_targets(value, 5, NO_TARGETS);
+	DenseModifierValue sum = base;
+
+	const fixed_point_t multiplier = fixed_point_t::_1 / 3;
+	sum.multiply_add_exclude_targets(value, multiplier, NO_TARGETS);
+	CHECK_FALSE(sum == base);
+	sum.multiply_subtract_exclude_targets(value, multiplier, NO_TARGETS);
+	CHECK(sum == base);
+
+	DenseModifierValue empty;
+	CHECK_FALSE(empty == base);
+	base.clear();
+	CHECK(empty == base);
+}
@@ -0,0 +1,174 @@
+#include "openvic-simulation/population/PopMovement.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <utility>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/portable/ForwardableSpan.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopIdInProvince.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/population/PopType.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "population/PopsFixture.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	struct pop_row_t {
+		std::size_t province_index;
+		pop_id_in_province_t id_in_province;
+		PopType const* type;
+		Culture const* culture;
+		Religion const* religion;
+		int64_t size;
+		int64_t num_promoted;
+		int64_t num_demoted;
+		int64_t num_migrated_internal;
+		int64_t num_migrated_colonial;
+		fixed_point_t cash;
+		fixed_point_t militancy;
+		fixed_point_t consciousness;
+		fixed_point_t literacy;
+
+		bool operator==(pop_row_t const&) const = default;
+	};
+
+	// Every pop of every province, in province order then pop order.
+	memory::vector<pop_row_t> get_pop_rows(forwardable_span<const ProvinceInstance> provinces) {
+		memory::vector<pop_row_t> pop_rows;
+		std::size_t province_index = 0;
+		for (ProvinceInstance const& province : provinces) {
+			for (Pop const& pop : province.get_pops()) {
+				pop_rows.push_back({
+					.province_index = province_index,
+					.id_in_province = pop.id_in_province,
+					.type = &pop.get_type(),
+					.culture = &pop.culture,
+					.religion = &pop.religion,
+					.size = type_safe::get(pop.get_size()),
+					.num_promoted = type_safe::get(pop.get_num_promoted()),
+					.num_demoted = type_safe::get(pop.get_num_demoted()),
+					.num_migrated_internal = type_safe::get(pop.get_num_migrated_internal()),
+					.num_migrated_colonial = type_safe::get(pop.get_num_migrated_colonial()),
+					.cash = pop.get_cash(),
+					.militancy = pop.get_militancy(),
+					.consciousness = pop.get_consciousness(),
+					.literacy = pop.get_literacy()
+				});
+			}
+			++province_index;
+		}
+		return pop_rows;
+	}
+
+	/* The fixture has no countries, so pops don't migrate, and its pops lack some of their life needs, so they demote.
+	 * Every type moves to each of the others with the same weight. */
+	void run_pop_movement(pops_fixture_t& fixture, ecs::EcsThreadPool& executor) {
+		PopMovement pop_movement {
+			fixture.pop_types,
+			[](PopType const&, PopType const&) -> fixed_point_t {
+				return fixed_point_t::_1;
+			},
+			fixed_point_t::_0_10,
+			fixed_point_t::_0_10,
+			fixture.pop_deps
+		};
+		pop_movement.pop_movement_tick(fixture.get_provinces(), std::span<CountryInstance> {}, executor);
+	}
+}
+
+TEST_CASE("PopMovement gives the same result with one worker or several", "[PopMovement]") {
+	// Both fixtures are built the same way, only the pop movement runs on a different number of workers.
+	pops_fixture_t serial_fixture { 8 };
+	pops_fixture_t parallel_fixture { 8 };
+	serial_fixture.add_test_pops();
+	parallel_fixture.add_test_pops();
+
+	const memory::vector<pop_row_t> pops_before = get_pop_rows(serial_fixture.get_provinces());
+	const bool fixtures_start_the_same = pops_before == get_pop_rows(parallel_fixture.get_provinces());
+	REQUIRE(fixtures_start_the_same);
+
+	ecs::EcsThreadPool serial_executor { 1 };
+	ecs::EcsThreadPool parallel_executor { 4 };
+	run_pop_movement(serial_fixture, serial_executor);
+	run_pop_movement(parallel_fixture, parallel_executor);
+
+	const memory::vector<pop_row_t> serial_pops_after = get_pop_rows(serial_fixture.get_provinces());
+	CHECK(serial_pops_after.size() > pops_before.size());
+	const bool parallel_matches_serial = serial_pops_after == get_pop_rows(parallel_fixture.get_provinces());
+	CHECK(parallel_matches_serial);
+}
+
+TEST_CASE("PopMovement keeps everyone and counts every move", "[PopMovement]") {
+	pops_fixture_t fixture { 8 };
+	fixture.add_test_pops();
+
+	std::map<std::pair<std::size_t, pop_id_in_province_t>, int64_t> sizes_before;
+	int64_t population_before = 0;
+	for (pop_row_t const& pop_row : get_pop_rows(fixture.get_provinces())) {
+		sizes_before.emplace(std::pair { pop_row.province_index, pop_row.id_in_province }, pop_row.size);
+		population_before += pop_row.size;
+	}
+
+	ecs::EcsThreadPool executor { 4 };
+	run_pop_movement(fixture, executor);
+
+	int64_t population_after = 0;
+	int64_t promoted_sum = 0, demoted_sum = 0, migrated_internal_sum = 0, migrated_colonial_sum = 0;
+	int64_t moved_count = 0;
+	std::size_t source_pops_emptied = 0;
+	std::size_t pops_with_uncounted_changes = 0;
+	for (pop_row_t const& pop_row : get_pop_rows(fixture.get_provinces())) {
+		population_after += pop_row.size;
+		promoted_sum += pop_row.num_promoted;
+		demoted_sum += pop_row.num_demoted;
+		migrated_internal_sum += pop_row.num_migrated_internal;
+		migrated_colonial_sum += pop_row.num_migrated_colonial;
+		if (pop_row.num_promoted > 0) {
+			moved_count += pop_row.num_promoted;
+		}
+		if (pop_row.num_demoted > 0) {
+			moved_count += pop_row.num_demoted;
+		}
+		if (pop_row.num_migrated_internal > 0) {
+			moved_count += pop_row.num_migrated_internal;
+		}
+		if (pop_row.num_migrated_colonial > 0) {
+			moved_count += pop_row.num_migrated_colonial;
+		}
+
+		// pops created by arrivals start empty
+		const auto it = sizes_before.find({ pop_row.province_index, pop_row.id_in_province });
+		const int64_t size_before = it == sizes_before.end() ? 0 : it->second;
+		if (size_before >= 1 && pop_row.size < 1) {
+			++source_pops_emptied;
+		}
+		if (
+			pop_row.size - size_before
+			!= pop_row.num_promoted + pop_row.num_demoted + pop_row.num_migrated_internal + pop_row.num_migrated_colonial
+		) {
+			++pops_with_uncounted_changes;
+		}
+	}
+
+	CHECK(moved_count > 0);
+	CHECK(population_after == population_before);
+	CHECK(source_pops_emptied == 0);
+	CHECK(pops_with_uncounted_changes == 0);
+	// every move is counted once against its source and once for its destination
+	CHECK(promoted_sum == 0);
+	CHECK(demoted_sum == 0);
+	CHECK(migrated_internal_sum == 0);
+	CHECK(migrated_colonial_sum == 0);
+}
@@ -0,0 +1,66 @@
+#include "openvic-simulation/population/PopStore.hpp"
+
+#include <cstddef>
+
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopType.hpp"
+
+#include "population/PopsFixture.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	bool does_row_mirror_pop(PopStore const& pop_store, const std::size_t row, Pop const& pop) {
+		PopType const& pop_type = pop.get_type();
+		return pop_store.get_pops()[row] == &pop
+			&& pop_store.get_type_indices()[row] == pop_type.index
+			&& pop_store.get_strata_indices()[row] == pop_type.strata.index
+			&& pop_store.get_culture_indices()[row] == pop.culture.index
+			&& pop_store.get_religion_indices()[row] == pop.religion.index
+			&& pop_store.get_sizes()[row] == pop.get_size()
+			&& pop_store.get_unemployed()[row] == pop.get_unemployed()
+			&& pop_store.get_literacy()[row] == pop.get_literacy()
+			&& pop_store.get_consciousness()[row] == pop.get_consciousness()
+			&& pop_store.get_militancy()[row] == pop.get_militancy()
+			&& pop_store.get_yesterdays_import_value()[row] == pop.get_yesterdays_import_value()
+			&& pop_store.get_life_needs_fulfilled()[row] == pop.get_life_needs_fulfilled()
+			&& pop_store.get_everyday_needs_fulfilled()[row] == pop.get_everyday_needs_fulfilled()
+			&& pop_store.get_luxury_needs_fulfilled()[row] == pop.get_luxury_needs_fulfilled()
+			&& pop_store.get_recruitable_regiments()[row] == (pop_type.can_be_recruited ? pop.get_max_supported_regiments() : 0);
+	}
+}
+
+TEST_CASE("PopStore rows mirror the pops pushed into them", "[PopStore]") {
+	pops_fixture_t fixture { 4 };
+	fixture.add_test_pops();
+
+	PopStore pop_store;
+	std::size_t pops_checked = 0;
+	std::size_t mismatched_rows = 0;
+	for (ProvinceInstance& province : fixture.get_provinces()) {
+		// Stores are refilled in place every update, so the rows of the previous province mustn't linger.
+		pop_store.clear();
+		CHECK(pop_store.empty());
+		pop_store.reserve(province.get_pops().size());
+		for (Pop& pop : province.get_mutable_pops()) {
+			pop_store.push_back(pop);
+		}
+		CHECK(pop_store.size() == province.get_pops().size());
+
+		std::size_t row = 0;
+		for (Pop const& pop : province.get_pops()) {
+			if (!does_row_mirror_pop(pop_store, row, pop)) {
+				++mismatched_rows;
+			}
+			++row;
+		}
+		pops_checked += row;
+	}
+
+	CHECK(pops_checked == fixture.get_provinces().size() * fixture.pop_types.size());
+	CHECK(mismatched_rows == 0);
+}
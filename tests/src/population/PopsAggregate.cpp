@@ -0,0 +1,191 @@
+#include "openvic-simulation/population/PopsAggregate.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopsAggregateDeps.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/population/PopStore.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include "population/PopsFixture.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	struct test_aggregate_t : PopsAggregate {
+		explicit test_aggregate_t(PopsAggregateDeps const& deps) : PopsAggregate { deps } {}
+
+		using PopsAggregate::update_parties_for_votes;
+		using PopsAggregate::update_pops_aggregate;
+		using PopsAggregate::update_pops_aggregate_from_parts;
+	};
+
+	// The rows of every pop of the province, in pop order.
+	PopStore make_pop_store(ProvinceInstance& province) {
+		PopStore pop_store;
+		pop_store.reserve(province.get_pops().size());
+		for (Pop& pop : province.get_mutable_pops()) {
+			pop_store.push_back(pop);
+		}
+		return pop_store;
+	}
+
+	// PopStore has no setters, the columns of a copy are edited in place to change rows without running a tick.
+	template<typename T>
+	void set_column_value(std::span<const T> column, const std::size_t row, const std::type_identity_t<T> value) {
+		const_cast<T&>(column[row]) = value;
+	}
+
+	// Changes every column that isn't part of the row's identity, so pops, types, cultures and religions stay the same.
+	void change_row(PopStore& pop_store, const std::size_t row) {
+		set_column_value(pop_store.get_sizes(), row, pop_store.get_sizes()[row] + pop_size_t { 50 });
+		set_column_value(pop_store.get_unemployed(), row, pop_size_t { type_safe::get(pop_store.get_sizes()[row]) / 2 });
+		set_column_value(pop_store.get_literacy(), row, pop_store.get_literacy()[row] / 2 + fixed_point_t::_0_25);
+		set_column_value(pop_store.get_consciousness(), row, pop_store.get_consciousness()[row] + 1);
+		set_column_value(pop_store.get_militancy(), row, pop_store.get_militancy()[row] + 2);
+		set_column_value(pop_store.get_yesterdays_import_value(), row, pop_store.get_yesterdays_import_value()[row] + 3);
+		set_column_value(pop_store.get_life_needs_fulfilled(), row, fixed_point_t::_1 - pop_store.get_life_needs_fulfilled()[row]);
+		set_column_value(
+			pop_store.get_everyday_needs_fulfilled(), row, fixed_point_t::_1 - pop_store.get_everyday_needs_fulfilled()[row]
+		);
+		set_column_value(
+			pop_store.get_luxury_needs_fulfilled(), row, fixed_point_t::_1 - pop_store.get_luxury_needs_fulfilled()[row]
+		);
+		set_column_value(pop_store.get_recruitable_regiments(), row, pop_store.get_recruitable_regiments()[row] + 1);
+	}
+
+	bool are_aggregates_equal(PopsAggregate& lhs, PopsAggregate& rhs) {
+		return lhs.get_total_population() == rhs.get_total_population()
+			&& lhs.get_max_supported_regiment_count() == rhs.get_max_supported_regiment_count()
+			&& lhs.get_yesterdays_import_value_untracked() == rhs.get_yesterdays_import_value_untracked()
+			&& lhs.get_average_literacy() == rhs.get_average_literacy()
+			&& lhs.get_average_consciousness() == rhs.get_average_consciousness()
+			&& lhs.get_average_militancy() == rhs.get_average_militancy()
+			&& std::ranges::equal(lhs.get_militancy_by_strata(), rhs.get_militancy_by_strata())
+			&& std::ranges::equal(lhs.get_life_needs_fulfilled_by_strata(), rhs.get_life_needs_fulfilled_by_strata())
+			&& std::ranges::equal(lhs.get_everyday_needs_fulfilled_by_strata(), rhs.get_everyday_needs_fulfilled_by_strata())
+			&& std::ranges::equal(lhs.get_luxury_needs_fulfilled_by_strata(), rhs.get_luxury_needs_fulfilled_by_strata())
+			&& std::ranges::equal(lhs.get_population_by_strata(), rhs.get_population_by_strata())
+			&& std::ranges::equal(lhs.get_population_by_type(), rhs.get_population_by_type())
+			&& std::ranges::equal(lhs.get_unemployed_pops_by_type(), rhs.get_unemployed_pops_by_type())
+			&& std::ranges::equal(lhs.get_supporter_equivalents_by_ideology(), rhs.get_supporter_equivalents_by_ideology())
+			&& std::ranges::equal(
+				lhs.get_supporter_equivalents_by_party_policy(), rhs.get_supporter_equivalents_by_party_policy()
+			)
+			&& std::ranges::equal(lhs.get_supporter_equivalents_by_reform(), rhs.get_supporter_equivalents_by_reform())
+			&& std::ranges::equal(lhs.get_population_by_culture(), rhs.get_population_by_culture())
+			&& std::ranges::equal(lhs.get_population_by_religion(), rhs.get_population_by_religion());
+	}
+}
+
+TEST_CASE("PopsAggregate delta update matches a full rebuild", "[PopsAggregate]") {
+	pops_fixture_t fixture { 4 };
+	fixture.add_test_pops();
+	const PopStore no_pops;
+
+	std::size_t provinces_checked = 0;
+	std::size_t mismatched_provinces = 0;
+	for (ProvinceInstance& province : fixture.get_provinces()) {
+		const PopStore previous_pop_store = make_pop_store(province);
+
+		// Rows keep their pops, so the update subtracts and re-adds the changed ones instead of rebuilding.
+		PopStore pop_store = previous_pop_store;
+		for (std::size_t row = 0; row < pop_store.size(); row += 2) {
+			change_row(pop_store, row);
+		}
+
+		test_aggregate_t delta_aggregate { fixture.pops_aggregate_deps };
+		delta_aggregate.update_pops_aggregate(previous_pop_store, no_pops);
+		CHECK(delta_aggregate.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::REBUILD);
+		delta_aggregate.update_pops_aggregate(pop_store, previous_pop_store);
+		CHECK(delta_aggregate.get_pops_aggregate_changed());
+		CHECK(delta_aggregate.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::DELTA);
+
+		test_aggregate_t rebuilt_aggregate { fixture.pops_aggregate_deps };
+		rebuilt_aggregate.update_pops_aggregate(pop_store, no_pops);
+
+		if (!are_aggregates_equal(delta_aggregate, rebuilt_aggregate)) {
+			++mismatched_provinces;
+		}
+		++provinces_checked;
+	}
+
+	CHECK(provinces_checked == fixture.get_provinces().size());
+	CHECK(mismatched_provinces == 0);
+}
+
+TEST_CASE("PopsAggregate parents take changed parts as deltas", "[PopsAggregate]") {
+	pops_fixture_t fixture { 4 };
+	fixture.add_test_pops();
+	const PopStore no_pops;
+
+	memory::vector<PopStore> pop_stores;
+	for (ProvinceInstance& province : fixture.get_provinces()) {
+		pop_stores.push_back(make_pop_store(province));
+	}
+	// Parts stay in place once added, as the provinces of a State and the states of a CountryInstance do.
+	memory::vector<std::unique_ptr<test_aggregate_t>> parts;
+	for (PopStore const& pop_store : pop_stores) {
+		parts.push_back(std::make_unique<test_aggregate_t>(fixture.pops_aggregate_deps));
+		parts.back()->update_pops_aggregate(pop_store, no_pops);
+	}
+	const auto get_part = [](std::unique_ptr<test_aggregate_t> const& part) -> PopsAggregate& {
+		return *part;
+	};
+
+	test_aggregate_t parent { fixture.pops_aggregate_deps };
+	CHECK(parent.update_pops_aggregate_from_parts(parts, get_part));
+	CHECK(parent.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::REBUILD);
+
+	for (std::size_t part_index = 0; part_index < parts.size(); ++part_index) {
+		parts[part_index]->update_pops_aggregate(pop_stores[part_index], pop_stores[part_index]);
+	}
+	CHECK_FALSE(parent.update_pops_aggregate_from_parts(parts, get_part));
+	CHECK(parent.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::UNCHANGED);
+
+	// Only the first and last parts change, the others keep the contributions the parent already has.
+	for (const std::size_t part_index : { std::size_t { 0 }, parts.size() - 1 }) {
+		PopStore pop_store = pop_stores[part_index];
+		change_row(pop_store, 0);
+		parts[part_index]->update_pops_aggregate(pop_store, pop_stores[part_index]);
+		pop_stores[part_index] = pop_store;
+	}
+	CHECK(parent.update_pops_aggregate_from_parts(parts, get_part));
+	CHECK(parent.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::DELTA);
+
+	test_aggregate_t rebuilt_parent { fixture.pops_aggregate_deps };
+	rebuilt_parent.update_pops_aggregate_from_parts(parts, get_part);
+	CHECK(rebuilt_parent.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::REBUILD);
+	CHECK(are_aggregates_equal(parent, rebuilt_parent));
+}
+
+TEST_CASE("PopsAggregate rebuilds after its parties change", "[PopsAggregate]") {
+	pops_fixture_t fixture { 1 };
+	fixture.add_test_pops();
+	const PopStore pop_store = make_pop_store(fixture.get_provinces().front());
+
+	test_aggregate_t aggregate { fixture.pops_aggregate_deps };
+	aggregate.update_pops_aggregate(pop_store, PopStore {});
+	aggregate.update_pops_aggregate(pop_store, pop_store);
+	CHECK_FALSE(aggregate.get_pops_aggregate_changed());
+	CHECK(aggregate.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::UNCHANGED);
+
+	// Clearing the party list must make the next update rebuild, even though no row changed.
+	aggregate.update_parties_for_votes(static_cast<CountryDefinition const*>(nullptr));
+	aggregate.update_pops_aggregate(pop_store, pop_store);
+	CHECK(aggregate.get_pops_aggregate_changed());
+	CHECK(aggregate.get_last_pops_aggregate_update() == PopsAggregate::update_kind_t::REBUILD);
+	CHECK(aggregate.get_vote_equivalents_by_party().empty());
+}
@@ -0,0 +1,82 @@
+#include "openvic-simulation/population/PopsByType.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/portable/ForwardableSpan.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+#include "population/PopsFixture.hpp"
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+using namespace OpenVic::testing;
+
+namespace {
+	// The pops of one type in the order a plain loop over the provinces and their pops visits them.
+	memory::vector<Pop const*> get_pops_of_type(
+		forwardable_span<const ProvinceInstance> provinces, const pop_type_index_t pop_type_index
+	) {
+		memory::vector<Pop const*> pops_of_type;
+		for (ProvinceInstance const& province : provinces) {
+			for (Pop const& pop : province.get_pops()) {
+				if (pop.get_type().index == pop_type_index) {
+					pops_of_type.push_back(&pop);
+				}
+			}
+		}
+		return pops_of_type;
+	}
+
+	/* The fixture adds pops in type order, so every province also gets pops of the richest types first
+	 * and a second pop of the poorest type, leaving several pops of a type apart from each other. */
+	void add_unordered_pops(pops_fixture_t& fixture) {
+		for (ProvinceInstance& province : fixture.get_provinces()) {
+			for (std::size_t type_index = fixture.pop_types.size(); type_index-- > 0;) {
+				fixture.add_pop(province, type_index, 0, 0, 500);
+			}
+			fixture.add_pop(province, 0, 1, 1, 250);
+		}
+	}
+}
+
+TEST_CASE("PopsByType keeps province and pop order within each type", "[PopsByType]") {
+	pops_fixture_t fixture { 4 };
+	fixture.add_test_pops();
+	add_unordered_pops(fixture);
+
+	memory::vector<PopsByType> province_pops_by_type;
+	province_pops_by_type.reserve(fixture.provinces.size());
+	std::size_t misordered_province_types = 0;
+	for (ProvinceInstance& province : fixture.get_provinces()) {
+		PopsByType& pops_by_type = province_pops_by_type.emplace_back(index_from_count<pop_type_index_t>(fixture.pop_types.size()));
+		pops_by_type.rebuild(province.get_mutable_pops());
+		CHECK(pops_by_type.get_pop_count() == province.get_pops().size());
+
+		for (pop_type_index_t pop_type_index { 0 }; pop_type_index < pops_by_type.size(); ++pop_type_index) {
+			if (!std::ranges::equal(pops_by_type[pop_type_index], get_pops_of_type({ &province, 1 }, pop_type_index))) {
+				++misordered_province_types;
+			}
+		}
+	}
+	CHECK(misordered_province_types == 0);
+
+	// Parts are merged the way states merge their provinces.
+	PopsByType merged_pops_by_type { index_from_count<pop_type_index_t>(fixture.pop_types.size()) };
+	merged_pops_by_type.rebuild_from_parts(
+		province_pops_by_type, [](PopsByType const& part) -> PopsByType const& { return part; }
+	);
+	CHECK(merged_pops_by_type.get_pop_count() == fixture.provinces.size() * (2 * fixture.pop_types.size() + 1));
+
+	std::size_t misordered_merged_types = 0;
+	for (pop_type_index_t pop_type_index { 0 }; pop_type_index < merged_pops_by_type.size(); ++pop_type_index) {
+		if (!std::ranges::equal(merged_pops_by_type[pop_type_index], get_pops_of_type(fixture.get_provinces(), pop_type_index))) {
+			++misordered_merged_types;
+		}
+	}
+	CHECK(misordered_merged_types == 0);
+}
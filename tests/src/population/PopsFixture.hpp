@@ -0,0 +1,234 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+#include <tuple>
+
+#include "openvic-simulation/core/memory/Formatting.hpp"
+#include "openvic-simulation/core/memory/Vector.hpp"
+#include "openvic-simulation/core/stl/containers/TypedSpan.hpp"
+#include "openvic-simulation/dataloader/NodeTools.hpp"
+#include "openvic-simulation/defines/CountryDefines.hpp"
+#include "openvic-simulation/defines/EconomyDefines.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+#include "openvic-simulation/economy/BuildingType.hpp"
+#include "openvic-simulation/economy/GoodDefinition.hpp"
+#include "openvic-simulation/economy/GoodInstance.hpp"
+#include "openvic-simulation/economy/production/ArtisanalProducerDeps.hpp"
+#include "openvic-simulation/economy/production/ResourceGatheringOperationDeps.hpp"
+#include "openvic-simulation/economy/trading/MarketInstance.hpp"
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/map/ProvinceInstanceDeps.hpp"
+#include "openvic-simulation/misc/GameRulesManager.hpp"
+#include "openvic-simulation/modifier/ModifierEffectCache.hpp"
+#include "openvic-simulation/politics/Reform.hpp"
+#include "openvic-simulation/population/Culture.hpp"
+#include "openvic-simulation/population/Pop.hpp"
+#include "openvic-simulation/population/PopDeps.hpp"
+#include "openvic-simulation/population/PopsAggregateDeps.hpp"
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/population/PopType.hpp"
+#include "openvic-simulation/population/Religion.hpp"
+#include "openvic-simulation/types/Colour.hpp"
+#include "openvic-simulation/types/ConstructorTags.hpp"
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/IndexedFlatMap.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+
+namespace OpenVic::testing {
+	/* Hand-built definitions and land provinces for the pop tests, so they run without a game install.
+	 * There are no goods, buildings or countries, one pop type per strata from poorest to richest,
+	 * and the same number of cultures and religions as strata. */
+	struct pops_fixture_t {
+	private:
+		// PopBase is only built by the loaders, pops added by the fixture start from one of these.
+		struct fixture_pop_base_t : PopBase {
+			fixture_pop_base_t(
+				PopType const& new_type, Culture const& new_culture, Religion const& new_religion, const pop_size_t new_size
+			) : PopBase { new_type, new_culture, new_religion, new_size, fixed_point_t::_1, fixed_point_t::_2, nullptr } {}
+		};
+
+		static constexpr std::size_t STRATA_COUNT = 3;
+		static constexpr std::string_view STRATA_IDENTIFIERS[STRATA_COUNT] { "poor", "middle", "rich" };
+		static constexpr std::string_view POP_TYPE_IDENTIFIERS[STRATA_COUNT] { "labourers", "clerks", "capitalists" };
+		static constexpr std::string_view CULTURE_IDENTIFIERS[STRATA_COUNT] { "north", "south", "east" };
+		static constexpr std::string_view RELIGION_IDENTIFIERS[STRATA_COUNT] { "sun", "moon", "star" };
+
+		static GoodDefinitionManager const& lock_goods(GoodDefinitionManager& new_good_definition_manager) {
+			new_good_definition_manager.lock_good_definitions();
+			return new_good_definition_manager;
+		}
+
+		static memory::vector<Strata> make_stratas() {
+			memory::vector<Strata> new_stratas;
+			new_stratas.reserve(STRATA_COUNT);
+			for (std::size_t i = 0; i < STRATA_COUNT; ++i) {
+				new_stratas.emplace_back(STRATA_IDENTIFIERS[i], index_from_count<strata_index_t>(i));
+			}
+			return new_stratas;
+		}
+
+		// Only the poorest type can be unemployed and only the richest can be recruited.
+		static memory::vector<PopType> make_pop_types(memory::vector<Strata> const& new_stratas) {
+			memory::vector<PopType> new_pop_types;
+			new_pop_types.reserve(STRATA_COUNT);
+			for (std::size_t i = 0; i < STRATA_COUNT; ++i) {
+				new_pop_types.emplace_back(
+					POP_TYPE_IDENTIFIERS[i], colour_t::null(), index_from_count<pop_type_index_t>(i), new_stratas[i], 1,
+					fixed_point_map_t<good_index_t> {}, fixed_point_map_t<good_index_t> {}, fixed_point_map_t<good_index_t> {},
+					PopType::income_type_t::NO_INCOME_TYPE, PopType::income_type_t::NO_INCOME_TYPE,
+					PopType::income_type_t::NO_INCOME_TYPE,
+					PopType::rebel_units_t {}, pop_size_t { 1000000 }, pop_size_t { 1000000 },
+					false, false, false, true, false,
+					i + 1 == STRATA_COUNT, false, false, false, false, false, i == 0,
+					0, 0, 0, 0, nullptr,
+					ConditionalWeightFactorMul {}, ConditionalWeightFactorMul {},
+					PopType::poptype_weight_map_t { create_empty }, PopType::ideology_weight_map_t { create_empty },
+					PopType::issue_weight_map_t {}
+				);
+			}
+			return new_pop_types;
+		}
+
+		memory::vector<Culture> make_cultures() const {
+			memory::vector<Culture> new_cultures;
+			new_cultures.reserve(STRATA_COUNT);
+			for (std::size_t i = 0; i < STRATA_COUNT; ++i) {
+				new_cultures.emplace_back(
+					CULTURE_IDENTIFIERS[i], index_from_count<culture_index_t>(i), colour_t::null(), culture_group, name_list_t {},
+					name_list_t {}, 0, nullptr
+				);
+			}
+			return new_cultures;
+		}
+
+		memory::vector<Religion> make_religions() const {
+			memory::vector<Religion> new_religions;
+			new_religions.reserve(STRATA_COUNT);
+			for (std::size_t i = 0; i < STRATA_COUNT; ++i) {
+				new_religions.emplace_back(
+					RELIGION_IDENTIFIERS[i], index_from_count<religion_index_t>(i), colour_t::null(), religion_group, 1, false
+				);
+			}
+			return new_religions;
+		}
+
+		static memory::vector<ProvinceDefinition> make_province_definitions(const std::size_t province_count) {
+			memory::vector<ProvinceDefinition> new_province_definitions;
+			new_province_definitions.reserve(province_count);
+			for (std::size_t i = 0; i < province_count; ++i) {
+				new_province_definitions.emplace_back(
+					memory::fmt::format("province_{}", i), colour_t::from_integer(0x010000 + i),
+					index_from_count<province_index_t>(i)
+				);
+			}
+			return new_province_definitions;
+		}
+
+	public:
+		GameRulesManager game_rules_manager;
+		BuildingTypeManager building_type_manager;
+		ModifierEffectCache modifier_effect_cache;
+		GoodDefinitionManager good_definition_manager;
+		GoodInstanceManager good_instance_manager;
+		ecs::EcsThreadPool executor;
+		Date today;
+		ThreadPool thread_pool;
+		CountryDefines country_defines;
+		EconomyDefines economy_defines;
+		MarketInstance market_instance;
+
+		memory::vector<Strata> stratas;
+		memory::vector<PopType> pop_types;
+		GraphicalCultureType graphical_culture_type;
+		CultureGroup culture_group;
+		memory::vector<Culture> cultures;
+		ReligionGroup religion_group;
+		memory::vector<Religion> religions;
+
+		// Pops support 4 ideologies, 5 party policies and 2 reforms, with no definitions behind those indices.
+		PopsAggregateDeps pops_aggregate_deps;
+		ArtisanalProducerDeps artisanal_producer_deps;
+		PopDeps pop_deps;
+		ResourceGatheringOperationDeps rgo_deps;
+		ProvinceInstanceDeps province_instance_deps;
+
+		memory::vector<ProvinceDefinition> province_definitions;
+		IndexedFlatMap<ProvinceDefinition, ProvinceInstance> provinces;
+
+		explicit pops_fixture_t(const std::size_t province_count)
+		  : good_instance_manager { lock_goods(good_definition_manager), game_rules_manager },
+			executor { 1 },
+			thread_pool { executor, today },
+			market_instance { thread_pool, country_defines, good_instance_manager },
+			stratas { make_stratas() },
+			pop_types { make_pop_types(stratas) },
+			graphical_culture_type { "fixture_graphics", graphical_culture_index_t { 0 } },
+			culture_group { "fixture_cultures", "", graphical_culture_type, false, nullptr },
+			cultures { make_cultures() },
+			religion_group { "fixture_religions" },
+			religions { make_religions() },
+			pops_aggregate_deps {
+				.culture_count = culture_index_t { STRATA_COUNT },
+				.ideology_count = ideology_index_t { 4 },
+				.party_policy_count = party_policy_index_t { 5 },
+				.pop_type_count = pop_type_index_t { STRATA_COUNT },
+				.reform_count = reform_index_t { 2 },
+				.religion_count = religion_index_t { STRATA_COUNT },
+				.strata_count = strata_index_t { STRATA_COUNT }
+			},
+			artisanal_producer_deps { economy_defines, {}, modifier_effect_cache },
+			pop_deps { artisanal_producer_deps, market_instance, pops_aggregate_deps },
+			rgo_deps { market_instance, modifier_effect_cache, pop_type_index_t { STRATA_COUNT } },
+			province_instance_deps { building_type_manager, game_rules_manager, pops_aggregate_deps, rgo_deps, stratas },
+			province_definitions { make_province_definitions(province_count) },
+			provinces {
+				forwardable_span<const ProvinceDefinition> { province_definitions },
+				[this](ProvinceDefinition const& province_definition) -> auto {
+					return std::make_tuple(std::ref(province_definition), std::ref(province_instance_deps));
+				}
+			} {}
+
+		pops_fixture_t(pops_fixture_t const&) = delete;
+		pops_fixture_t& operator=(pops_fixture_t const&) = delete;
+
+		constexpr forwardable_span<ProvinceInstance> get_provinces() {
+			return provinces.get_values();
+		}
+
+		Pop& add_pop(
+			ProvinceInstance& province, const std::size_t type_index, const std::size_t culture_index,
+			const std::size_t religion_index, const int32_t size
+		) {
+			return *province.add_pop(
+				fixture_pop_base_t { pop_types[type_index], cultures[culture_index], religions[religion_index], pop_size_t { size } },
+				pop_deps
+			);
+		}
+
+		/* Every province gets one pop of each type, with cultures and religions rotating across provinces and types
+		 * and sizes differing between all pops. Supporters, cash and the other test values come from rand(),
+		 * seeded here so fixtures of the same size get the same pops. */
+		void add_test_pops() {
+			std::srand(0);
+			const TypedSpan<reform_index_t, const Reform> no_reforms { static_cast<Reform const*>(nullptr), 0 };
+			std::size_t province_index = 0;
+			for (ProvinceInstance& province : get_provinces()) {
+				for (std::size_t type_index = 0; type_index < STRATA_COUNT; ++type_index) {
+					add_pop(
+						province, type_index, (province_index + type_index) % STRATA_COUNT, province_index % STRATA_COUNT,
+						static_cast<int32_t>(1000 + 97 * province_index + 331 * type_index)
+					);
+				}
+				province.setup_pop_test_values(no_reforms);
+				++province_index;
+			}
+		}
+	};
+}
@@ -0,0 +1,66 @@
+#include "openvic-simulation/population/SparseSupportVector.hpp"
+
+#include <array>
+
+#include "openvic-simulation/population/PopSize.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/TypedIndices.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("SparseSupportVector only stores non-zero entries", "[SparseSupportVector]") {
+	SparseSupportVector<ideology_index_t> supporters;
+	supporters.set(ideology_index_t { 4 }, 3);
+	supporters.set(ideology_index_t { 1 }, 2);
+	supporters.set(ideology_index_t { 7 }, 0);
+	CHECK(supporters.size() == 2);
+	CHECK(supporters.get_indices()[0] == ideology_index_t { 1 });
+	CHECK(supporters.get(ideology_index_t { 4 }) == 3);
+	CHECK(supporters.get(ideology_index_t { 7 }) == 0);
+
+	supporters.add(ideology_index_t { 1 }, -2);
+	CHECK(supporters.size() == 1);
+	CHECK(supporters.get_total() == 3);
+
+	const std::array<fixed_point_t, 4> dense { 0, 5, 0, 1 };
+	supporters.assign_dense(dense);
+	CHECK(supporters.size() == 2);
+	CHECK(supporters.get(ideology_index_t { 3 }) == 1);
+}
+
+TEST_CASE("SparseSupportVector matches dense accumulation", "[SparseSupportVector]") {
+	SparseSupportVector<reform_index_t> supporters;
+	supporters.set(reform_index_t { 0 }, 6);
+	supporters.set(reform_index_t { 2 }, 2);
+
+	std::array<fixed_point_t, 3> total { 1, 1, 1 };
+	supporters.add_to_dense(total);
+	CHECK(total[0] == 7);
+	CHECK(total[1] == 1);
+	CHECK(total[2] == 3);
+
+	supporters.rescale(fixed_point_t { 4 }, supporters.get_total());
+	CHECK(supporters.get(reform_index_t { 0 }) == 3);
+	CHECK(supporters.get(reform_index_t { 2 }) == 1);
+}
+
+TEST_CASE("SparseSupportVector take_share", "[SparseSupportVector]") {
+	SparseSupportVector<party_policy_index_t> supporters;
+	supporters.set(party_policy_index_t { 2 }, 10);
+	supporters.set(party_policy_index_t { 5 }, 4);
+
+	fixed_point_t taken_total = 0;
+	supporters.take_share(
+		pop_size_t { 1 }, pop_size_t { 2 },
+		[&taken_total](const party_policy_index_t index, const fixed_point_t share) -> void {
+			CHECK((index == party_policy_index_t { 2 } || index == party_policy_index_t { 5 }));
+			taken_total += share;
+		}
+	);
+	CHECK(taken_total == 7);
+	CHECK(supporters.get(party_policy_index_t { 2 }) == 5);
+	CHECK(supporters.get(party_policy_index_t { 5 }) == 2);
+}
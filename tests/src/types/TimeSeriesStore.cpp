@@ -0,0 +1,110 @@
+#include "openvic-simulation/types/TimeSeriesStore.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+namespace {
+	// Series 0 steps by a quarter each sample, series 1 jumps by more than a 32 bit delta can hold every 10 samples.
+	fixed_point_t series_value(const std::size_t series_index, const std::size_t sample_index) {
+		if (series_index == 0) {
+			return fixed_point_t(static_cast<int32_t>(sample_index)) / 4;
+		}
+		return fixed_point_t(static_cast<int32_t>(sample_index / 10 % 2 == 0 ? 1'000'000 : -1'000'000)) + static_cast<int32_t>(sample_index);
+	}
+
+	void push_samples(TimeSeriesStore& store, Date& date, const std::size_t count) {
+		for (std::size_t i = 0; i < count; ++i) {
+			const std::size_t sample_index = store.get_sample_count();
+			const std::array<fixed_point_t, 2> values { series_value(0, sample_index), series_value(1, sample_index) };
+			store.push_sample(date++, values);
+		}
+	}
+}
+
+TEST_CASE("TimeSeriesStore reads back exact values", "[TimeSeriesStore]") {
+	TimeSeriesStore store { 2, 100 };
+	Date date { 1836, 1, 1 };
+	push_samples(store, date, 70);
+
+	std::array<fixed_point_t, 70> values {};
+	for (std::size_t series_index = 0; series_index < 2; ++series_index) {
+		REQUIRE(store.read(series_index, 0, 70, values) == 70);
+		for (std::size_t i = 0; i < values.size(); ++i) {
+			CHECK(values[i] == series_value(series_index, i));
+		}
+	}
+
+	// Ranges starting between keyframes and clamped by the output size
+	std::array<fixed_point_t, 5> window {};
+	CHECK(store.read(0, 37, 70, window) == 5);
+	CHECK(window[0] == series_value(0, 37));
+	CHECK(window[4] == series_value(0, 41));
+	CHECK(store.read(1, 65, 200, window) == 5);
+	CHECK(window[4] == series_value(1, 69));
+}
+
+TEST_CASE("TimeSeriesStore keeps only the retention", "[TimeSeriesStore]") {
+	TimeSeriesStore store { 2, 50 };
+	Date date { 1836, 1, 1 };
+	push_samples(store, date, 175);
+
+	CHECK(store.get_sample_count() == 175);
+	CHECK(store.get_first_sample() == 125);
+	CHECK(store.get_oldest_sample(0) == 125);
+	CHECK(store.get_sample_date(125) == Date { 1836, 1, 1 } + Timespan { 125 });
+
+	std::array<fixed_point_t, 50> values {};
+	REQUIRE(store.read(0, 0, 175, values) == 50);
+	CHECK(values[0] == series_value(0, 125));
+	CHECK(values[49] == series_value(0, 174));
+
+	CHECK(store.get_oldest_sample(1) == 125);
+	REQUIRE(store.read(1, 0, 175, values) == 50);
+	CHECK(values[0] == series_value(1, 125));
+	CHECK(values[49] == series_value(1, 174));
+}
+
+TEST_CASE("TimeSeriesStore finds samples by date", "[TimeSeriesStore]") {
+	TimeSeriesStore store { 2, 30 };
+	Date date { 1836, 1, 1 };
+	push_samples(store, date, 40);
+
+	const auto [begin, end] = store.find_sample_range(Date { 1836, 1, 15 }, Date { 1836, 1, 20 });
+	CHECK(begin == 14);
+	CHECK(end == 20);
+
+	const auto [clamped_begin, clamped_end] = store.find_sample_range(Date { 1800, 1, 1 }, Date { 1900, 1, 1 });
+	CHECK(clamped_begin == 10);
+	CHECK(clamped_end == 40);
+}
+
+TEST_CASE("TimeSeriesStore downsamples into buckets", "[TimeSeriesStore]") {
+	TimeSeriesStore store { 2, 100 };
+	Date date { 1836, 1, 1 };
+	push_samples(store, date, 10);
+
+	std::array<fixed_point_t, 4> buckets {};
+	REQUIRE(store.downsample(0, 0, 10, 4, TimeSeriesStore::aggregate_t::MEAN, buckets) == 3);
+	CHECK(buckets[0] == fixed_point_t(3) / 8);
+	CHECK(buckets[2] == fixed_point_t(17) / 8);
+
+	REQUIRE(store.downsample(1, 0, 10, 4, TimeSeriesStore::aggregate_t::MAX, buckets) == 3);
+	CHECK(buckets[0] == series_value(1, 3));
+	REQUIRE(store.downsample(1, 0, 10, 4, TimeSeriesStore::aggregate_t::MIN, buckets) == 3);
+	CHECK(buckets[1] == series_value(1, 4));
+	REQUIRE(store.downsample(0, 0, 10, 4, TimeSeriesStore::aggregate_t::LAST, buckets) == 3);
+	CHECK(buckets[2] == series_value(0, 9));
+
+	std::array<fixed_point_t, 1> one_bucket {};
+	CHECK(store.downsample(0, 2, 10, 4, TimeSeriesStore::aggregate_t::LAST, one_bucket) == 1);
+	CHECK(one_bucket[0] == series_value(0, 5));
+}
@@ -14,6 +14,7 @@ static_assert(sizeof(building_type_index_t) == 4);
 static_assert(sizeof(province_building_index_t) == 4);
 static_assert(sizeof(country_index_t) == 4);
 static_assert(sizeof(crime_index_t) == 4);
+static_assert(sizeof(culture_index_t) == 4);
 static_assert(sizeof(good_index_t) == 4);
 static_assert(sizeof(good_category_index_t) == 4);
 static_assert(sizeof(government_type_index_t) == 4);
@@ -27,6 +28,7 @@ static_assert(sizeof(pop_type_index_t) == 4);
 static_assert(sizeof(rebel_type_index_t) == 4);
 static_assert(sizeof(reform_index_t) == 4);
 static_assert(sizeof(reform_group_index_t) == 4);
+static_assert(sizeof(religion_index_t) == 4);
 static_assert(sizeof(regiment_type_index_t) == 4);
 static_assert(sizeof(ship_type_index_t) == 4);
 static_assert(sizeof(strata_index_t) == 4);
@@ -0,0 +1,77 @@
+#include "openvic-simulation/utility/TickPipeline.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/ecs/EcsThreadPool.hpp"
+
+#include <snitch/snitch_macros_check.hpp>
+#include <snitch/snitch_macros_test_case.hpp>
+
+using namespace OpenVic;
+
+TEST_CASE("TickPipeline stages the InstanceManager tick tasks by their declared conflicts", "[TickPipeline]") {
+	TickPipeline pipeline;
+	for (InstanceManager::tick_task_t const& tick_task : InstanceManager::get_tick_tasks()) {
+		pipeline.add_task(tick_task.name, tick_task.reads, tick_task.writes, []() {});
+	}
+
+	CHECK(InstanceManager::get_tick_tasks().size() == 9);
+	CHECK(pipeline.get_stage_count() == 6);
+	CHECK(pipeline.get_stage_index_of("country_tick_before_map") == 0);
+	CHECK(pipeline.get_stage_index_of("map_tick") == 1);
+	CHECK(pipeline.get_stage_index_of("execute_orders") == 2);
+	CHECK(pipeline.get_stage_index_of("pop_movement") == 3);
+	CHECK(pipeline.get_stage_index_of("record_price_history") == 3);
+	CHECK(pipeline.get_stage_index_of("country_tick_after_map") == 4);
+	CHECK(pipeline.get_stage_index_of("unit_tick") == 4);
+	CHECK(pipeline.get_stage_index_of("record_economy_history") == 5);
+	CHECK(pipeline.get_stage_index_of("rebalance_province_bundles") == 5);
+	CHECK(pipeline.get_stage_index_of("missing") == SIZE_MAX);
+}
+
+TEST_CASE("TickPipeline parallel result matches serial result", "[TickPipeline]") {
+	using enum tick_resource_t;
+
+	const auto run_pipeline = [](const bool serial, const uint32_t worker_count) -> std::vector<int> {
+		std::vector<int> countries(4, 1), provinces(4, 2), units(4, 3);
+		ecs::EcsThreadPool executor { worker_count };
+		TickPipeline pipeline;
+		pipeline.set_serial_mode(serial);
+		pipeline.add_task("countries", NONE, COUNTRIES, [&countries]() {
+			for (int& country : countries) {
+				country *= 3;
+			}
+		});
+		pipeline.add_task("provinces", COUNTRIES, PROVINCES, [&countries, &provinces]() {
+			for (std::size_t i = 0; i < provinces.size(); ++i) {
+				provinces[i] += countries[i];
+			}
+		});
+		pipeline.add_task("units", NONE, UNITS, [&units]() {
+			for (int& unit : units) {
+				unit -= 1;
+			}
+		});
+		pipeline.add_task("countries_again", PROVINCES, COUNTRIES, [&countries, &provinces]() {
+			for (std::size_t i = 0; i < countries.size(); ++i) {
+				countries[i] += provinces[i];
+			}
+		});
+		for (int tick = 0; tick < 8; ++tick) {
+			pipeline.run(executor);
+		}
+
+		std::vector<int> result;
+		result.insert(result.end(), countries.begin(), countries.end());
+		result.insert(result.end(), provinces.begin(), provinces.end());
+		result.insert(result.end(), units.begin(), units.end());
+		return result;
+	};
+
+	const std::vector<int> baseline = run_pipeline(true, 1);
+	for (uint32_t worker_count : { 1u, 2u, 4u, 8u }) {
+		CHECK(run_pipeline(false, worker_count) == baseline);
+	}
+}